@@ -0,0 +1,200 @@
+// Batch math kernels on 10k-element batches against the same work done one
+// element at a time through raymath. Every kernel's output is compared with
+// raymath's; a mismatch is a relative error above BENCH_TOLERANCE and fails
+// the run. The check also runs on a short, misaligned batch so the scalar
+// tails are covered.
+// Built twice: with the vector path for this host and with BATCH_MATH_SIMD=0.
+#include "bench_common.h"
+#include "batch_math.h"
+#include <math.h>
+#include <raymath.h>
+
+volatile float g_benchSink;
+static int g_mismatches;
+
+#define BATCH_COUNT 10000
+#define BATCH_ROUNDS 200
+#define BENCH_TOLERANCE 1e-6f
+
+static float g_x[BATCH_COUNT] __attribute__((aligned(16)));
+static float g_y[BATCH_COUNT] __attribute__((aligned(16)));
+static float g_z[BATCH_COUNT] __attribute__((aligned(16)));
+static float g_vx[BATCH_COUNT] __attribute__((aligned(16)));
+static float g_vy[BATCH_COUNT] __attribute__((aligned(16)));
+static float g_vz[BATCH_COUNT] __attribute__((aligned(16)));
+static Vector3 g_points[BATCH_COUNT];
+static Vector3 g_velocities[BATCH_COUNT];
+static Matrix g_locals[BATCH_COUNT];
+static Matrix g_parents[BATCH_COUNT];
+static Matrix g_results[BATCH_COUNT];
+
+static BenchRng g_rng = {12345u};
+
+static float Bench_Random(void) {
+    return Bench_RandRange(&g_rng, 20.0f) - 10.0f;
+}
+
+static Matrix Bench_RandomMatrix(void) {
+    Matrix m;
+    float* f = (float*)&m;
+    for (int i = 0; i < 16; i++) f[i] = Bench_Random();
+    return m;
+}
+
+static void Bench_Fill(void) {
+    for (int i = 0; i < BATCH_COUNT; i++) {
+        g_points[i] = (Vector3){Bench_Random(), Bench_Random(), Bench_Random()};
+        g_velocities[i] = (Vector3){Bench_Random(), Bench_Random(), Bench_Random()};
+        g_locals[i] = Bench_RandomMatrix();
+        g_parents[i] = Bench_RandomMatrix();
+    }
+    // A few zero vectors for the normalize special case
+    for (int i = 0; i < BATCH_COUNT; i += 997) g_points[i] = (Vector3){0.0f, 0.0f, 0.0f};
+}
+
+static Vector3Array Bench_Load(void) {
+    for (int i = 0; i < BATCH_COUNT; i++) {
+        g_x[i] = g_points[i].x;
+        g_y[i] = g_points[i].y;
+        g_z[i] = g_points[i].z;
+        g_vx[i] = g_velocities[i].x;
+        g_vy[i] = g_velocities[i].y;
+        g_vz[i] = g_velocities[i].z;
+    }
+    return (Vector3Array){g_x, g_y, g_z};
+}
+
+static float Bench_Error(float value, float expected) {
+    float scale = fabsf(expected) > 1.0f ? fabsf(expected) : 1.0f;
+    return fabsf(value - expected) / scale;
+}
+
+typedef struct {
+    float worst;
+    int mismatches;
+} BenchCheck;
+
+static void Bench_Compare(BenchCheck* check, float value, float expected) {
+    float error = Bench_Error(value, expected);
+    if (error > check->worst) check->worst = error;
+    if (error > BENCH_TOLERANCE) check->mismatches++;
+}
+
+static void Bench_PrintCheck(const char* op, const BenchCheck* check) {
+    printf("%-10s %-10s max error %g, %d mismatches\n", BatchMath_GetPathName(), op, (double)check->worst,
+           check->mismatches);
+    g_mismatches += check->mismatches;
+}
+
+// Kernel outputs over [first, first + count) against raymath
+static void Bench_Check(int first, int count) {
+    Vector3Array v = {g_x + first, g_y + first, g_z + first};
+    Vector3Array velocity = {g_vx + first, g_vy + first, g_vz + first};
+    const Matrix* m = &g_parents[0];
+    BenchCheck check;
+
+    Bench_Load();
+    check = (BenchCheck){0};
+    BatchMath_AddScaled(v, v, velocity, 0.016f, count);
+    for (int i = 0; i < count; i++) {
+        Vector3 expected = Vector3Add(g_points[first + i], Vector3Scale(g_velocities[first + i], 0.016f));
+        Bench_Compare(&check, v.x[i], expected.x);
+        Bench_Compare(&check, v.y[i], expected.y);
+        Bench_Compare(&check, v.z[i], expected.z);
+    }
+    Bench_PrintCheck("add", &check);
+
+    Bench_Load();
+    check = (BenchCheck){0};
+    BatchMath_Transform(v, v, m, count);
+    for (int i = 0; i < count; i++) {
+        Vector3 expected = Vector3Transform(g_points[first + i], *m);
+        Bench_Compare(&check, v.x[i], expected.x);
+        Bench_Compare(&check, v.y[i], expected.y);
+        Bench_Compare(&check, v.z[i], expected.z);
+    }
+    Bench_PrintCheck("transform", &check);
+
+    Bench_Load();
+    check = (BenchCheck){0};
+    BatchMath_Normalize(v, count);
+    for (int i = 0; i < count; i++) {
+        Vector3 expected = Vector3Normalize(g_points[first + i]);
+        Bench_Compare(&check, v.x[i], expected.x);
+        Bench_Compare(&check, v.y[i], expected.y);
+        Bench_Compare(&check, v.z[i], expected.z);
+    }
+    Bench_PrintCheck("normalize", &check);
+
+    check = (BenchCheck){0};
+    BatchMath_MultiplyMatrices(g_results + first, g_locals + first, g_parents + first, count);
+    for (int i = 0; i < count; i++) {
+        Matrix expected = MatrixMultiply(g_locals[first + i], g_parents[first + i]);
+        const float* value = (const float*)&g_results[first + i];
+        const float* want = (const float*)&expected;
+        for (int j = 0; j < 16; j++) Bench_Compare(&check, value[j], want[j]);
+    }
+    Bench_PrintCheck("multiply", &check);
+}
+
+static void Bench_Timings(void) {
+    Vector3Array v = Bench_Load();
+    Vector3Array velocity = {g_vx, g_vy, g_vz};
+    const Matrix m = g_parents[0];
+    double start;
+    float sink = 0.0f;
+
+    start = Bench_NowNs();
+    for (int round = 0; round < BATCH_ROUNDS; round++) {
+        for (int i = 0; i < BATCH_COUNT; i++) g_points[i] = Vector3Add(g_points[i], Vector3Scale(g_velocities[i], 0.001f));
+    }
+    Bench_Report("raymath", "add", BATCH_COUNT, Bench_NowNs() - start, BATCH_ROUNDS);
+    start = Bench_NowNs();
+    for (int round = 0; round < BATCH_ROUNDS; round++) BatchMath_AddScaled(v, v, velocity, 0.001f, BATCH_COUNT);
+    Bench_Report(BatchMath_GetPathName(), "add", BATCH_COUNT, Bench_NowNs() - start, BATCH_ROUNDS);
+
+    start = Bench_NowNs();
+    for (int round = 0; round < BATCH_ROUNDS; round++) {
+        for (int i = 0; i < BATCH_COUNT; i++) g_velocities[i] = Vector3Transform(g_points[i], m);
+        sink += g_velocities[round].x;
+    }
+    Bench_Report("raymath", "transform", BATCH_COUNT, Bench_NowNs() - start, BATCH_ROUNDS);
+    start = Bench_NowNs();
+    for (int round = 0; round < BATCH_ROUNDS; round++) {
+        BatchMath_Transform(velocity, v, &m, BATCH_COUNT);
+        sink += velocity.x[round];
+    }
+    Bench_Report(BatchMath_GetPathName(), "transform", BATCH_COUNT, Bench_NowNs() - start, BATCH_ROUNDS);
+
+    start = Bench_NowNs();
+    for (int round = 0; round < BATCH_ROUNDS; round++) {
+        for (int i = 0; i < BATCH_COUNT; i++) g_points[i] = Vector3Normalize(g_points[i]);
+    }
+    Bench_Report("raymath", "normalize", BATCH_COUNT, Bench_NowNs() - start, BATCH_ROUNDS);
+    start = Bench_NowNs();
+    for (int round = 0; round < BATCH_ROUNDS; round++) BatchMath_Normalize(v, BATCH_COUNT);
+    Bench_Report(BatchMath_GetPathName(), "normalize", BATCH_COUNT, Bench_NowNs() - start, BATCH_ROUNDS);
+
+    start = Bench_NowNs();
+    for (int round = 0; round < BATCH_ROUNDS; round++) {
+        for (int i = 0; i < BATCH_COUNT; i++) g_results[i] = MatrixMultiply(g_locals[i], g_parents[i]);
+        sink += g_results[round].m12;
+    }
+    Bench_Report("raymath", "multiply", BATCH_COUNT, Bench_NowNs() - start, BATCH_ROUNDS);
+    start = Bench_NowNs();
+    for (int round = 0; round < BATCH_ROUNDS; round++) {
+        BatchMath_MultiplyMatrices(g_results, g_locals, g_parents, BATCH_COUNT);
+        sink += g_results[round].m12;
+    }
+    Bench_Report(BatchMath_GetPathName(), "multiply", BATCH_COUNT, Bench_NowNs() - start, BATCH_ROUNDS);
+
+    g_benchSink = sink + g_points[1].x + g_x[1];
+}
+
+int main(void) {
+    Bench_Fill();
+    Bench_Check(0, BATCH_COUNT);
+    Bench_Check(1, 1001);
+    Bench_Timings();
+    return g_mismatches != 0;
+}
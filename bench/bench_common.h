@@ -0,0 +1,37 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <stdio.h>
+#include <time.h>
+
+// Monotonic wall clock in nanoseconds
+static inline double Bench_NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static inline void Bench_Report(const char* layout, const char* op, int entities, double totalNs, int ops) {
+    printf("%-10s %-10s %8d %12.2f ns/op\n", layout, op, entities, ops > 0 ? totalNs / ops : 0.0);
+}
+
+// Seeded LCG, so every run of a bench generates the same data
+typedef struct {
+    unsigned int state;
+} BenchRng;
+
+// Next 24 random bits
+static inline unsigned int Bench_Rand(BenchRng* rng) {
+    rng->state = rng->state * 1664525u + 1013904223u;
+    return rng->state >> 8;
+}
+
+// Uniform in [0, range)
+static inline float Bench_RandRange(BenchRng* rng, float range) {
+    return ((float)Bench_Rand(rng) / 16777216.0f) * range;
+}
+
+// Keeps the optimizer from discarding benchmark results
+extern volatile float g_benchSink;
+
+#endif // BENCH_COMMON_H
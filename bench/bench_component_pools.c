@@ -0,0 +1,105 @@
+// Compares the packed sparse-set component storage in ecs.c against the
+// original layout, where every component was its own malloc'd block
+// referenced from Entity.components[].
+#include "bench_common.h"
+#include "ecs.h"
+#include "legacy_world.h"
+#include <stdlib.h>
+
+volatile float g_benchSink;
+
+#define ITERATE_ROUNDS 20
+
+static void Bench_Legacy(int count) {
+    LegacyWorld world;
+    Legacy_Init(&world, count);
+    EntityID* ids = (EntityID*)malloc(sizeof(EntityID) * (size_t)count);
+
+    double start = Bench_NowNs();
+    for (int i = 0; i < count; i++) ids[i] = Legacy_CreateEntity(&world);
+    Bench_Report("legacy", "create", count, Bench_NowNs() - start, count);
+
+    start = Bench_NowNs();
+    for (int i = 0; i < count; i++) {
+        TransformComponent* transform = (TransformComponent*)Legacy_AddComponent(&world, ids[i], COMPONENT_TRANSFORM);
+        Legacy_AddComponent(&world, ids[i], COMPONENT_RENDERABLE);
+        transform->position.x = (float)i;
+    }
+    Bench_Report("legacy", "add", count, Bench_NowNs() - start, count * 2);
+
+    start = Bench_NowNs();
+    float sum = 0.0f;
+    for (int i = 0; i < count; i++) {
+        TransformComponent* transform = (TransformComponent*)Legacy_GetComponent(&world, ids[i], COMPONENT_TRANSFORM);
+        RenderableComponent* renderable = (RenderableComponent*)Legacy_GetComponent(&world, ids[i], COMPONENT_RENDERABLE);
+        sum += transform->position.x + renderable->size.y;
+    }
+    g_benchSink = sum;
+    Bench_Report("legacy", "get", count, Bench_NowNs() - start, count * 2);
+
+    start = Bench_NowNs();
+    for (int round = 0; round < ITERATE_ROUNDS; round++) Legacy_Render(&world);
+    Bench_Report("legacy", "iterate", count, Bench_NowNs() - start, count * ITERATE_ROUNDS);
+
+    start = Bench_NowNs();
+    for (int i = 0; i < count; i++) Legacy_DestroyEntity(&world, ids[i]);
+    Bench_Report("legacy", "destroy", count, Bench_NowNs() - start, count);
+
+    free(ids);
+    free(world.entities);
+}
+
+static ECSWorld g_world;
+
+static void Bench_Packed(int count) {
+    ECSWorld* world = &g_world;
+    ECS_InitWithCapacity(world, count);
+    // Register the render query up front so it is maintained incrementally,
+    // as it is in the game loop after the first frame
+    ECS_GetQuery(world, COMPONENT_BIT(COMPONENT_TRANSFORM) | COMPONENT_BIT(COMPONENT_RENDERABLE));
+    EntityID* ids = (EntityID*)malloc(sizeof(EntityID) * (size_t)count);
+
+    double start = Bench_NowNs();
+    for (int i = 0; i < count; i++) ids[i] = ECS_CreateEntity(world);
+    Bench_Report("packed", "create", count, Bench_NowNs() - start, count);
+
+    start = Bench_NowNs();
+    for (int i = 0; i < count; i++) {
+        TransformComponent* transform = (TransformComponent*)ECS_AddComponent(world, ids[i], COMPONENT_TRANSFORM);
+        ECS_AddComponent(world, ids[i], COMPONENT_RENDERABLE);
+        transform->position.x = (float)i;
+    }
+    Bench_Report("packed", "add", count, Bench_NowNs() - start, count * 2);
+
+    start = Bench_NowNs();
+    float sum = 0.0f;
+    for (int i = 0; i < count; i++) {
+        TransformComponent* transform = (TransformComponent*)ECS_GetComponent(world, ids[i], COMPONENT_TRANSFORM);
+        RenderableComponent* renderable = (RenderableComponent*)ECS_GetComponent(world, ids[i], COMPONENT_RENDERABLE);
+        sum += transform->position.x + renderable->size.y;
+    }
+    g_benchSink = sum;
+    Bench_Report("packed", "get", count, Bench_NowNs() - start, count * 2);
+
+    start = Bench_NowNs();
+    for (int round = 0; round < ITERATE_ROUNDS; round++) System_Render(world, NULL, NULL);
+    Bench_Report("packed", "iterate", count, Bench_NowNs() - start, count * ITERATE_ROUNDS);
+
+    start = Bench_NowNs();
+    for (int i = 0; i < count; i++) ECS_DestroyEntity(world, ids[i]);
+    Bench_Report("packed", "destroy", count, Bench_NowNs() - start, count);
+
+    ECS_Cleanup(world);
+    free(ids);
+}
+
+int main(void) {
+    const int counts[] = {256, 65536};
+
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        Bench_Legacy(counts[i]);
+        Bench_Packed(counts[i]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+// Baseline for the ECS core: every public hot-path operation at several
+// entity counts, with ns/op, throughput and the allocations made through
+// the mem layer while the operation ran. Built once per storage mode.
+//   create  - ECS_CreateEntity into an empty world
+//   add     - ECS_AddComponent: a transform on every entity, a renderable on 3 in 4
+//   get     - ECS_GetComponent on a transform, entities visited in random order
+//   iterate - Transform+Renderable query, reading both components
+//   render  - System_Render against the stub draw layer, no frustum
+//   destroy - ECS_DestroyEntity on every entity
+// Pass --csv for one machine-readable row per measurement; `make -C bench
+// baseline` collects both storage modes into build/baseline.csv.
+#include "bench_common.h"
+#include "ecs.h"
+#include "mem.h"
+#include "render_batch.h"
+#include "render_queue.h"
+#include "mesh_cache.h"
+#include <stdlib.h>
+#include <string.h>
+
+volatile float g_benchSink;
+
+#define GET_ROUNDS 10
+#define ITERATE_ROUNDS 50
+#define RENDER_ROUNDS 10
+
+#if ECS_ARCHETYPE_STORAGE
+#define STORAGE_NAME "archetype"
+#else
+#define STORAGE_NAME "sparse"
+#endif
+
+static ECSWorld g_world;
+static bool g_csv;
+static BenchRng g_rng = {2024u};
+
+// Mem layer totals over every subsystem
+typedef struct {
+    unsigned long allocs;
+    unsigned long long bytes;
+} BenchMem;
+
+typedef struct {
+    const char* op;
+    int entities;
+    double startNs;
+    BenchMem startMem;
+} BenchTimer;
+
+static BenchMem Bench_MemSnapshot(void) {
+    BenchMem mem = {0, 0};
+    for (int s = 0; s < MEM_SUBSYSTEM_COUNT; s++) {
+        const MemStats* stats = Mem_GetStats((MemSubsystem)s);
+        mem.allocs += stats->allocCount;
+        mem.bytes += stats->allocBytes;
+    }
+    return mem;
+}
+
+static BenchTimer Bench_Start(const char* op, int entities) {
+    BenchTimer timer = {op, entities, 0.0, Bench_MemSnapshot()};
+    timer.startNs = Bench_NowNs();
+    return timer;
+}
+
+// allocs counts every successful mem layer allocation (heap, pool block and
+// frame scratch) and bytes what they handed out; frees are not subtracted
+static void Bench_Stop(const BenchTimer* timer, long ops) {
+    double ns = Bench_NowNs() - timer->startNs;
+    BenchMem mem = Bench_MemSnapshot();
+    unsigned long allocs = mem.allocs - timer->startMem.allocs;
+    unsigned long long bytes = mem.bytes - timer->startMem.bytes;
+    double nsPerOp = ops > 0 ? ns / (double)ops : 0.0;
+    double opsPerSec = ns > 0.0 ? (double)ops * 1e9 / ns : 0.0;
+
+    if (g_csv) {
+        printf("%s,%s,%d,%ld,%.3f,%.0f,%lu,%llu\n", STORAGE_NAME, timer->op, timer->entities, ops, nsPerOp, opsPerSec,
+               allocs, bytes);
+    } else {
+        printf("%-10s %-8s %8d %10.2f ns/op %9.2f Mops/s %7lu allocs %11llu bytes\n", STORAGE_NAME, timer->op,
+               timer->entities, nsPerOp, opsPerSec / 1e6, allocs, bytes);
+    }
+}
+
+static void Bench_Suite(int count) {
+    ECSWorld* world = &g_world;
+    EntityID* ids = (EntityID*)malloc(sizeof(EntityID) * (size_t)count);
+    ECS_InitWithCapacity(world, count);
+
+    BenchTimer timer = Bench_Start("create", count);
+    for (int i = 0; i < count; i++) ids[i] = ECS_CreateEntity(world);
+    Bench_Stop(&timer, count);
+
+    long adds = 0;
+    timer = Bench_Start("add", count);
+    for (int i = 0; i < count; i++) {
+        TransformComponent* transform = (TransformComponent*)ECS_AddComponent(world, ids[i], COMPONENT_TRANSFORM);
+        transform->position = (Vector3){(float)(i % 256), 0.5f, (float)(i / 256)};
+        adds++;
+        if ((i % 4) != 3) {
+            RenderableComponent* renderable =
+                (RenderableComponent*)ECS_AddComponent(world, ids[i], COMPONENT_RENDERABLE);
+            renderable->color = (Color){(unsigned char)(i % 200), 100, 150, 255};
+            adds++;
+        }
+    }
+    Bench_Stop(&timer, adds);
+
+    // Lookup order is drawn up front so the RNG stays out of the timing
+    int* order = (int*)malloc(sizeof(int) * (size_t)count);
+    for (int i = 0; i < count; i++) order[i] = (int)(Bench_Rand(&g_rng) % (unsigned int)count);
+    float sum = 0.0f;
+    timer = Bench_Start("get", count);
+    for (int round = 0; round < GET_ROUNDS; round++) {
+        for (int i = 0; i < count; i++) {
+            TransformComponent* transform =
+                (TransformComponent*)ECS_GetComponent(world, ids[order[i]], COMPONENT_TRANSFORM);
+            sum += transform->position.x;
+        }
+    }
+    Bench_Stop(&timer, (long)count * GET_ROUNDS);
+    free(order);
+
+    ECSQuery* query = ECS_GetQuery(world, COMPONENT_BIT(COMPONENT_TRANSFORM) | COMPONENT_BIT(COMPONENT_RENDERABLE));
+    long visited = 0;
+    timer = Bench_Start("iterate", count);
+    for (int round = 0; round < ITERATE_ROUNDS; round++) {
+        ECSQueryIter iter = ECS_QueryIter(world, query);
+        while (ECS_QueryNext(&iter)) {
+            TransformComponent* transform = (TransformComponent*)iter.components[COMPONENT_TRANSFORM];
+            RenderableComponent* renderable = (RenderableComponent*)iter.components[COMPONENT_RENDERABLE];
+            sum += transform->position.x * renderable->size.x;
+            visited++;
+        }
+    }
+    Bench_Stop(&timer, visited);
+    g_benchSink = sum;
+
+    // The first frame builds the world matrices and warms the render caches
+    Mem_BeginFrame();
+    System_Render(world, NULL, NULL);
+    timer = Bench_Start("render", count);
+    for (int round = 0; round < RENDER_ROUNDS; round++) {
+        Mem_BeginFrame();
+        System_Render(world, NULL, NULL);
+    }
+    Bench_Stop(&timer, (long)(visited / ITERATE_ROUNDS) * RENDER_ROUNDS);
+
+    timer = Bench_Start("destroy", count);
+    for (int i = 0; i < count; i++) ECS_DestroyEntity(world, ids[i]);
+    Bench_Stop(&timer, count);
+
+    ECS_Cleanup(world);
+    free(ids);
+}
+
+int main(int argc, char** argv) {
+    const int counts[] = {1024, 16384, 65536};
+
+    bool header = true;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            g_csv = true;
+        } else if (strcmp(argv[i], "--no-header") == 0) {
+            header = false;
+        } else {
+            fprintf(stderr, "usage: %s [--csv] [--no-header]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (g_csv && header) {
+        printf("storage,op,entities,ops,ns_per_op,ops_per_sec,allocs,alloc_bytes\n");
+    }
+
+    Mem_Init();
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        Bench_Suite(counts[i]);
+    }
+
+    MeshCache_Shutdown();
+    RenderQueue_Shutdown();
+    RenderBatch_Shutdown();
+    Mem_Shutdown();
+    return 0;
+}
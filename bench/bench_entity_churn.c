@@ -0,0 +1,65 @@
+// Spawn/despawn churn against the free-list entity allocator. Per-op cost
+// should stay flat as the live population grows. A stale ID that still
+// resolves after its slot is reused fails the run.
+#include "bench_common.h"
+#include "ecs.h"
+#include <stdlib.h>
+
+volatile float g_benchSink;
+
+static ECSWorld g_world;
+static int g_staleHits;
+
+static BenchRng g_rng = {12345u};
+
+static void Bench_Churn(int population, int churnOps) {
+    ECSWorld* world = &g_world;
+    ECS_InitWithCapacity(world, population);
+    EntityID* ids = (EntityID*)malloc(sizeof(EntityID) * (size_t)population);
+
+    double start = Bench_NowNs();
+    for (int i = 0; i < population; i++) {
+        ids[i] = ECS_CreateEntity(world);
+        ECS_AddComponent(world, ids[i], COMPONENT_TRANSFORM);
+    }
+    Bench_Report("freelist", "spawn", population, Bench_NowNs() - start, population);
+
+    int staleHits = 0;
+    start = Bench_NowNs();
+    for (int i = 0; i < churnOps; i++) {
+        int victim = (int)(Bench_Rand(&g_rng) % (unsigned int)population);
+        EntityID old = ids[victim];
+        ECS_DestroyEntity(world, old);
+        ids[victim] = ECS_CreateEntity(world);
+        ECS_AddComponent(world, ids[victim], COMPONENT_TRANSFORM);
+
+        // The recycled slot must not answer to the old ID
+        if (ECS_GetComponent(world, old, COMPONENT_TRANSFORM) != NULL) {
+            staleHits++;
+        }
+    }
+    Bench_Report("freelist", "churn", population, Bench_NowNs() - start, churnOps);
+
+    if (staleHits > 0) {
+        printf("ERROR: %d stale IDs resolved after reuse\n", staleHits);
+        g_staleHits += staleHits;
+    }
+
+    start = Bench_NowNs();
+    for (int i = 0; i < population; i++) ECS_DestroyEntity(world, ids[i]);
+    Bench_Report("freelist", "despawn", population, Bench_NowNs() - start, population);
+
+    ECS_Cleanup(world);
+    free(ids);
+}
+
+int main(void) {
+    const int populations[] = {256, 4096, 65536, 100000};
+    const int churnOps = 1000000;
+
+    for (size_t i = 0; i < sizeof(populations) / sizeof(populations[0]); i++) {
+        Bench_Churn(populations[i], churnOps);
+    }
+
+    return g_staleHits != 0;
+}
@@ -0,0 +1,140 @@
+// Transform propagation through 10k-node hierarchies of three shapes:
+//   deep  - one chain, every node the child of the previous one
+//   wide  - one root with 9999 children
+//   tree  - every node has four children
+// Times linking the hierarchy, the sweep after the root moves (every node
+// rebuilt), after one leaf moves, and with nothing changed, plus the cost
+// of reparenting a node back and forth. Sampled world matrices are checked
+// against walking each node's ancestors; an error above HIERARCHY_TOLERANCE
+// per ancestor level fails the run.
+#include "bench_common.h"
+#include "ecs.h"
+#include "hierarchy.h"
+#include <math.h>
+
+volatile float g_benchSink;
+
+#define NODE_COUNT 10000
+#define UPDATE_ROUNDS 50
+#define REPARENT_ROUNDS 200
+#define CHECK_SAMPLES 64
+// Rounding builds up along a chain: the 10k-deep one reaches about 2e-3 at
+// depth 4k, against 5e-7 for the four-way tree
+#define HIERARCHY_TOLERANCE 1e-5f
+
+typedef enum {
+    SHAPE_DEEP,
+    SHAPE_WIDE,
+    SHAPE_TREE
+} BenchShape;
+
+static ECSWorld g_world;
+static EntityID g_ids[NODE_COUNT];
+static int g_failures;
+
+static int Bench_ParentIndex(BenchShape shape, int i) {
+    switch (shape) {
+        case SHAPE_DEEP: return i - 1;
+        case SHAPE_WIDE: return 0;
+        default: return (i - 1) / 4;
+    }
+}
+
+static double Bench_Build(ECSWorld* world, BenchShape shape) {
+    ECS_InitWithCapacity(world, NODE_COUNT);
+    for (int i = 0; i < NODE_COUNT; i++) {
+        g_ids[i] = ECS_CreateEntity(world);
+        TransformComponent* transform = (TransformComponent*)ECS_AddComponent(world, g_ids[i], COMPONENT_TRANSFORM);
+        transform->position = (Vector3){0.5f, 0.01f, 0.0f};
+        transform->rotation = (Vector3){0.0f, 0.001f * (float)(i % 7), 0.0f};
+    }
+
+    double start = Bench_NowNs();
+    for (int i = 1; i < NODE_COUNT; i++) {
+        Hierarchy_SetParent(world, g_ids[i], g_ids[Bench_ParentIndex(shape, i)]);
+    }
+    double elapsed = Bench_NowNs() - start;
+    System_UpdateTransforms(world);
+    return elapsed;
+}
+
+static void Bench_Touch(ECSWorld* world, EntityID id) {
+    TransformComponent* transform = (TransformComponent*)ECS_GetComponent(world, id, COMPONENT_TRANSFORM);
+    transform->position.y += 0.001f;
+    ECS_MarkTransformDirty(world, id);
+}
+
+static double Bench_Sweep(ECSWorld* world, EntityID touched) {
+    double total = 0.0;
+    for (int round = 0; round < UPDATE_ROUNDS; round++) {
+        if (touched != ECS_INVALID_ENTITY) {
+            Bench_Touch(world, touched);
+        }
+        double start = Bench_NowNs();
+        System_UpdateTransforms(world);
+        total += Bench_NowNs() - start;
+    }
+    return total;
+}
+
+// Largest translation error of sampled nodes against the product of their
+// ancestors' local matrices. Samples off by more than HIERARCHY_TOLERANCE
+// per level are counted in *failures.
+static float Bench_Check(ECSWorld* world, int* failures) {
+    float worst = 0.0f;
+    for (int sample = 0; sample < CHECK_SAMPLES; sample++) {
+        EntityID id = g_ids[(sample * 7919) % NODE_COUNT];
+        Vector3 point = {0.0f, 0.0f, 0.0f};
+        int depth = 0;
+        for (EntityID node = id; node != ECS_INVALID_ENTITY; node = Hierarchy_GetParent(world, node)) {
+            depth++;
+            Matrix m = ECS_ComputeLocalMatrix((const TransformComponent*)ECS_GetComponent(world, node, COMPONENT_TRANSFORM));
+            point = (Vector3){m.m0 * point.x + m.m4 * point.y + m.m8 * point.z + m.m12,
+                              m.m1 * point.x + m.m5 * point.y + m.m9 * point.z + m.m13,
+                              m.m2 * point.x + m.m6 * point.y + m.m10 * point.z + m.m14};
+        }
+        const TransformComponent* transform = (const TransformComponent*)ECS_GetComponent(world, id, COMPONENT_TRANSFORM);
+        float error = fabsf(transform->world.m12 - point.x) + fabsf(transform->world.m13 - point.y) +
+                      fabsf(transform->world.m14 - point.z);
+        if (error > worst) worst = error;
+        if (!(error <= HIERARCHY_TOLERANCE * (float)depth)) (*failures)++;
+    }
+    return worst;
+}
+
+static void Bench_Shape(BenchShape shape, const char* label) {
+    ECSWorld* world = &g_world;
+    Bench_Report(label, "link", NODE_COUNT, Bench_Build(world, shape), NODE_COUNT);
+
+    Bench_Report(label, "idle", NODE_COUNT, Bench_Sweep(world, ECS_INVALID_ENTITY), UPDATE_ROUNDS);
+    Bench_Report(label, "root", NODE_COUNT, Bench_Sweep(world, g_ids[0]), UPDATE_ROUNDS);
+    Bench_Report(label, "leaf", NODE_COUNT, Bench_Sweep(world, g_ids[NODE_COUNT - 1]), UPDATE_ROUNDS);
+
+    // Move a node between two parents at different depths; for the chain
+    // that carries the 5k nodes below the middle along
+    EntityID moved = g_ids[shape == SHAPE_DEEP ? NODE_COUNT / 2 : NODE_COUNT - 1];
+    EntityID first = Hierarchy_GetParent(world, moved);
+    EntityID second = g_ids[shape == SHAPE_WIDE ? 1 : 0];
+    double start = Bench_NowNs();
+    for (int round = 0; round < REPARENT_ROUNDS; round++) {
+        Hierarchy_SetParent(world, moved, (round & 1) ? first : second);
+    }
+    Bench_Report(label, "reparent", NODE_COUNT, Bench_NowNs() - start, REPARENT_ROUNDS);
+
+    Hierarchy_SetParent(world, moved, second);
+    System_UpdateTransforms(world);
+    int failures = 0;
+    float error = Bench_Check(world, &failures);
+    printf("%-10s %d samples, max error %g, %d above tolerance\n", label, CHECK_SAMPLES, (double)error, failures);
+    g_failures += failures;
+
+    g_benchSink = error;
+    ECS_Cleanup(world);
+}
+
+int main(void) {
+    Bench_Shape(SHAPE_DEEP, "deep");
+    Bench_Shape(SHAPE_WIDE, "wide");
+    Bench_Shape(SHAPE_TREE, "tree");
+    return g_failures != 0;
+}
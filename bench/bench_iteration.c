@@ -0,0 +1,108 @@
+// System_Render-style iteration over Transform+Renderable in a mixed world
+// (not every entity renders, some carry extra components). Built once per
+// storage mode; the original Entity array layout is measured alongside as
+// the baseline.
+#include "bench_common.h"
+#include "ecs.h"
+#include "legacy_world.h"
+#include <stdlib.h>
+
+volatile float g_benchSink;
+
+#define ITERATE_ROUNDS 50
+
+#if ECS_ARCHETYPE_STORAGE
+#define STORAGE_NAME "archetype"
+#else
+#define STORAGE_NAME "sparse"
+#endif
+
+static ECSWorld g_world;
+
+// Component mix: every entity has a transform, 3 in 4 render, 1 in 3 take input
+static bool Bench_HasRenderable(int i) { return (i % 4) != 3; }
+static bool Bench_HasInput(int i) { return (i % 3) == 0; }
+
+static void Bench_LegacyIteration(int count) {
+    LegacyWorld world;
+    Legacy_Init(&world, count);
+
+    double start = Bench_NowNs();
+    for (int i = 0; i < count; i++) {
+        EntityID id = Legacy_CreateEntity(&world);
+        TransformComponent* transform = (TransformComponent*)Legacy_AddComponent(&world, id, COMPONENT_TRANSFORM);
+        transform->position.x = (float)i;
+        if (Bench_HasInput(i)) Legacy_AddComponent(&world, id, COMPONENT_INPUT);
+        if (Bench_HasRenderable(i)) Legacy_AddComponent(&world, id, COMPONENT_RENDERABLE);
+    }
+    Bench_Report("legacy", "build", count, Bench_NowNs() - start, count);
+
+    start = Bench_NowNs();
+    float sum = 0.0f;
+    for (int round = 0; round < ITERATE_ROUNDS; round++) {
+        for (int i = 0; i < world.capacity; i++) {
+            if (!world.entities[i].active) continue;
+            if (Legacy_HasComponent(&world, i, COMPONENT_TRANSFORM) &&
+                Legacy_HasComponent(&world, i, COMPONENT_RENDERABLE)) {
+                TransformComponent* transform = (TransformComponent*)Legacy_GetComponent(&world, i, COMPONENT_TRANSFORM);
+                RenderableComponent* renderable = (RenderableComponent*)Legacy_GetComponent(&world, i, COMPONENT_RENDERABLE);
+                sum += transform->position.x * renderable->size.x;
+            }
+        }
+    }
+    g_benchSink = sum;
+    Bench_Report("legacy", "iterate", count, Bench_NowNs() - start, count * ITERATE_ROUNDS);
+
+    start = Bench_NowNs();
+    for (int round = 0; round < ITERATE_ROUNDS; round++) Legacy_Render(&world);
+    Bench_Report("legacy", "render", count, Bench_NowNs() - start, count * ITERATE_ROUNDS);
+
+    for (int i = 0; i < count; i++) Legacy_DestroyEntity(&world, i);
+    free(world.entities);
+}
+
+static void Bench_WorldIteration(int count) {
+    ECSWorld* world = &g_world;
+    ECS_InitWithCapacity(world, count);
+    ECSQuery* query = ECS_GetQuery(world, COMPONENT_BIT(COMPONENT_TRANSFORM) | COMPONENT_BIT(COMPONENT_RENDERABLE));
+
+    double start = Bench_NowNs();
+    for (int i = 0; i < count; i++) {
+        EntityID id = ECS_CreateEntity(world);
+        TransformComponent* transform = (TransformComponent*)ECS_AddComponent(world, id, COMPONENT_TRANSFORM);
+        transform->position.x = (float)i;
+        if (Bench_HasInput(i)) ECS_AddComponent(world, id, COMPONENT_INPUT);
+        if (Bench_HasRenderable(i)) ECS_AddComponent(world, id, COMPONENT_RENDERABLE);
+    }
+    Bench_Report(STORAGE_NAME, "build", count, Bench_NowNs() - start, count);
+
+    start = Bench_NowNs();
+    float sum = 0.0f;
+    for (int round = 0; round < ITERATE_ROUNDS; round++) {
+        ECSQueryIter iter = ECS_QueryIter(world, query);
+        while (ECS_QueryNext(&iter)) {
+            TransformComponent* transform = (TransformComponent*)iter.components[COMPONENT_TRANSFORM];
+            RenderableComponent* renderable = (RenderableComponent*)iter.components[COMPONENT_RENDERABLE];
+            sum += transform->position.x * renderable->size.x;
+        }
+    }
+    g_benchSink = sum;
+    Bench_Report(STORAGE_NAME, "iterate", count, Bench_NowNs() - start, count * ITERATE_ROUNDS);
+
+    start = Bench_NowNs();
+    for (int round = 0; round < ITERATE_ROUNDS; round++) System_Render(world, NULL, NULL);
+    Bench_Report(STORAGE_NAME, "render", count, Bench_NowNs() - start, count * ITERATE_ROUNDS);
+
+    ECS_Cleanup(world);
+}
+
+int main(void) {
+    const int counts[] = {256, 4096, 65536};
+
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        Bench_LegacyIteration(counts[i]);
+        Bench_WorldIteration(counts[i]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+// LZ compression of save payloads: compact and legacy encodings of stress
+// scenes from a handful of entities up to 16k. Reports the packed ratio and
+// compress/decompress throughput over the raw size. Every payload must
+// decompress back to the same bytes.
+#include "bench_common.h"
+#include "ecs.h"
+#include "lz.h"
+#include "mem.h"
+#include "scene_format.h"
+#include "stress_scene.h"
+#include <stdlib.h>
+#include <string.h>
+
+volatile float g_benchSink;
+
+#define LZ_ROUNDS 20
+
+static ECSWorld g_world;
+
+static bool Bench_Payload(const char* label, int entities, const unsigned char* raw, size_t rawSize) {
+    size_t capacity = Lz_MaxCompressedSize(rawSize);
+    unsigned char* packed = (unsigned char*)malloc(capacity);
+    unsigned char* unpacked = (unsigned char*)malloc(rawSize);
+    size_t packedSize = 0;
+    size_t unpackedSize = 0;
+
+    double start = Bench_NowNs();
+    for (int round = 0; round < LZ_ROUNDS; round++) {
+        Mem_BeginFrame();
+        packedSize = Lz_Compress(raw, rawSize, packed, capacity);
+    }
+    double compressNs = (Bench_NowNs() - start) / LZ_ROUNDS;
+
+    start = Bench_NowNs();
+    for (int round = 0; round < LZ_ROUNDS; round++) unpackedSize = Lz_Decompress(packed, packedSize, unpacked, rawSize);
+    double decompressNs = (Bench_NowNs() - start) / LZ_ROUNDS;
+
+    bool match = packedSize > 0 && unpackedSize == rawSize && memcmp(raw, unpacked, rawSize) == 0;
+    printf("%-8s %8d entities %9zu -> %9zu bytes (%5.1f%%)  compress %7.1f MB/s  decompress %7.1f MB/s%s\n", label,
+           entities, rawSize, packedSize, 100.0 * (double)packedSize / (double)rawSize,
+           (double)rawSize * 1e3 / compressNs, (double)rawSize * 1e3 / decompressNs,
+           match ? "" : "  ROUND TRIP MISMATCH");
+
+    // Flipped bits may still decode, but never outside the buffers
+    // (build with -fsanitize=address to check)
+    if (match && packedSize > 8) {
+        unsigned char* corrupt = (unsigned char*)malloc(packedSize);
+        memcpy(corrupt, packed, packedSize);
+        for (size_t i = 0; i < packedSize; i += 7) corrupt[i] ^= 0x5A;
+        size_t result = Lz_Decompress(corrupt, packedSize, unpacked, rawSize);
+        g_benchSink = (float)result;
+        free(corrupt);
+    }
+
+    free(unpacked);
+    free(packed);
+    return match;
+}
+
+// Both encodings of the same stress scene
+static bool Bench_Scene(int entities) {
+    StressSceneConfig config;
+    StressScene_DefaultConfig(&config);
+    config.entityCount = entities;
+    ECS_InitWithCapacity(&g_world, entities + 1);
+    StressScene_Create(&g_world, &config);
+
+    size_t compactCapacity = SceneFormat_MaxEncodedSize(entities + 1);
+    size_t legacyCapacity = SceneFormat_LegacySize(entities + 1);
+    unsigned char* compact = (unsigned char*)malloc(compactCapacity);
+    unsigned char* legacy = (unsigned char*)malloc(legacyCapacity);
+    size_t compactSize = SceneFormat_Encode(&g_world, compact, compactCapacity);
+    size_t legacySize = SceneFormat_EncodeLegacy(&g_world, legacy, legacyCapacity);
+
+    bool ok = Bench_Payload("compact", entities, compact, compactSize);
+    ok &= Bench_Payload("legacy", entities, legacy, legacySize);
+
+    free(legacy);
+    free(compact);
+    ECS_Cleanup(&g_world);
+    return ok;
+}
+
+// Packed container: header round trip, and a truncated save is refused
+static bool Bench_Container(void) {
+    StressSceneConfig config;
+    StressScene_DefaultConfig(&config);
+    ECS_InitWithCapacity(&g_world, config.entityCount + 1);
+    StressScene_Create(&g_world, &config);
+
+    size_t rawCapacity = SceneFormat_MaxEncodedSize(config.entityCount + 1);
+    unsigned char* raw = (unsigned char*)malloc(rawCapacity);
+    size_t rawSize = SceneFormat_Encode(&g_world, raw, rawCapacity);
+    size_t packedCapacity = SceneFormat_MaxPackedSize(rawSize);
+    unsigned char* packed = (unsigned char*)malloc(packedCapacity);
+    unsigned char* unpacked = (unsigned char*)malloc(rawSize);
+
+    Mem_BeginFrame();
+    size_t packedSize = SceneFormat_Pack(raw, rawSize, packed, packedCapacity);
+    bool ok = packedSize > 0 && SceneFormat_PackedRawSize(packed, packedSize) == rawSize &&
+              SceneFormat_Unpack(packed, packedSize, unpacked, rawSize) == rawSize &&
+              memcmp(raw, unpacked, rawSize) == 0 && !SceneFormat_PackedRawSize(raw, rawSize) &&
+              SceneFormat_Unpack(packed, packedSize - 1, unpacked, rawSize) == 0;
+    printf("container %zu -> %zu bytes, round trip and truncation check %s\n", rawSize, packedSize,
+           ok ? "passed" : "FAILED");
+
+    free(unpacked);
+    free(packed);
+    free(raw);
+    ECS_Cleanup(&g_world);
+    return ok;
+}
+
+int main(void) {
+    const int counts[] = {8, 256, 4096, 16384};
+    int failures = 0;
+
+    Mem_Init();
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        failures += !Bench_Scene(counts[i]);
+    }
+    failures += !Bench_Container();
+    Mem_Shutdown();
+    return failures != 0;
+}
@@ -0,0 +1,185 @@
+// Floor tiles and the grid drawn by regenerating their geometry every frame
+// (what DrawPlane, DrawGrid and a line-by-line plane outline do, including
+// rlgl's CPU matrix transform of each vertex under rlPushMatrix/rlScalef) against
+// replaying cached meshes. Then System_Render with tiles being edited each
+// frame, to show cache hits, rebuilds and evictions.
+#include "bench_common.h"
+#include "ecs.h"
+#include "mesh_cache.h"
+#include "render_batch.h"
+#include "render_queue.h"
+#include <rlgl.h>
+#include <string.h>
+
+volatile float g_benchSink;
+
+#define TILE_COUNT 1000
+#define RENDER_ROUNDS 200
+#define EDIT_ROUNDS 200
+
+static ECSWorld g_world;
+
+static const Color g_tileColors[4] = {
+    {50, 50, 50, 255}, {70, 70, 70, 255}, {90, 60, 60, 255}, {60, 90, 60, 255}
+};
+
+static void Bench_MatrixMultiply(float* out, const float* a, const float* b) {
+    float result[16];
+    for (int col = 0; col < 4; col++) {
+        for (int row = 0; row < 4; row++) {
+            result[col * 4 + row] = a[col * 4 + 0] * b[row] + a[col * 4 + 1] * b[4 + row] +
+                                    a[col * 4 + 2] * b[8 + row] + a[col * 4 + 3] * b[12 + row];
+        }
+    }
+    memcpy(out, result, sizeof(result));
+}
+
+// rlgl applies the current matrix to every vertex on the CPU while a
+// transform is pushed; this is that work
+static void Bench_TransformedVertex(const float* m, float x, float y, float z) {
+    rlVertex3f(m[0] * x + m[4] * y + m[8] * z + m[12],
+               m[1] * x + m[5] * y + m[9] * z + m[13],
+               m[2] * x + m[6] * y + m[10] * z + m[14]);
+}
+
+// DrawPlane: rlPushMatrix, rlTranslatef and rlScalef each fold a 4x4 matrix
+// into the current one before the four vertices are transformed
+static void Bench_DrawPlaneGenerated(Vector3 center, Vector2 size, Color color) {
+    float m[16] = {1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 0,  0, 0, 0, 1};
+    const float translate[16] = {1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 0,  center.x, center.y, center.z, 1};
+    const float scale[16] = {size.x, 0, 0, 0,  0, 1, 0, 0,  0, 0, size.y, 0,  0, 0, 0, 1};
+    Bench_MatrixMultiply(m, translate, m);
+    Bench_MatrixMultiply(m, scale, m);
+    rlBegin(RL_QUADS);
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    Bench_TransformedVertex(m, -0.5f, 0.0f, -0.5f);
+    Bench_TransformedVertex(m, -0.5f, 0.0f, 0.5f);
+    Bench_TransformedVertex(m, 0.5f, 0.0f, 0.5f);
+    Bench_TransformedVertex(m, 0.5f, 0.0f, -0.5f);
+    rlEnd();
+}
+
+static void Bench_DrawPlaneWireGenerated(Vector3 center, Vector2 size, Color color) {
+    float hx = size.x * 0.5f;
+    float hz = size.y * 0.5f;
+    rlBegin(RL_LINES);
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    rlVertex3f(center.x - hx, center.y, center.z - hz);
+    rlVertex3f(center.x + hx, center.y, center.z - hz);
+    rlVertex3f(center.x + hx, center.y, center.z - hz);
+    rlVertex3f(center.x + hx, center.y, center.z + hz);
+    rlVertex3f(center.x + hx, center.y, center.z + hz);
+    rlVertex3f(center.x - hx, center.y, center.z + hz);
+    rlVertex3f(center.x - hx, center.y, center.z + hz);
+    rlVertex3f(center.x - hx, center.y, center.z - hz);
+    rlEnd();
+}
+
+static void Bench_DrawGridGenerated(int slices, float spacing) {
+    int halfSlices = slices / 2;
+    rlCheckRenderBatchLimit((slices + 2) * 4);
+    rlBegin(RL_LINES);
+    for (int i = -halfSlices; i <= halfSlices; i++) {
+        unsigned char shade = (i == 0) ? 128 : 191;
+        for (int v = 0; v < 4; v++) rlColor4ub(shade, shade, shade, 255);
+        rlVertex3f((float)i * spacing, 0.0f, (float)-halfSlices * spacing);
+        rlVertex3f((float)i * spacing, 0.0f, (float)halfSlices * spacing);
+        rlVertex3f((float)-halfSlices * spacing, 0.0f, (float)i * spacing);
+        rlVertex3f((float)halfSlices * spacing, 0.0f, (float)i * spacing);
+    }
+    rlEnd();
+}
+
+static Vector3 Bench_TilePosition(int i) {
+    return (Vector3){(float)(i % 32) * 2.0f - 32.0f, 0.0f, (float)(i / 32) * 2.0f - 32.0f};
+}
+
+// Translation only, as cached in TransformComponent.world
+static Matrix Bench_TileMatrix(int i) {
+    Vector3 p = Bench_TilePosition(i);
+    return (Matrix){1, 0, 0, p.x,  0, 1, 0, p.y,  0, 0, 1, p.z,  0, 0, 0, 1};
+}
+
+static void Bench_Primitives(void) {
+    static Matrix tiles[TILE_COUNT];
+    Vector2 size = {2.0f, 2.0f};
+    Color wire = {80, 80, 80, 255};
+    for (int i = 0; i < TILE_COUNT; i++) tiles[i] = Bench_TileMatrix(i);
+
+    double start = Bench_NowNs();
+    for (int round = 0; round < RENDER_ROUNDS; round++) {
+        Bench_DrawGridGenerated(10, 5.0f);
+        for (int i = 0; i < TILE_COUNT; i++) Bench_DrawPlaneGenerated(Bench_TilePosition(i), size, g_tileColors[i % 4]);
+        for (int i = 0; i < TILE_COUNT; i++) Bench_DrawPlaneWireGenerated(Bench_TilePosition(i), size, wire);
+    }
+    Bench_Report("generated", "draw", TILE_COUNT, Bench_NowNs() - start, RENDER_ROUNDS);
+
+    start = Bench_NowNs();
+    for (int round = 0; round < RENDER_ROUNDS; round++) {
+        MeshCache_BeginFrame();
+        MeshCache_Draw(MeshCache_GetGrid(10, 5.0f), NULL);
+        for (int i = 0; i < TILE_COUNT; i++) MeshCache_Draw(MeshCache_GetPlane(size, g_tileColors[i % 4]), &tiles[i]);
+        const CachedMesh* outline = MeshCache_GetPlaneWire(size, wire);
+        for (int i = 0; i < TILE_COUNT; i++) MeshCache_Draw(outline, &tiles[i]);
+    }
+    Bench_Report("cached", "draw", TILE_COUNT, Bench_NowNs() - start, RENDER_ROUNDS);
+
+    const MeshCacheStats* stats = MeshCache_GetStats();
+    printf("%-10s %d meshes, %d vertices cached, %d builds, %d hits\n", "cached",
+           stats->meshes, stats->vertices, stats->builds, stats->hits);
+}
+
+// Tiles are recolored within the palette every frame (always hits) and one
+// tile per frame is resized, as an animated tile would be (one rebuild, the
+// stale mesh aging out). With `distinct`, resized tiles keep their new size,
+// so keys outnumber slots and the overflow must be drawn directly instead of
+// thrashing the cache.
+static void Bench_Edits(const char* label, bool distinct) {
+    ECSWorld* world = &g_world;
+    ECS_InitWithCapacity(world, TILE_COUNT + 1);
+
+    EntityID grid = ECS_CreateEntity(world);
+    ECS_AddComponent(world, grid, COMPONENT_TRANSFORM);
+    ((RenderableComponent*)ECS_AddComponent(world, grid, COMPONENT_RENDERABLE))->type = RENDERABLE_GRID;
+
+    RenderableComponent* tiles[TILE_COUNT];
+    for (int i = 0; i < TILE_COUNT; i++) {
+        EntityID id = ECS_CreateEntity(world);
+        ((TransformComponent*)ECS_AddComponent(world, id, COMPONENT_TRANSFORM))->position = Bench_TilePosition(i);
+        tiles[i] = (RenderableComponent*)ECS_AddComponent(world, id, COMPONENT_RENDERABLE);
+        tiles[i]->type = RENDERABLE_PLANE;
+        tiles[i]->color = g_tileColors[i % 4];
+        tiles[i]->size = (Vector3){2.0f, 1.0f, 2.0f};
+    }
+
+    MeshCache_Clear();
+    const MeshCacheStats* stats = MeshCache_GetStats();
+    int builds = stats->builds;
+    int hits = stats->hits;
+    int evictions = stats->evictions;
+
+    double start = Bench_NowNs();
+    for (int round = 0; round < EDIT_ROUNDS; round++) {
+        for (int i = round % 10; i < TILE_COUNT; i += 10) tiles[i]->color = g_tileColors[(i + round) % 4];
+        if (!distinct && round > 0) tiles[(round - 1) % TILE_COUNT]->size.x = 2.0f;
+        tiles[round % TILE_COUNT]->size.x = 2.0f + 0.01f * (float)(round + 1);
+        System_Render(world, NULL, NULL);
+    }
+    Bench_Report(label, "render", TILE_COUNT, Bench_NowNs() - start, EDIT_ROUNDS);
+    printf("%-10s %d builds, %d hits, %d evictions per frame (x100)\n", label,
+           (stats->builds - builds) * 100 / EDIT_ROUNDS, (stats->hits - hits) * 100 / EDIT_ROUNDS,
+           (stats->evictions - evictions) * 100 / EDIT_ROUNDS);
+
+    ECS_Cleanup(world);
+}
+
+int main(void) {
+    Bench_Primitives();
+    Bench_Edits("edited", false);
+    Bench_Edits("distinct", true);
+
+    MeshCache_Shutdown();
+    RenderQueue_Shutdown();
+    RenderBatch_Shutdown();
+    return 0;
+}
@@ -0,0 +1,120 @@
+// 5k-cube stress scene: the old per-entity DrawCube + DrawCubeWires path
+// against the batched System_Render, with and without frustum culling from
+// the default scene camera. Draw calls and vertices are read back from the
+// stub render layer, which merges draws the way rlgl does.
+#include "bench_common.h"
+#include "ecs.h"
+#include "render_batch.h"
+#include "render_queue.h"
+#include "mesh_cache.h"
+#include <rlgl.h>
+
+volatile float g_benchSink;
+
+#define STRESS_CUBES 5000
+#define RENDER_ROUNDS 50
+
+static ECSWorld g_world;
+
+static void Bench_BuildStressScene(ECSWorld* world) {
+    ECS_InitWithCapacity(world, STRESS_CUBES + 2);
+
+    EntityID ground = ECS_CreateEntity(world);
+    ECS_AddComponent(world, ground, COMPONENT_TRANSFORM);
+    RenderableComponent* plane = (RenderableComponent*)ECS_AddComponent(world, ground, COMPONENT_RENDERABLE);
+    plane->type = RENDERABLE_PLANE;
+    plane->size = (Vector3){50.0f, 1.0f, 50.0f};
+
+    EntityID grid = ECS_CreateEntity(world);
+    ECS_AddComponent(world, grid, COMPONENT_TRANSFORM);
+    ((RenderableComponent*)ECS_AddComponent(world, grid, COMPONENT_RENDERABLE))->type = RENDERABLE_GRID;
+
+    for (int i = 0; i < STRESS_CUBES; i++) {
+        EntityID id = ECS_CreateEntity(world);
+        TransformComponent* transform = (TransformComponent*)ECS_AddComponent(world, id, COMPONENT_TRANSFORM);
+        RenderableComponent* renderable = (RenderableComponent*)ECS_AddComponent(world, id, COMPONENT_RENDERABLE);
+        transform->position = (Vector3){(float)(i % 71) - 35.0f, 0.5f, (float)(i / 71) - 35.0f};
+        renderable->color = (Color){(unsigned char)(i * 7), (unsigned char)(i * 13), (unsigned char)(i * 29), 255};
+        renderable->size = (Vector3){0.8f, 0.8f, 0.8f};
+    }
+}
+
+// The pre-batching System_Render body
+static void Bench_RenderImmediate(ECSWorld* world) {
+    ECSQueryIter iter = ECS_QueryIter(world, ECS_GetQuery(world, COMPONENT_BIT(COMPONENT_TRANSFORM) | COMPONENT_BIT(COMPONENT_RENDERABLE)));
+    while (ECS_QueryNext(&iter)) {
+        TransformComponent* transform = (TransformComponent*)iter.components[COMPONENT_TRANSFORM];
+        RenderableComponent* renderable = (RenderableComponent*)iter.components[COMPONENT_RENDERABLE];
+        switch (renderable->type) {
+            case RENDERABLE_CUBE:
+                DrawCube(transform->position, renderable->size.x, renderable->size.y, renderable->size.z, renderable->color);
+                DrawCubeWires(transform->position, renderable->size.x, renderable->size.y, renderable->size.z, BLACK);
+                break;
+            case RENDERABLE_GRID:
+                DrawGrid(10, 5.0f);
+                break;
+            case RENDERABLE_PLANE:
+                DrawPlane(transform->position, (Vector2){renderable->size.x, renderable->size.z}, renderable->color);
+                rlBegin(RL_LINES);
+                for (int v = 0; v < 8; v++) rlVertex3f(0.0f, 0.0f, 0.0f);
+                rlEnd();
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void Bench_Counts(const char* path) {
+    printf("%-10s %lu draw calls, %lu vertices per frame\n", path,
+           g_stubDrawCalls / RENDER_ROUNDS, g_stubVertexCalls / RENDER_ROUNDS);
+    g_stubDrawCalls = 0;
+    g_stubVertexCalls = 0;
+}
+
+int main(void) {
+    ECSWorld* world = &g_world;
+    Bench_BuildStressScene(world);
+
+    g_stubDrawCalls = 0;
+    g_stubVertexCalls = 0;
+    double start = Bench_NowNs();
+    for (int round = 0; round < RENDER_ROUNDS; round++) Bench_RenderImmediate(world);
+    Bench_Report("immediate", "render", STRESS_CUBES, Bench_NowNs() - start, STRESS_CUBES * RENDER_ROUNDS);
+    Bench_Counts("immediate");
+
+    RenderBatch_ResetStats();
+    start = Bench_NowNs();
+    for (int round = 0; round < RENDER_ROUNDS; round++) System_Render(world, NULL, NULL);
+    Bench_Report("batched", "render", STRESS_CUBES, Bench_NowNs() - start, STRESS_CUBES * RENDER_ROUNDS);
+    Bench_Counts("batched");
+
+    // The renderer's own counters should agree with what reached the stub
+    const RenderStats* stats = RenderBatch_GetStats();
+    printf("%-10s %d draw calls, %d vertices per frame (RenderBatch stats)\n", "batched",
+           stats->drawCalls / RENDER_ROUNDS, stats->vertices / RENDER_ROUNDS);
+
+    Camera3D camera = {0};
+    camera.position = (Vector3){10.0f, 10.0f, 10.0f};
+    camera.target = (Vector3){0.0f, 0.0f, 0.0f};
+    camera.up = (Vector3){0.0f, 1.0f, 0.0f};
+    camera.fovy = 45.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+
+    RenderBatch_ResetStats();
+    start = Bench_NowNs();
+    for (int round = 0; round < RENDER_ROUNDS; round++) {
+        Frustum frustum = Culling_FrustumFromCamera(&camera, 480.0f / 272.0f, 0.01f, 1000.0f);
+        System_Render(world, &frustum, NULL);
+    }
+    Bench_Report("culled", "render", STRESS_CUBES, Bench_NowNs() - start, STRESS_CUBES * RENDER_ROUNDS);
+    Bench_Counts("culled");
+    printf("%-10s %d visible, %d culled per frame\n", "culled",
+           stats->visible / RENDER_ROUNDS, stats->culled / RENDER_ROUNDS);
+
+    MeshCache_Shutdown();
+    RenderQueue_Shutdown();
+    RenderBatch_Shutdown();
+    ECS_Cleanup(world);
+    return 0;
+}
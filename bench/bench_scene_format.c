@@ -0,0 +1,131 @@
+// Compact chunked scene encoding against the legacy fixed-record dump, on
+// stress scenes. For the compact run every tenth entity is also parented to
+// the one before it.
+// Reports bytes per entity and encode/decode throughput for both formats.
+// Each format must round-trip: decoding into a second world and encoding
+// again has to give back the same bytes.
+#include "bench_common.h"
+#include "ecs.h"
+#include "hierarchy.h"
+#include "scene_format.h"
+#include "stress_scene.h"
+#include <stdlib.h>
+#include <string.h>
+
+volatile float g_benchSink;
+
+#define FORMAT_ROUNDS 20
+
+typedef size_t (*BenchEncodeFn)(ECSWorld* world, void* buffer, size_t bufferSize);
+typedef bool (*BenchDecodeFn)(ECSWorld* world, const void* data, size_t size);
+
+static ECSWorld g_source;
+static ECSWorld g_target;
+
+static void Bench_BuildScene(ECSWorld* world, int entities) {
+    StressSceneConfig config;
+    StressScene_DefaultConfig(&config);
+    config.entityCount = entities;
+
+    ECS_InitWithCapacity(world, entities + 1);
+    StressScene_Create(world, &config);
+}
+
+// The legacy dump has no hierarchy, so links are only added for the compact run
+static void Bench_LinkScene(ECSWorld* world) {
+    EntityID previous = ECS_INVALID_ENTITY;
+    int n = 0;
+    for (EntityID id = ECS_FirstEntity(world); id != ECS_INVALID_ENTITY; id = ECS_NextEntity(world, id), n++) {
+        if (n > 0 && n % 10 == 0) Hierarchy_SetParent(world, id, previous);
+        previous = id;
+    }
+}
+
+// Times FORMAT_ROUNDS encodes and decodes; false if the round trip differs
+static bool Bench_Format(const char* label, int entities, size_t bufferSize, BenchEncodeFn encode,
+                         BenchDecodeFn decode) {
+    unsigned char* first = (unsigned char*)malloc(bufferSize);
+    unsigned char* second = (unsigned char*)malloc(bufferSize);
+    size_t size = 0;
+
+    double start = Bench_NowNs();
+    for (int round = 0; round < FORMAT_ROUNDS; round++) size = encode(&g_source, first, bufferSize);
+    double encodeNs = (Bench_NowNs() - start) / FORMAT_ROUNDS;
+
+    bool decoded = true;
+    start = Bench_NowNs();
+    for (int round = 0; round < FORMAT_ROUNDS; round++) decoded &= decode(&g_target, first, size);
+    double decodeNs = (Bench_NowNs() - start) / FORMAT_ROUNDS;
+
+    size_t again = encode(&g_target, second, bufferSize);
+    bool match = decoded && size > 0 && again == size && memcmp(first, second, size) == 0;
+
+    printf("%-8s %8d entities %9zu bytes %6.1f B/entity  encode %7.1f MB/s %7.1f ns/entity  "
+           "decode %7.1f MB/s %7.1f ns/entity%s\n",
+           label, entities, size, (double)size / entities, (double)size * 1e3 / encodeNs, encodeNs / entities,
+           (double)size * 1e3 / decodeNs, decodeNs / entities, match ? "" : "  ROUND TRIP MISMATCH");
+
+    free(second);
+    free(first);
+    return match;
+}
+
+// A save whose header asks for a newer reader, one cut short, and one
+// holding a renderable type that does not exist must all be refused without
+// touching the world, in either format
+static bool Bench_Rejects(int entities) {
+    size_t bufferSize = SceneFormat_MaxEncodedSize(entities + 1);
+    if (SceneFormat_LegacySize(entities + 1) > bufferSize) bufferSize = SceneFormat_LegacySize(entities + 1);
+    unsigned char* data = (unsigned char*)malloc(bufferSize);
+    size_t size = SceneFormat_Encode(&g_source, data, bufferSize);
+    int before = g_target.entityCount;
+
+    data[6] = SCENE_FORMAT_VERSION + 1;     // minReader
+    bool newer = SceneFormat_Decode(&g_target, data, size);
+    data[6] = SCENE_FORMAT_VERSION;
+    bool truncated = SceneFormat_Decode(&g_target, data, size - 1);
+
+    RenderableComponent* renderable = NULL;
+    for (EntityID id = ECS_FirstEntity(&g_source); id != ECS_INVALID_ENTITY && !renderable;
+         id = ECS_NextEntity(&g_source, id)) {
+        renderable = (RenderableComponent*)ECS_GetComponent(&g_source, id, COMPONENT_RENDERABLE);
+    }
+    RenderableType type = renderable->type;
+    renderable->type = (RenderableType)200;
+    size = SceneFormat_Encode(&g_source, data, bufferSize);
+    bool badType = SceneFormat_Decode(&g_target, data, size);
+    size = SceneFormat_EncodeLegacy(&g_source, data, bufferSize);
+    bool badLegacyType = SceneFormat_DecodeLegacy(&g_target, data, size);
+    renderable->type = type;
+    bool ok = !newer && !truncated && !badType && !badLegacyType && g_target.entityCount == before;
+
+    printf("reject   newer reader %s, truncated %s, bad renderable type %s/%s\n", newer ? "accepted" : "refused",
+           truncated ? "accepted" : "refused", badType ? "accepted" : "refused",
+           badLegacyType ? "accepted" : "refused");
+    free(data);
+    return ok;
+}
+
+int main(void) {
+    const int counts[] = {256, 4096, 16384};
+    int failures = 0;
+
+    Mem_Init();
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        int entities = counts[i];
+        Bench_BuildScene(&g_source, entities);
+        ECS_InitWithCapacity(&g_target, entities + 1);
+
+        size_t legacySize = SceneFormat_LegacySize(entities + 1);
+        size_t compactSize = SceneFormat_MaxEncodedSize(entities + 1);
+        failures += !Bench_Format("legacy", entities, legacySize, SceneFormat_EncodeLegacy, SceneFormat_DecodeLegacy);
+        Bench_LinkScene(&g_source);
+        failures += !Bench_Format("compact", entities, compactSize, SceneFormat_Encode, SceneFormat_Decode);
+        if (i == 0) failures += !Bench_Rejects(entities);
+
+        ECS_Cleanup(&g_target);
+        ECS_Cleanup(&g_source);
+    }
+    Mem_Shutdown();
+    return failures != 0;
+}
@@ -0,0 +1,227 @@
+// Autosave journal on a stress scene: after a snapshot, each round edits a
+// share of the entities (moves, recolors, reparenting, destroys and creates)
+// and saves a record. Reports record bytes and build time for the delta
+// against a full snapshot of the same world, and when compaction replaces
+// the journal. The journal must then replay into a second world that matches
+// the first slot for slot, and a record cut short must be dropped cleanly.
+#include "bench_common.h"
+#include "ecs.h"
+#include "hierarchy.h"
+#include "mem.h"
+#include "scene_journal.h"
+#include "stress_scene.h"
+#include <stdlib.h>
+#include <string.h>
+
+volatile float g_benchSink;
+
+#define JOURNAL_ENTITIES 16384
+
+static ECSWorld g_source;
+static ECSWorld g_target;
+
+// Live entities of g_source, for picking edits at random
+static EntityID* g_live;
+static int g_liveCount;
+
+// Journal file contents
+static unsigned char* g_file;
+static size_t g_fileSize;
+static size_t g_fileCapacity;
+
+static BenchRng g_rng = {12345u};
+
+static void Bench_Store(const SceneJournalRecord* record) {
+    if (record->snapshot) g_fileSize = 0;
+    if (g_fileSize + record->size > g_fileCapacity) {
+        g_fileCapacity = (g_fileSize + record->size) * 2;
+        g_file = (unsigned char*)realloc(g_file, g_fileCapacity);
+    }
+    memcpy(g_file + g_fileSize, record->data, record->size);
+    g_fileSize += record->size;
+}
+
+static EntityID Bench_CreateEntity(void) {
+    EntityID id = ECS_CreateEntity(&g_source);
+    TransformComponent* transform = (TransformComponent*)ECS_AddComponent(&g_source, id, COMPONENT_TRANSFORM);
+    RenderableComponent* renderable = (RenderableComponent*)ECS_AddComponent(&g_source, id, COMPONENT_RENDERABLE);
+    transform->position = (Vector3){(float)(Bench_Rand(&g_rng) % 200), 1.0f, (float)(Bench_Rand(&g_rng) % 200)};
+    renderable->type = RENDERABLE_CUBE;
+    renderable->color = (Color){(unsigned char)Bench_Rand(&g_rng), 128, 64, 255};
+    renderable->size = (Vector3){1.0f, 1.0f, 1.0f};
+    return id;
+}
+
+// Edits `changes` entities; one in ten edits destroys an entity and creates another
+static void Bench_Edit(int changes) {
+    for (int i = 0; i < changes; i++) {
+        int pick = (int)(Bench_Rand(&g_rng) % (unsigned int)g_liveCount);
+        EntityID id = g_live[pick];
+        switch (i % 10) {
+            case 0:
+                ECS_DestroyEntity(&g_source, id);
+                g_live[pick] = Bench_CreateEntity();
+                break;
+            case 1: {
+                RenderableComponent* renderable = (RenderableComponent*)ECS_GetComponent(&g_source, id,
+                                                                                         COMPONENT_RENDERABLE);
+                if (renderable) {
+                    renderable->color.g = (unsigned char)Bench_Rand(&g_rng);
+                    ECS_MarkChanged(&g_source, id, COMPONENT_RENDERABLE);
+                }
+                break;
+            }
+            case 2:
+                Hierarchy_SetParent(&g_source, id, g_live[Bench_Rand(&g_rng) % (unsigned int)g_liveCount]);
+                break;
+            default: {
+                TransformComponent* transform = (TransformComponent*)ECS_GetComponent(&g_source, id,
+                                                                                      COMPONENT_TRANSFORM);
+                if (transform) {
+                    transform->position.y += 0.5f;
+                    transform->rotation.y += 0.1f;
+                    ECS_MarkTransformDirty(&g_source, id);
+                }
+                break;
+            }
+        }
+    }
+}
+
+static bool Bench_SameVector(Vector3 a, Vector3 b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+static EntityID Bench_LiveParent(ECSWorld* world, EntityID id) {
+    EntityID parent = Hierarchy_GetParent(world, id);
+    return ECS_IsEntityValid(world, parent) ? parent : ECS_INVALID_ENTITY;
+}
+
+// Every live source entity has a counterpart with the same saved state
+static bool Bench_Matches(const EntityID* slotMap) {
+    if (g_target.entityCount != g_source.entityCount) return false;
+
+    // A root's hierarchy node is not saved, as in SceneFormat_Decode; parents are compared below
+    unsigned int compared = ~COMPONENT_BIT(COMPONENT_HIERARCHY);
+    for (EntityID id = ECS_FirstEntity(&g_source); id != ECS_INVALID_ENTITY; id = ECS_NextEntity(&g_source, id)) {
+        EntityID other = slotMap[ECS_ENTITY_INDEX(id)];
+        unsigned int mask = ECS_GetComponentMask(&g_source, id) & compared;
+        if (!ECS_IsEntityValid(&g_target, other) || (ECS_GetComponentMask(&g_target, other) & compared) != mask) {
+            return false;
+        }
+
+        const TransformComponent* a = (const TransformComponent*)ECS_GetComponent(&g_source, id, COMPONENT_TRANSFORM);
+        const TransformComponent* b = (const TransformComponent*)ECS_GetComponent(&g_target, other, COMPONENT_TRANSFORM);
+        if (a && (!Bench_SameVector(a->position, b->position) || !Bench_SameVector(a->rotation, b->rotation) ||
+                  !Bench_SameVector(a->scale, b->scale))) {
+            return false;
+        }
+
+        const RenderableComponent* ra = (const RenderableComponent*)ECS_GetComponent(&g_source, id,
+                                                                                     COMPONENT_RENDERABLE);
+        const RenderableComponent* rb = (const RenderableComponent*)ECS_GetComponent(&g_target, other,
+                                                                                     COMPONENT_RENDERABLE);
+        if (ra && (ra->type != rb->type || memcmp(&ra->color, &rb->color, sizeof(Color)) != 0 ||
+                   !Bench_SameVector(ra->size, rb->size))) {
+            return false;
+        }
+
+        EntityID parent = Bench_LiveParent(&g_source, id);
+        EntityID expected = parent != ECS_INVALID_ENTITY ? slotMap[ECS_ENTITY_INDEX(parent)] : ECS_INVALID_ENTITY;
+        if (Bench_LiveParent(&g_target, other) != expected) return false;
+    }
+    return true;
+}
+
+// One autosave: the journal's record against a full snapshot of the same world
+static void Bench_Autosave(SceneJournal* journal, const char* label) {
+    SceneJournal full;
+    SceneJournal_Init(&full, true);
+    SceneJournalRecord record;
+
+    Mem_BeginFrame();
+    double start = Bench_NowNs();
+    SceneJournal_BeginRecord(&full, &g_source, &record);
+    double fullNs = Bench_NowNs() - start;
+    size_t fullSize = record.size;
+    SceneJournal_EndRecord(&full, &g_source, &record, false);
+
+    int changed = g_source.changesLost ? g_source.entityCount : g_source.changedSlotCount;
+    Mem_BeginFrame();
+    start = Bench_NowNs();
+    SceneJournal_BeginRecord(journal, &g_source, &record);
+    double recordNs = Bench_NowNs() - start;
+    Bench_Store(&record);
+
+    printf("%-12s %6d slots changed  %-8s %9zu bytes %8.1f us   full snapshot %9zu bytes %8.1f us\n", label,
+           changed, record.snapshot ? "snapshot" : "delta", record.size, recordNs * 1e-3, fullSize, fullNs * 1e-3);
+    SceneJournal_EndRecord(journal, &g_source, &record, true);
+}
+
+static bool Bench_Replay(int* records) {
+    EntityID* slotMap = (EntityID*)malloc(sizeof(EntityID) * (size_t)ECS_GetCapacity(&g_target));
+    double start = Bench_NowNs();
+    *records = SceneJournal_Replay(&g_target, g_file, g_fileSize, slotMap);
+    double replayNs = Bench_NowNs() - start;
+    bool match = *records > 0 && Bench_Matches(slotMap);
+    printf("replay       %zu bytes, %d records in %.1f us: %s\n", g_fileSize, *records, replayNs * 1e-3,
+           match ? "matches" : "MISMATCH");
+    free(slotMap);
+    return match;
+}
+
+int main(void) {
+    // Half the scene at a time outgrows the snapshot and compacts the journal
+    const float shares[] = {0.5f, 0.001f, 0.01f, 0.1f};
+    int failures = 0;
+
+    Mem_Init();
+    StressSceneConfig config;
+    StressScene_DefaultConfig(&config);
+    config.entityCount = JOURNAL_ENTITIES;
+    ECS_InitWithCapacity(&g_source, JOURNAL_ENTITIES * 2);
+    ECS_InitWithCapacity(&g_target, JOURNAL_ENTITIES * 2);
+    StressScene_Create(&g_source, &config);
+
+    g_live = (EntityID*)malloc(sizeof(EntityID) * (size_t)g_source.entityCount);
+    for (EntityID id = ECS_FirstEntity(&g_source); id != ECS_INVALID_ENTITY; id = ECS_NextEntity(&g_source, id)) {
+        if (ECS_HasComponent(&g_source, id, COMPONENT_TRANSFORM)) g_live[g_liveCount++] = id;
+    }
+
+    SceneJournal journal;
+    SceneJournal_Init(&journal, true);
+    Bench_Autosave(&journal, "initial");
+    for (size_t i = 0; i < sizeof(shares) / sizeof(shares[0]); i++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%.1f%% edits", shares[i] * 100.0f);
+        for (int round = 0; round < 3; round++) {
+            Bench_Edit((int)((float)g_liveCount * shares[i]));
+            Bench_Autosave(&journal, label);
+        }
+    }
+
+    int records = 0;
+    failures += !Bench_Replay(&records);
+
+    // A torn append: the partial record is dropped and the rest still loads
+    Bench_Edit(64);
+    SceneJournalRecord record;
+    Mem_BeginFrame();
+    SceneJournal_BeginRecord(&journal, &g_source, &record);
+    if (!record.snapshot) {
+        size_t before = g_fileSize;
+        Bench_Store(&record);
+        g_fileSize = before + record.size / 2;
+        int tornRecords = SceneJournal_Replay(&g_target, g_file, g_fileSize, NULL);
+        printf("torn append  %d of %d records replayed\n", tornRecords, records + 1);
+        failures += tornRecords != records;
+    }
+    SceneJournal_EndRecord(&journal, &g_source, &record, false);
+
+    free(g_file);
+    free(g_live);
+    ECS_Cleanup(&g_target);
+    ECS_Cleanup(&g_source);
+    Mem_Shutdown();
+    return failures != 0;
+}
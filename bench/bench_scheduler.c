@@ -0,0 +1,128 @@
+// Scheduler speedup with synthetic systems. Each system does a fixed amount
+// of arithmetic over its own array; the read/write masks only need to be
+// distinct bits, so they name data sets rather than component types.
+//   independent - 16 systems writing disjoint data
+//   chains      - 4 chains of 4 systems, each reading its predecessor's data
+//   fan         - one producer, 14 readers of its data, one final writer
+// Every graph runs serially, then through Scheduler_Run with 1, 2, 4 and
+// one worker per CPU. The arrays are checked against the serial results.
+#include "bench_common.h"
+#include "scheduler.h"
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+
+volatile float g_benchSink;
+
+#define SYSTEM_COUNT 16
+#define SYSTEM_ELEMENTS 4096
+#define SYSTEM_PASSES 8
+#define RUN_ROUNDS 50
+
+typedef enum {
+    GRAPH_INDEPENDENT,
+    GRAPH_CHAINS,
+    GRAPH_FAN,
+    GRAPH_COUNT
+} BenchGraph;
+
+static const char* g_graphNames[GRAPH_COUNT] = {"independent", "chains", "fan"};
+
+typedef struct {
+    float* data;        // Written
+    const float* input; // Read, NULL for none
+} BenchSystem;
+
+static float g_data[SYSTEM_COUNT][SYSTEM_ELEMENTS];
+static float g_expected[SYSTEM_COUNT][SYSTEM_ELEMENTS];
+static BenchSystem g_systems[SYSTEM_COUNT];
+
+static void Bench_SystemUpdate(ECSWorld* world, float deltaTime, void* user) {
+    BenchSystem* system = (BenchSystem*)user;
+    (void)world;
+    for (int pass = 0; pass < SYSTEM_PASSES; pass++) {
+        for (int i = 0; i < SYSTEM_ELEMENTS; i++) {
+            float in = system->input ? system->input[i] : 1.0f;
+            system->data[i] = sinf(system->data[i] + in * deltaTime) * 0.5f + 0.5f;
+        }
+    }
+}
+
+// System i writes data set i; its input decides which earlier set it reads
+static int Bench_Input(BenchGraph graph, int i) {
+    switch (graph) {
+        case GRAPH_CHAINS: return (i % 4) ? i - 1 : -1;
+        case GRAPH_FAN: return i == 0 ? -1 : (i == SYSTEM_COUNT - 1 ? 1 : 0);
+        default: return -1;
+    }
+}
+
+static void Bench_Build(Scheduler* scheduler, BenchGraph graph) {
+    for (int i = 0; i < SYSTEM_COUNT; i++) {
+        int input = Bench_Input(graph, i);
+        g_systems[i].data = g_data[i];
+        g_systems[i].input = input >= 0 ? g_data[input] : NULL;
+
+        SystemDesc desc = {"synthetic", Bench_SystemUpdate, &g_systems[i], input >= 0 ? 1u << input : 0, 1u << i};
+        // Claiming the producer's data makes the fan's last system wait for every reader
+        if (graph == GRAPH_FAN && i == SYSTEM_COUNT - 1) {
+            desc.writes |= 1u;
+        }
+        Scheduler_AddSystem(scheduler, &desc);
+    }
+}
+
+static void Bench_Reset(void) {
+    for (int s = 0; s < SYSTEM_COUNT; s++) {
+        for (int i = 0; i < SYSTEM_ELEMENTS; i++) g_data[s][i] = (float)((s * 31 + i) % 97) / 97.0f;
+    }
+}
+
+static double Bench_Time(Scheduler* scheduler, bool serial) {
+    Bench_Reset();
+    double start = Bench_NowNs();
+    for (int round = 0; round < RUN_ROUNDS; round++) {
+        if (serial) {
+            Scheduler_RunSerial(scheduler, NULL, 0.016f);
+        } else {
+            Scheduler_Run(scheduler, NULL, 0.016f);
+        }
+    }
+    return Bench_NowNs() - start;
+}
+
+int main(void) {
+    int cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int workerCounts[] = {1, 2, 4, cpus};
+    int failures = 0;
+
+    printf("%d CPUs online\n", cpus);
+    for (int graph = 0; graph < GRAPH_COUNT; graph++) {
+        Scheduler serial;
+        Scheduler_Init(&serial, 1);
+        Bench_Build(&serial, (BenchGraph)graph);
+        double serialNs = Bench_Time(&serial, true);
+        memcpy(g_expected, g_data, sizeof(g_data));
+        Scheduler_Shutdown(&serial);
+        Bench_Report("serial", g_graphNames[graph], SYSTEM_COUNT, serialNs, RUN_ROUNDS);
+
+        for (int w = 0; w < (int)(sizeof(workerCounts) / sizeof(workerCounts[0])); w++) {
+            Scheduler scheduler;
+            Scheduler_Init(&scheduler, workerCounts[w]);
+            Bench_Build(&scheduler, (BenchGraph)graph);
+            double ns = Bench_Time(&scheduler, false);
+            bool match = memcmp(g_expected, g_data, sizeof(g_data)) == 0;
+            failures += !match;
+
+            char label[16];
+            snprintf(label, sizeof(label), "%d workers", scheduler.workerCount);
+            Bench_Report(label, g_graphNames[graph], SYSTEM_COUNT, ns, RUN_ROUNDS);
+            printf("%-10s %-10s speedup %.2fx%s\n", label, g_graphNames[graph], serialNs / ns,
+                   match ? "" : "  RESULT MISMATCH");
+            Scheduler_Shutdown(&scheduler);
+        }
+    }
+
+    g_benchSink = g_data[SYSTEM_COUNT - 1][0];
+    return failures != 0;
+}
@@ -0,0 +1,179 @@
+// Radius and box queries through the spatial hash against a brute-force
+// scan of every transform, at constant density so the expected result size
+// stays the same as the world grows. Every query's matches must equal the
+// brute-force scan's, or the run fails.
+#include "bench_common.h"
+#include "ecs.h"
+#include "spatial_hash.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+volatile float g_benchSink;
+
+#define QUERY_COUNT 2000
+#define QUERY_RADIUS 4.0f
+#define CELL_SIZE 4.0f
+#define MAX_RESULTS 4096
+
+static ECSWorld g_world;
+static EntityID g_results[MAX_RESULTS];
+static EntityID g_expected[MAX_RESULTS];
+static int g_mismatches;
+
+static BenchRng g_rng = {12345u};
+
+// Scans every transform; radius < 0 tests the box instead of the sphere
+static int Bench_Brute(ECSWorld* world, Vector3 center, float radius, Vector3 min, Vector3 max, EntityID* results) {
+    int found = 0;
+    float radiusSq = radius * radius;
+    ECSQueryIter iter = ECS_QueryIter(world, ECS_GetQuery(world, COMPONENT_BIT(COMPONENT_TRANSFORM)));
+    while (ECS_QueryNext(&iter)) {
+        const Vector3* p = &((const TransformComponent*)iter.components[COMPONENT_TRANSFORM])->position;
+        float dx = p->x - center.x, dy = p->y - center.y, dz = p->z - center.z;
+        bool inside = radius >= 0.0f ? dx * dx + dy * dy + dz * dz <= radiusSq
+                                     : p->x >= min.x && p->x <= max.x && p->y >= min.y && p->y <= max.y &&
+                                       p->z >= min.z && p->z <= max.z;
+        if (inside) {
+            if (found < MAX_RESULTS) results[found] = iter.entity;
+            found++;
+        }
+    }
+    return found;
+}
+
+static int Bench_CompareIDs(const void* a, const void* b) {
+    EntityID x = *(const EntityID*)a, y = *(const EntityID*)b;
+    return (x > y) - (x < y);
+}
+
+// The hash's matches against the brute-force scan's, as sets
+static void Bench_Check(const char* op, int found, int expected) {
+    bool same = found == expected && found <= MAX_RESULTS;
+    if (same) {
+        qsort(g_results, (size_t)found, sizeof(EntityID), Bench_CompareIDs);
+        qsort(g_expected, (size_t)expected, sizeof(EntityID), Bench_CompareIDs);
+        same = memcmp(g_results, g_expected, sizeof(EntityID) * (size_t)found) == 0;
+    }
+    if (!same) {
+        if (g_mismatches == 0) printf("ERROR: hash %s found %d matches, brute force %d\n", op, found, expected);
+        g_mismatches++;
+    }
+}
+
+// Every query's matches against a brute-force scan
+static void Bench_Verify(SpatialHash* hash, ECSWorld* world, const Vector3* centers) {
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        Vector3 min = {centers[i].x - QUERY_RADIUS, centers[i].y - QUERY_RADIUS, centers[i].z - QUERY_RADIUS};
+        Vector3 max = {centers[i].x + QUERY_RADIUS, centers[i].y + QUERY_RADIUS, centers[i].z + QUERY_RADIUS};
+
+        int expected = Bench_Brute(world, centers[i], QUERY_RADIUS, min, max, g_expected);
+        Bench_Check("radius", SpatialHash_QueryRadius(hash, centers[i], QUERY_RADIUS, g_results, MAX_RESULTS),
+                    expected);
+
+        expected = Bench_Brute(world, centers[i], -1.0f, min, max, g_expected);
+        Bench_Check("aabb", SpatialHash_QueryAABB(hash, min, max, g_results, MAX_RESULTS), expected);
+    }
+}
+
+static void Bench_Spatial(int count) {
+    ECSWorld* world = &g_world;
+    ECS_InitWithCapacity(world, count);
+
+    // About one entity per 8 cubic units
+    float extent = cbrtf((float)count * 8.0f);
+    for (int i = 0; i < count; i++) {
+        EntityID id = ECS_CreateEntity(world);
+        TransformComponent* transform = (TransformComponent*)ECS_AddComponent(world, id, COMPONENT_TRANSFORM);
+        transform->position = (Vector3){Bench_RandRange(&g_rng, extent), Bench_RandRange(&g_rng, extent), Bench_RandRange(&g_rng, extent)};
+    }
+
+    Vector3* centers = (Vector3*)malloc(sizeof(Vector3) * QUERY_COUNT);
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        centers[i] = (Vector3){Bench_RandRange(&g_rng, extent), Bench_RandRange(&g_rng, extent), Bench_RandRange(&g_rng, extent)};
+    }
+
+    System_UpdateTransforms(world);
+
+    SpatialHash hash;
+    SpatialHash_Init(&hash, ECS_GetCapacity(world), CELL_SIZE);
+
+    double start = Bench_NowNs();
+    SpatialHash_Sync(&hash, world);
+    Bench_Report("hash", "build", count, Bench_NowNs() - start, count);
+
+    // Move one entity in ten, then resync: only the dirty transforms are read,
+    // so its cost is reported per mover rather than per entity
+    ECSQueryIter iter = ECS_QueryIter(world, ECS_GetQuery(world, COMPONENT_BIT(COMPONENT_TRANSFORM)));
+    int moved = 0;
+    while (ECS_QueryNext(&iter)) {
+        if ((moved++ % 10) == 0) {
+            ((TransformComponent*)iter.components[COMPONENT_TRANSFORM])->position.x += 3.0f;
+            ECS_MarkTransformDirty(world, iter.entity);
+        }
+    }
+    start = Bench_NowNs();
+    SpatialHash_Sync(&hash, world);
+    Bench_Report("hash", "resync", count, Bench_NowNs() - start, (count + 9) / 10);
+    System_UpdateTransforms(world);
+    Bench_Verify(&hash, world, centers);
+
+    // Replace one entity in a hundred: the changed Transform query forces a full walk
+    iter = ECS_QueryIter(world, ECS_GetQuery(world, COMPONENT_BIT(COMPONENT_TRANSFORM)));
+    int replaced = 0;
+    for (int i = 0; ECS_QueryNext(&iter); i++) {
+        if ((i % 100) == 0) g_results[replaced++] = iter.entity;
+    }
+    for (int i = 0; i < replaced; i++) {
+        ECS_DestroyEntity(world, g_results[i]);
+        EntityID id = ECS_CreateEntity(world);
+        TransformComponent* transform = (TransformComponent*)ECS_AddComponent(world, id, COMPONENT_TRANSFORM);
+        transform->position = (Vector3){Bench_RandRange(&g_rng, extent), Bench_RandRange(&g_rng, extent), Bench_RandRange(&g_rng, extent)};
+    }
+    start = Bench_NowNs();
+    SpatialHash_Sync(&hash, world);
+    Bench_Report("hash", "rescan", count, Bench_NowNs() - start, count);
+    System_UpdateTransforms(world);
+    Bench_Verify(&hash, world, centers);
+
+    long bruteMatches = 0;
+    start = Bench_NowNs();
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        bruteMatches += Bench_Brute(world, centers[i], QUERY_RADIUS, centers[i], centers[i], g_expected);
+    }
+    Bench_Report("brute", "radius", count, Bench_NowNs() - start, QUERY_COUNT);
+
+    long hashMatches = 0;
+    start = Bench_NowNs();
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        hashMatches += SpatialHash_QueryRadius(&hash, centers[i], QUERY_RADIUS, g_results, MAX_RESULTS);
+    }
+    Bench_Report("hash", "radius", count, Bench_NowNs() - start, QUERY_COUNT);
+
+    long boxMatches = 0;
+    start = Bench_NowNs();
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        Vector3 min = {centers[i].x - QUERY_RADIUS, centers[i].y - QUERY_RADIUS, centers[i].z - QUERY_RADIUS};
+        Vector3 max = {centers[i].x + QUERY_RADIUS, centers[i].y + QUERY_RADIUS, centers[i].z + QUERY_RADIUS};
+        boxMatches += SpatialHash_QueryAABB(&hash, min, max, g_results, MAX_RESULTS);
+    }
+    Bench_Report("hash", "aabb", count, Bench_NowNs() - start, QUERY_COUNT);
+
+    printf("%-10s %.1f matches/query (radius, brute %.1f), %.1f (aabb)\n", "hash", (double)hashMatches / QUERY_COUNT,
+           (double)bruteMatches / QUERY_COUNT, (double)boxMatches / QUERY_COUNT);
+
+    SpatialHash_Release(&hash);
+    ECS_Cleanup(world);
+    free(centers);
+}
+
+int main(void) {
+    const int counts[] = {1000, 10000, 100000};
+
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        Bench_Spatial(counts[i]);
+    }
+
+    if (g_mismatches > 0) printf("ERROR: %d queries disagreed with brute force\n", g_mismatches);
+    return g_mismatches != 0;
+}
@@ -0,0 +1,106 @@
+// Field of spheres receding from a low camera: per-level counts,
+// triangles against drawing every sphere at full detail, and frame time.
+// Then the camera bobs back and forth so spheres sit on level boundaries,
+// counting level switches per frame with and without hysteresis.
+#include "bench_common.h"
+#include "culling.h"
+#include "ecs.h"
+#include "mesh_cache.h"
+#include "render_batch.h"
+#include "render_queue.h"
+#include <math.h>
+
+volatile float g_benchSink;
+
+#define FIELD_WIDTH 40
+#define FIELD_DEPTH 100
+#define SPHERE_COUNT (FIELD_WIDTH * FIELD_DEPTH)
+#define RENDER_ROUNDS 50
+#define BOB_ROUNDS 200
+
+static ECSWorld g_world;
+
+static void Bench_BuildField(ECSWorld* world) {
+    ECS_InitWithCapacity(world, SPHERE_COUNT);
+    for (int i = 0; i < SPHERE_COUNT; i++) {
+        EntityID id = ECS_CreateEntity(world);
+        TransformComponent* transform = (TransformComponent*)ECS_AddComponent(world, id, COMPONENT_TRANSFORM);
+        RenderableComponent* renderable = (RenderableComponent*)ECS_AddComponent(world, id, COMPONENT_RENDERABLE);
+        transform->position = (Vector3){(float)(i % FIELD_WIDTH) * 1.5f - 30.0f, 0.5f, -(float)(i / FIELD_WIDTH) * 1.5f};
+        renderable->type = RENDERABLE_SPHERE;
+        renderable->color = (Color){(unsigned char)(60 + (i % 4) * 40), 120, 200, 255};
+        renderable->size = (Vector3){1.0f, 1.0f, 1.0f};
+    }
+}
+
+static Frustum Bench_Frustum(float offset) {
+    Camera3D camera = {0};
+    camera.position = (Vector3){0.0f, 3.0f, 4.0f + offset};
+    camera.target = (Vector3){0.0f, 0.0f, -20.0f + offset};
+    camera.up = (Vector3){0.0f, 1.0f, 0.0f};
+    camera.fovy = 45.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+    return Culling_FrustumFromCamera(&camera, 480.0f / 272.0f, 0.01f, 1000.0f);
+}
+
+static void Bench_Levels(ECSWorld* world) {
+    Frustum frustum = Bench_Frustum(0.0f);
+    RenderBatch_ResetStats();
+
+    double start = Bench_NowNs();
+    for (int round = 0; round < RENDER_ROUNDS; round++) {
+        System_Render(world, &frustum, NULL);
+    }
+    Bench_Report("lod", "render", SPHERE_COUNT, Bench_NowNs() - start, RENDER_ROUNDS);
+
+    const RenderStats* stats = RenderBatch_GetStats();
+    int triangles = 0;
+    for (int lod = 0; lod < RENDER_SPHERE_LOD_COUNT; lod++) {
+        printf("lod %d      %6d spheres %8d triangles per frame (%d each)\n", lod,
+               stats->sphereLods[lod] / RENDER_ROUNDS, stats->sphereTriangles[lod] / RENDER_ROUNDS,
+               RenderBatch_GetSphereTriangles(lod));
+        triangles += stats->sphereTriangles[lod] / RENDER_ROUNDS;
+    }
+    int visible = stats->visible / RENDER_ROUNDS;
+    printf("lod        %d triangles for %d visible spheres, %d at full detail\n", triangles, visible,
+           visible * RenderBatch_GetSphereTriangles(0));
+}
+
+// Replays the selection the render system makes, counting how many spheres
+// change level each frame
+static void Bench_Bob(ECSWorld* world, const char* label, bool hysteresis) {
+    static int levels[SPHERE_COUNT];
+    for (int i = 0; i < SPHERE_COUNT; i++) levels[i] = 0;
+
+    long switches = 0;
+    ECSQuery* query = ECS_GetQuery(world, COMPONENT_BIT(COMPONENT_TRANSFORM) | COMPONENT_BIT(COMPONENT_RENDERABLE));
+    for (int round = 0; round < BOB_ROUNDS; round++) {
+        Frustum frustum = Bench_Frustum(0.3f * sinf((float)round * 0.7f));
+
+        int i = 0;
+        ECSQueryIter iter = ECS_QueryIter(world, query);
+        while (ECS_QueryNext(&iter)) {
+            TransformComponent* transform = (TransformComponent*)iter.components[COMPONENT_TRANSFORM];
+            float size = Culling_ScreenSize(&frustum, transform->position, 0.5f);
+            int lod = RenderBatch_SelectSphereLod(size, hysteresis ? levels[i] : -1);
+            if (round > 0 && lod != levels[i]) switches++;
+            levels[i++] = lod;
+        }
+    }
+    printf("%-10s %.1f level switches per frame\n", label, (double)switches / (BOB_ROUNDS - 1));
+}
+
+int main(void) {
+    ECSWorld* world = &g_world;
+    Bench_BuildField(world);
+
+    Bench_Levels(world);
+    Bench_Bob(world, "raw", false);
+    Bench_Bob(world, "hysteresis", true);
+
+    MeshCache_Shutdown();
+    RenderQueue_Shutdown();
+    RenderBatch_Shutdown();
+    ECS_Cleanup(world);
+    return 0;
+}
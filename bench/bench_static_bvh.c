@@ -0,0 +1,241 @@
+// Static BVH over 10k/100k boxes: build time, then frustum and ray queries
+// against a brute-force pass over every static entity. Cameras sit inside
+// the box field looking horizontally, so each frustum sees a slice of it.
+// Both paths must agree on every query, frustum results as sets of IDs, and
+// syncing an unchanged world must not rebuild; otherwise the run fails.
+#include "bench_common.h"
+#include "ecs.h"
+#include "static_bvh.h"
+#include "render_batch.h"
+#include "render_queue.h"
+#include "mesh_cache.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+volatile float g_benchSink;
+static int g_failures;
+
+#define BUILD_ROUNDS 10
+#define VIEW_COUNT 200
+#define RAY_COUNT 2000
+
+static ECSWorld g_world;
+
+static BenchRng g_rng = {12345u};
+
+static unsigned int Bench_StaticMask(void) {
+    return COMPONENT_BIT(COMPONENT_TRANSFORM) | COMPONENT_BIT(COMPONENT_RENDERABLE) | COMPONENT_BIT(COMPONENT_STATIC);
+}
+
+// Visible static entities; their IDs go to results when it is not NULL
+static int Bench_BruteFrustum(ECSWorld* world, const Frustum* frustum, EntityID* results) {
+    int found = 0;
+    ECSQueryIter iter = ECS_QueryIter(world, ECS_GetQuery(world, Bench_StaticMask()));
+    while (ECS_QueryNext(&iter)) {
+        Vector3 center;
+        Vector3 halfExtents;
+        System_RenderBounds((const TransformComponent*)iter.components[COMPONENT_TRANSFORM],
+                            (const RenderableComponent*)iter.components[COMPONENT_RENDERABLE],
+                            &center, &halfExtents);
+        if (Culling_TestAABB(frustum, center, halfExtents)) {
+            if (results) results[found] = iter.entity;
+            found++;
+        }
+    }
+    return found;
+}
+
+static int Bench_CompareIDs(const void* a, const void* b) {
+    EntityID x = *(const EntityID*)a, y = *(const EntityID*)b;
+    return (x > y) - (x < y);
+}
+
+// Views whose BVH results differ from the brute-force pass as sets of IDs
+static int Bench_CheckFrustums(ECSWorld* world, const StaticBVH* bvh, const Frustum* views, int count) {
+    EntityID* found = (EntityID*)malloc(sizeof(EntityID) * (size_t)count);
+    EntityID* expected = (EntityID*)malloc(sizeof(EntityID) * (size_t)count);
+    int mismatches = 0;
+    for (int i = 0; i < VIEW_COUNT; i++) {
+        int n = StaticBVH_QueryFrustum(bvh, &views[i], found, count);
+        if (n != Bench_BruteFrustum(world, &views[i], expected)) {
+            mismatches++;
+            continue;
+        }
+        qsort(found, (size_t)n, sizeof(EntityID), Bench_CompareIDs);
+        qsort(expected, (size_t)n, sizeof(EntityID), Bench_CompareIDs);
+        if (memcmp(found, expected, sizeof(EntityID) * (size_t)n) != 0) mismatches++;
+    }
+    free(found);
+    free(expected);
+    return mismatches;
+}
+
+static float Bench_BruteRay(ECSWorld* world, Ray ray, float maxDistance) {
+    float best = maxDistance;
+    bool hit = false;
+    ECSQueryIter iter = ECS_QueryIter(world, ECS_GetQuery(world, Bench_StaticMask()));
+    while (ECS_QueryNext(&iter)) {
+        Vector3 c;
+        Vector3 h;
+        System_RenderBounds((const TransformComponent*)iter.components[COMPONENT_TRANSFORM],
+                            (const RenderableComponent*)iter.components[COMPONENT_RENDERABLE], &c, &h);
+
+        float tmin = 0.0f;
+        float tmax = best;
+        const float o[3] = {ray.position.x, ray.position.y, ray.position.z};
+        const float d[3] = {ray.direction.x, ray.direction.y, ray.direction.z};
+        const float lo[3] = {c.x - h.x, c.y - h.y, c.z - h.z};
+        const float hi[3] = {c.x + h.x, c.y + h.y, c.z + h.z};
+        bool inside = true;
+        for (int a = 0; a < 3 && inside; a++) {
+            if (d[a] == 0.0f) {
+                inside = o[a] >= lo[a] && o[a] <= hi[a];
+                continue;
+            }
+            float t1 = (lo[a] - o[a]) / d[a];
+            float t2 = (hi[a] - o[a]) / d[a];
+            if (t1 > t2) { float t = t1; t1 = t2; t2 = t; }
+            if (t1 > tmin) tmin = t1;
+            if (t2 < tmax) tmax = t2;
+            inside = tmin <= tmax;
+        }
+        if (inside && (!hit || tmin < best)) {
+            best = tmin;
+            hit = true;
+        }
+    }
+    return hit ? best : -1.0f;
+}
+
+static void Bench_BVH(int count) {
+    ECSWorld* world = &g_world;
+    ECS_InitWithCapacity(world, count);
+
+    // Boxes of mixed sizes on a square field, roughly one per 4 square units
+    float extent = sqrtf((float)count * 4.0f);
+    for (int i = 0; i < count; i++) {
+        EntityID id = ECS_CreateEntity(world);
+        TransformComponent* transform = (TransformComponent*)ECS_AddComponent(world, id, COMPONENT_TRANSFORM);
+        RenderableComponent* renderable = (RenderableComponent*)ECS_AddComponent(world, id, COMPONENT_RENDERABLE);
+        ECS_AddComponent(world, id, COMPONENT_STATIC);
+
+        float height = 0.5f + Bench_RandRange(&g_rng, 4.0f);
+        transform->position = (Vector3){Bench_RandRange(&g_rng, extent), height * 0.5f, Bench_RandRange(&g_rng, extent)};
+        renderable->size = (Vector3){0.5f + Bench_RandRange(&g_rng, 1.5f), height, 0.5f + Bench_RandRange(&g_rng, 1.5f)};
+    }
+
+    StaticBVH bvh;
+    StaticBVH_Init(&bvh);
+    StaticBVH_Sync(&bvh, world);
+
+    double start = Bench_NowNs();
+    for (int round = 0; round < BUILD_ROUNDS; round++) {
+        StaticBVH_Invalidate(&bvh);
+        StaticBVH_Sync(&bvh, world);
+    }
+    Bench_Report("bvh", "build", count, Bench_NowNs() - start, BUILD_ROUNDS);
+    printf("%-10s %d nodes, %d leaf size\n", "bvh", bvh.nodeCount, STATIC_BVH_LEAF_SIZE);
+
+    // Syncing an unchanged world must not rebuild
+    start = Bench_NowNs();
+    for (int round = 0; round < BUILD_ROUNDS; round++) {
+        if (StaticBVH_Sync(&bvh, world)) {
+            printf("ERROR: unexpected rebuild\n");
+            g_failures++;
+        }
+    }
+    Bench_Report("bvh", "sync", count, Bench_NowNs() - start, BUILD_ROUNDS);
+
+    Frustum* views = (Frustum*)malloc(sizeof(Frustum) * VIEW_COUNT);
+    for (int i = 0; i < VIEW_COUNT; i++) {
+        Camera3D camera = {0};
+        float angle = Bench_RandRange(&g_rng, 2.0f * PI);
+        camera.position = (Vector3){Bench_RandRange(&g_rng, extent), 1.7f, Bench_RandRange(&g_rng, extent)};
+        camera.target = (Vector3){camera.position.x + cosf(angle), 1.5f, camera.position.z + sinf(angle)};
+        camera.up = (Vector3){0.0f, 1.0f, 0.0f};
+        camera.fovy = 45.0f;
+        camera.projection = CAMERA_PERSPECTIVE;
+        views[i] = Culling_FrustumFromCamera(&camera, 480.0f / 272.0f, 0.01f, 60.0f);
+    }
+
+    EntityID* results = (EntityID*)malloc(sizeof(EntityID) * (size_t)count);
+    int* expected = (int*)malloc(sizeof(int) * VIEW_COUNT);
+    long visible = 0;
+
+    start = Bench_NowNs();
+    for (int i = 0; i < VIEW_COUNT; i++) {
+        expected[i] = Bench_BruteFrustum(world, &views[i], NULL);
+        visible += expected[i];
+    }
+    Bench_Report("brute", "frustum", count, Bench_NowNs() - start, VIEW_COUNT);
+
+    start = Bench_NowNs();
+    for (int i = 0; i < VIEW_COUNT; i++) {
+        g_benchSink += (float)StaticBVH_QueryFrustum(&bvh, &views[i], results, count);
+    }
+    Bench_Report("bvh", "frustum", count, Bench_NowNs() - start, VIEW_COUNT);
+    int mismatches = Bench_CheckFrustums(world, &bvh, views, count);
+    printf("%-10s %ld visible per view, %d mismatches\n", "bvh", visible / VIEW_COUNT, mismatches);
+    g_failures += mismatches;
+
+    Ray* rays = (Ray*)malloc(sizeof(Ray) * RAY_COUNT);
+    float* hits = (float*)malloc(sizeof(float) * RAY_COUNT);
+    for (int i = 0; i < RAY_COUNT; i++) {
+        float angle = Bench_RandRange(&g_rng, 2.0f * PI);
+        rays[i].position = (Vector3){Bench_RandRange(&g_rng, extent), 1.7f, Bench_RandRange(&g_rng, extent)};
+        rays[i].direction = (Vector3){cosf(angle), -0.05f, sinf(angle)};
+    }
+
+    start = Bench_NowNs();
+    for (int i = 0; i < RAY_COUNT; i++) hits[i] = Bench_BruteRay(world, rays[i], 1000.0f);
+    Bench_Report("brute", "raycast", count, Bench_NowNs() - start, RAY_COUNT);
+
+    mismatches = 0;
+    int hitCount = 0;
+    start = Bench_NowNs();
+    for (int i = 0; i < RAY_COUNT; i++) {
+        float distance = -1.0f;
+        EntityID entity;
+        if (!StaticBVH_Raycast(&bvh, rays[i], 1000.0f, &entity, &distance)) distance = -1.0f;
+        if (fabsf(distance - hits[i]) > 1e-4f) mismatches++;
+        if (distance >= 0.0f) hitCount++;
+    }
+    Bench_Report("bvh", "raycast", count, Bench_NowNs() - start, RAY_COUNT);
+    printf("%-10s %d of %d rays hit, %d mismatches\n", "bvh", hitCount, RAY_COUNT, mismatches);
+    g_failures += mismatches;
+
+    // Whole render pass per view: per-entity culling against the BVH
+    start = Bench_NowNs();
+    for (int i = 0; i < VIEW_COUNT; i++) {
+        Mem_BeginFrame();
+        System_Render(world, &views[i], NULL);
+    }
+    Bench_Report("per-entity", "render", count, Bench_NowNs() - start, VIEW_COUNT);
+
+    start = Bench_NowNs();
+    for (int i = 0; i < VIEW_COUNT; i++) {
+        Mem_BeginFrame();
+        System_Render(world, &views[i], &bvh);
+    }
+    Bench_Report("bvh", "render", count, Bench_NowNs() - start, VIEW_COUNT);
+
+    free(rays);
+    free(hits);
+    free(expected);
+    free(results);
+    free(views);
+    StaticBVH_Release(&bvh);
+    ECS_Cleanup(world);
+}
+
+int main(void) {
+    Mem_Init();
+    Bench_BVH(10000);
+    Bench_BVH(100000);
+    MeshCache_Shutdown();
+    RenderQueue_Shutdown();
+    RenderBatch_Shutdown();
+    Mem_Shutdown();
+    return g_failures != 0;
+}
@@ -0,0 +1,169 @@
+// Headless stress run: StressScene_Create builds the scene, then every frame
+// goes through the game's update and render path (fixed ticks through the
+// scheduler, static BVH sync, frustum culling, System_Render) against the
+// stub draw layer while the camera orbits inside the field. Frame times are
+// reported as percentiles for the update, the render and the whole frame.
+//   bench_stress_scene                            default sweep
+//   bench_stress_scene <entities> [frames] [seed] one run
+#include "bench_common.h"
+#include "ecs.h"
+#include "stress_scene.h"
+#include "scheduler.h"
+#include "timestep.h"
+#include "static_bvh.h"
+#include "render_batch.h"
+#include "render_queue.h"
+#include "mesh_cache.h"
+#include <math.h>
+#include <stdlib.h>
+
+volatile float g_benchSink;
+
+#define DEFAULT_FRAMES 300
+#define SCREEN_ASPECT (480.0f / 272.0f)
+#define ORBIT_SECONDS 10.0f
+
+typedef enum {
+    PHASE_UPDATE,
+    PHASE_RENDER,
+    PHASE_FRAME,
+    PHASE_COUNT
+} BenchPhase;
+
+static const char* g_phaseNames[PHASE_COUNT] = {"update", "render", "frame"};
+
+static ECSWorld g_world;
+static StaticBVH g_staticBVH;
+
+static int Bench_CompareDouble(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest rank on sorted samples
+static double Bench_Percentile(const double* sorted, int count, double percent) {
+    int rank = (int)ceil(percent / 100.0 * count);
+    if (rank < 1) rank = 1;
+    return sorted[rank - 1];
+}
+
+static void Bench_UpdateTransforms(ECSWorld* world, float deltaTime, void* user) {
+    (void)deltaTime;
+    (void)user;
+    System_UpdateTransforms(world);
+}
+
+// Circles the field centre, always looking at it
+static void Bench_OrbitCamera(CameraComponent* camera, float radius, float time) {
+    float angle = time / ORBIT_SECONDS * 2.0f * PI;
+    camera->camera.position.x = cosf(angle) * radius;
+    camera->camera.position.z = sinf(angle) * radius;
+}
+
+static void Bench_Run(int entities, int frames, unsigned int seed) {
+    ECSWorld* world = &g_world;
+    StressSceneConfig config;
+    StressScene_DefaultConfig(&config);
+    config.entityCount = entities;
+    config.seed = seed;
+
+    ECS_InitWithCapacity(world, entities + 1);
+    StaticBVH_Init(&g_staticBVH);
+    double start = Bench_NowNs();
+    EntityID cameraEntity = StressScene_Create(world, &config);
+    double spawnNs = Bench_NowNs() - start;
+    CameraComponent* camera = (CameraComponent*)ECS_GetComponent(world, cameraEntity, COMPONENT_CAMERA);
+
+    // Orbiting inside the field keeps part of it behind the camera, so the
+    // culling paths see real work
+    float half = 0.5f * (ceilf(sqrtf((float)entities)) - 1.0f) * config.spacing;
+    float radius = fmaxf(half * 0.5f, 5.0f);
+    camera->camera.position.y = 5.0f;
+
+    // Same system order as the game: animation feeds the transform update
+    Scheduler scheduler;
+    Scheduler_Init(&scheduler, 1);
+    SystemDesc animate = {"stress", StressScene_Animate, &config,
+                          COMPONENT_BIT(COMPONENT_RENDERABLE) | COMPONENT_BIT(COMPONENT_STATIC),
+                          COMPONENT_BIT(COMPONENT_TRANSFORM), StressScene_PrepareAnimate};
+    SystemDesc transforms = {"transforms", Bench_UpdateTransforms, NULL,
+                             COMPONENT_BIT(COMPONENT_TRANSFORM) | COMPONENT_BIT(COMPONENT_HIERARCHY),
+                             COMPONENT_BIT(COMPONENT_TRANSFORM), System_PrepareTransforms};
+    Scheduler_AddSystem(&scheduler, &animate);
+    Scheduler_AddSystem(&scheduler, &transforms);
+
+    FixedTimestep timestep;
+    FixedTimestep_Init(&timestep, TIMESTEP_DEFAULT_RATE, TIMESTEP_DEFAULT_MAX_STEPS);
+
+    double* samples[PHASE_COUNT];
+    for (int p = 0; p < PHASE_COUNT; p++) samples[p] = (double*)malloc(sizeof(double) * (size_t)frames);
+
+    int visible = 0;
+    int culled = 0;
+    for (int frame = 0; frame < frames; frame++) {
+        double frameStart = Bench_NowNs();
+        Mem_BeginFrame();
+
+        int ticks = FixedTimestep_Advance(&timestep, 1.0f / 60.0f);
+        for (int i = 0; i < ticks; i++) {
+            ECS_BeginTick(world);
+            Scheduler_Run(&scheduler, world, timestep.step);
+        }
+        ECS_SetInterpolation(world, FixedTimestep_GetAlpha(&timestep));
+        double updateEnd = Bench_NowNs();
+
+        Bench_OrbitCamera(camera, radius, (float)frame / 60.0f);
+        RenderBatch_ResetStats();
+        Frustum frustum = Culling_FrustumFromCamera(&camera->camera, SCREEN_ASPECT, 0.01f, 1000.0f);
+        StaticBVH_Sync(&g_staticBVH, world);
+        System_Render(world, &frustum, &g_staticBVH);
+        double frameEnd = Bench_NowNs();
+
+        samples[PHASE_UPDATE][frame] = updateEnd - frameStart;
+        samples[PHASE_RENDER][frame] = frameEnd - updateEnd;
+        samples[PHASE_FRAME][frame] = frameEnd - frameStart;
+        visible += RenderBatch_GetStats()->visible;
+        culled += RenderBatch_GetStats()->culled;
+    }
+
+    printf("stress     %d entities, seed %u: spawned in %.2f ms, %d frames, %.0f visible / %.0f culled per frame\n",
+           entities, seed, spawnNs * 1e-6, frames, (double)visible / frames, (double)culled / frames);
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        qsort(samples[p], (size_t)frames, sizeof(double), Bench_CompareDouble);
+        printf("%-10s %8d  p50 %8.3f  p90 %8.3f  p99 %8.3f  max %8.3f ms\n", g_phaseNames[p], entities,
+               Bench_Percentile(samples[p], frames, 50.0) * 1e-6, Bench_Percentile(samples[p], frames, 90.0) * 1e-6,
+               Bench_Percentile(samples[p], frames, 99.0) * 1e-6, samples[p][frames - 1] * 1e-6);
+        free(samples[p]);
+    }
+
+    Scheduler_Shutdown(&scheduler);
+    StaticBVH_Release(&g_staticBVH);
+    ECS_Cleanup(world);
+}
+
+int main(int argc, char** argv) {
+    Mem_Init();
+
+    if (argc > 1) {
+        int entities = atoi(argv[1]);
+        int frames = argc > 2 ? atoi(argv[2]) : DEFAULT_FRAMES;
+        unsigned int seed = argc > 3 ? (unsigned int)strtoul(argv[3], NULL, 10) : 1u;
+        if (entities <= 0 || frames <= 0) {
+            fprintf(stderr, "usage: %s [entities [frames [seed]]]\n", argv[0]);
+            return 2;
+        }
+        Bench_Run(entities, frames, seed);
+    } else {
+        const int counts[] = {1000, 10000, 50000};
+        for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+            Bench_Run(counts[i], DEFAULT_FRAMES, 1u);
+        }
+    }
+
+    MeshCache_Shutdown();
+    RenderQueue_Shutdown();
+    RenderBatch_Shutdown();
+    Mem_Shutdown();
+    return 0;
+}
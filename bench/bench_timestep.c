@@ -0,0 +1,129 @@
+// Fixed-timestep clock and render interpolation.
+//   clock  - replays 10 s of uneven frame times (jittered 60 Hz, a 30 Hz
+//            stretch, one 0.5 s hitch) and reports ticks per frame; the
+//            simulated time must equal wall time minus the dropped ticks
+//   render - System_Render over 10k cubes with 1000 moved each tick, drawn
+//            at the latest tick and halfway between the last two; a cube
+//            moved in the latest tick must keep both states or the run fails
+#include "bench_common.h"
+#include "ecs.h"
+#include "timestep.h"
+#include "render_batch.h"
+#include "render_queue.h"
+#include "mesh_cache.h"
+#include <math.h>
+
+volatile float g_benchSink;
+
+#define CUBE_COUNT 10000
+#define MOVED_PER_TICK 1000
+#define RENDER_ROUNDS 50
+
+static ECSWorld g_world;
+static EntityID g_ids[CUBE_COUNT];
+static BenchRng g_rng = {777u};
+
+static float Bench_Jitter(void) {
+    return Bench_RandRange(&g_rng, 1.0f) - 0.5f;
+}
+
+static void Bench_Clock(void) {
+    FixedTimestep timestep;
+    FixedTimestep_Init(&timestep, TIMESTEP_DEFAULT_RATE, TIMESTEP_DEFAULT_MAX_STEPS);
+
+    double wall = 0.0;
+    long ticks = 0;
+    int frames = 0;
+    int minTicks = 1 << 30;
+    int maxTicks = 0;
+    while (wall < 10.0) {
+        float frameTime = 1.0f / 60.0f + Bench_Jitter() * 0.004f;
+        if (wall > 4.0 && wall < 6.0) frameTime = 1.0f / 30.0f;
+        if (frames == 400) frameTime = 0.5f;
+
+        int steps = FixedTimestep_Advance(&timestep, frameTime);
+        if (steps < minTicks) minTicks = steps;
+        if (steps > maxTicks) maxTicks = steps;
+        ticks += steps;
+        wall += frameTime;
+        frames++;
+    }
+
+    double simulated = (double)ticks * timestep.step;
+    double dropped = (double)timestep.droppedSteps * timestep.step;
+    double drift = wall - simulated - dropped - timestep.accumulator;
+    printf("clock      %d frames, %ld ticks (%d-%d per frame), %u dropped\n", frames, ticks, minTicks, maxTicks,
+           timestep.droppedSteps);
+    printf("clock      wall %.4f s, simulated %.4f s, dropped %.4f s, drift %.2e s\n", wall, simulated, dropped,
+           drift);
+}
+
+static void Bench_BuildWorld(ECSWorld* world) {
+    ECS_InitWithCapacity(world, CUBE_COUNT);
+    for (int i = 0; i < CUBE_COUNT; i++) {
+        g_ids[i] = ECS_CreateEntity(world);
+        TransformComponent* transform = (TransformComponent*)ECS_AddComponent(world, g_ids[i], COMPONENT_TRANSFORM);
+        RenderableComponent* renderable = (RenderableComponent*)ECS_AddComponent(world, g_ids[i], COMPONENT_RENDERABLE);
+        transform->position = (Vector3){(float)(i % 100) - 50.0f, 0.5f, (float)(i / 100) - 50.0f};
+        renderable->color = (Color){(unsigned char)(i % 200), 100, 150, 255};
+    }
+    System_UpdateTransforms(world);
+}
+
+// One simulation tick moving MOVED_PER_TICK cubes
+static void Bench_Tick(ECSWorld* world, int tick) {
+    ECS_BeginTick(world);
+    for (int i = 0; i < MOVED_PER_TICK; i++) {
+        EntityID id = g_ids[(tick * MOVED_PER_TICK + i * 7) % CUBE_COUNT];
+        TransformComponent* transform = (TransformComponent*)ECS_GetComponent(world, id, COMPONENT_TRANSFORM);
+        transform->position.y += 0.1f;
+        ECS_MarkTransformDirty(world, id);
+    }
+    System_UpdateTransforms(world);
+}
+
+static void Bench_Render(ECSWorld* world, const char* label, float alpha) {
+    double total = 0.0;
+    for (int round = 0; round < RENDER_ROUNDS; round++) {
+        Mem_BeginFrame();
+        Bench_Tick(world, round);
+        ECS_SetInterpolation(world, alpha);
+
+        double start = Bench_NowNs();
+        System_Render(world, NULL, NULL);
+        total += Bench_NowNs() - start;
+    }
+    Bench_Report(label, "render", CUBE_COUNT, total, RENDER_ROUNDS);
+}
+
+// A cube moved in the latest tick must sit halfway between its two states
+static bool Bench_CheckHalfway(ECSWorld* world) {
+    Bench_Tick(world, 0);
+    EntityID id = g_ids[0];
+    const TransformComponent* transform = (const TransformComponent*)ECS_GetComponent(world, id, COMPONENT_TRANSFORM);
+    float from = transform->previous.m13;
+    float to = transform->world.m13;
+    bool matches = transform->worldTick == world->tick && fabsf(to - from - 0.1f) < 1e-5f;
+    printf("halfway    previous y %.2f, current y %.2f, tick %u matches %s\n", (double)from, (double)to,
+           transform->worldTick, matches ? "yes" : "no");
+    g_benchSink = from + (to - from) * 0.5f;
+    return matches;
+}
+
+int main(void) {
+    Mem_Init();
+    Bench_Clock();
+
+    ECSWorld* world = &g_world;
+    Bench_BuildWorld(world);
+    Bench_Render(world, "latest", 1.0f);
+    Bench_Render(world, "halfway", 0.5f);
+    bool matches = Bench_CheckHalfway(world);
+
+    MeshCache_Shutdown();
+    RenderQueue_Shutdown();
+    RenderBatch_Shutdown();
+    ECS_Cleanup(world);
+    Mem_Shutdown();
+    return !matches;
+}
@@ -0,0 +1,67 @@
+// Cost of System_UpdateTransforms per frame as the number of changed
+// transforms varies, in worlds of 10k and 100k entities. Only the update is
+// timed; the edits themselves (write + ECS_MarkTransformDirty) are not.
+// With dirty tracking the cost should follow `changed`, not `entities`.
+#include "bench_common.h"
+#include "ecs.h"
+
+volatile float g_benchSink;
+
+#define UPDATE_ROUNDS 50
+
+static ECSWorld g_world;
+
+static EntityID* Bench_BuildWorld(ECSWorld* world, int count) {
+    EntityID* ids = (EntityID*)Mem_Alloc(MEM_SUBSYSTEM_ECS, sizeof(EntityID) * (size_t)count);
+    ECS_InitWithCapacity(world, count);
+    for (int i = 0; i < count; i++) {
+        ids[i] = ECS_CreateEntity(world);
+        TransformComponent* transform = (TransformComponent*)ECS_AddComponent(world, ids[i], COMPONENT_TRANSFORM);
+        transform->position = (Vector3){(float)(i % 100), 0.0f, (float)(i / 100)};
+        // Half the entities are rotated, so both matrix paths are exercised
+        if (i & 1) transform->rotation = (Vector3){0.1f, 0.01f * (float)i, 0.0f};
+    }
+    System_UpdateTransforms(world);
+    return ids;
+}
+
+static void Bench_Updates(int entities, int changed) {
+    ECSWorld* world = &g_world;
+    EntityID* ids = Bench_BuildWorld(world, entities);
+
+    // Spread the edits across the world so they do not share cache lines
+    int stride = changed > 0 ? entities / changed : 1;
+    double total = 0.0;
+    for (int round = 0; round < UPDATE_ROUNDS; round++) {
+        for (int i = 0; i < changed; i++) {
+            EntityID id = ids[(i * stride + round) % entities];
+            TransformComponent* transform = (TransformComponent*)ECS_GetComponent(world, id, COMPONENT_TRANSFORM);
+            transform->position.y += 0.01f;
+            ECS_MarkTransformDirty(world, id);
+        }
+
+        double start = Bench_NowNs();
+        System_UpdateTransforms(world);
+        total += Bench_NowNs() - start;
+    }
+
+    char label[16];
+    snprintf(label, sizeof(label), "%d", changed);
+    Bench_Report(label, "update", entities, total, UPDATE_ROUNDS);
+
+    TransformComponent* sample = (TransformComponent*)ECS_GetComponent(world, ids[0], COMPONENT_TRANSFORM);
+    g_benchSink = sample->world.m13;
+    ECS_Cleanup(world);
+    Mem_Free(MEM_SUBSYSTEM_ECS, ids, sizeof(EntityID) * (size_t)entities);
+}
+
+int main(void) {
+    static const int changed[] = {0, 10, 100, 1000, 10000};
+    for (int i = 0; i < 5; i++) {
+        Bench_Updates(10000, changed[i]);
+        Bench_Updates(100000, changed[i]);
+    }
+    // Every transform changed: the cost of recomputing all matrices each frame
+    Bench_Updates(100000, 100000);
+    return 0;
+}
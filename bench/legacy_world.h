@@ -0,0 +1,112 @@
+#ifndef LEGACY_WORLD_H
+#define LEGACY_WORLD_H
+
+// The original ECS storage layout: a flat Entity array where every component
+// is its own malloc'd block referenced from Entity.components[]. Kept as the
+// comparison baseline for the storage benchmarks.
+#include "ecs.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    bool active;
+    unsigned int componentMask;
+    void* components[COMPONENT_COUNT];
+} LegacyEntity;
+
+typedef struct {
+    LegacyEntity* entities;
+    int capacity;
+    int entityCount;
+} LegacyWorld;
+
+static inline void Legacy_Init(LegacyWorld* world, int capacity) {
+    world->entities = (LegacyEntity*)calloc((size_t)capacity, sizeof(LegacyEntity));
+    world->capacity = capacity;
+    world->entityCount = 0;
+}
+
+static inline EntityID Legacy_CreateEntity(LegacyWorld* world) {
+    if (world->entityCount >= world->capacity) return -1;
+    for (int i = 0; i < world->capacity; i++) {
+        if (!world->entities[i].active) {
+            world->entities[i].active = true;
+            world->entities[i].componentMask = 0;
+            memset(world->entities[i].components, 0, sizeof(void*) * COMPONENT_COUNT);
+            world->entityCount++;
+            return i;
+        }
+    }
+    return -1;
+}
+
+static inline void* Legacy_AddComponent(LegacyWorld* world, EntityID id, ComponentType type) {
+    LegacyEntity* entity = &world->entities[id];
+    if (entity->components[type] != NULL) return entity->components[type];
+
+    void* component = NULL;
+    if (type == COMPONENT_TRANSFORM) {
+        TransformComponent* transform = (TransformComponent*)malloc(sizeof(TransformComponent));
+        if (!transform) return NULL;
+        transform->position = (Vector3){0, 0, 0};
+        transform->rotation = (Vector3){0, 0, 0};
+        transform->scale = (Vector3){1, 1, 1};
+        component = transform;
+    } else if (type == COMPONENT_RENDERABLE) {
+        RenderableComponent* renderable = (RenderableComponent*)malloc(sizeof(RenderableComponent));
+        if (!renderable) return NULL;
+        renderable->type = RENDERABLE_CUBE;
+        renderable->color = WHITE;
+        renderable->size = (Vector3){1, 1, 1};
+        component = renderable;
+    } else if (type == COMPONENT_INPUT) {
+        InputComponent* input = (InputComponent*)malloc(sizeof(InputComponent));
+        if (!input) return NULL;
+        input->active = true;
+        component = input;
+    } else {
+        return NULL;
+    }
+
+    entity->components[type] = component;
+    entity->componentMask |= (1 << type);
+    return component;
+}
+
+static inline void* Legacy_GetComponent(LegacyWorld* world, EntityID id, ComponentType type) {
+    if (id < 0 || id >= world->capacity || !world->entities[id].active) return NULL;
+    return world->entities[id].components[type];
+}
+
+static inline bool Legacy_HasComponent(LegacyWorld* world, EntityID id, ComponentType type) {
+    if (id < 0 || id >= world->capacity || !world->entities[id].active) return false;
+    return (world->entities[id].componentMask & (1 << type)) != 0;
+}
+
+static inline void Legacy_DestroyEntity(LegacyWorld* world, EntityID id) {
+    LegacyEntity* entity = &world->entities[id];
+    for (int i = 0; i < COMPONENT_COUNT; i++) {
+        free(entity->components[i]);
+        entity->components[i] = NULL;
+    }
+    entity->active = false;
+    entity->componentMask = 0;
+    world->entityCount--;
+}
+
+static inline void Legacy_Render(LegacyWorld* world) {
+    for (int i = 0; i < world->capacity; i++) {
+        if (!world->entities[i].active) continue;
+        if (Legacy_HasComponent(world, i, COMPONENT_TRANSFORM) &&
+            Legacy_HasComponent(world, i, COMPONENT_RENDERABLE)) {
+            TransformComponent* transform = (TransformComponent*)Legacy_GetComponent(world, i, COMPONENT_TRANSFORM);
+            RenderableComponent* renderable = (RenderableComponent*)Legacy_GetComponent(world, i, COMPONENT_RENDERABLE);
+            if (transform && renderable) {
+                DrawCube(transform->position, renderable->size.x, renderable->size.y, renderable->size.z, renderable->color);
+                DrawCubeWires(transform->position, renderable->size.x, renderable->size.y, renderable->size.z, BLACK);
+            }
+        }
+    }
+}
+
+#endif // LEGACY_WORLD_H
@@ -0,0 +1,93 @@
+// Host stand-in for raylib.h used by the benchmark builds.
+// Only the types and entry points the ECS core touches are provided; the
+// drawing functions are no-ops defined in raylib_stub.c.
+#ifndef RAYLIB_H
+#define RAYLIB_H
+
+#include <stdbool.h>
+
+#define CLITERAL(type) (type)
+
+#ifndef PI
+#define PI 3.14159265358979323846f
+#endif
+#ifndef DEG2RAD
+#define DEG2RAD (PI / 180.0f)
+#endif
+
+typedef struct Vector2 {
+    float x;
+    float y;
+} Vector2;
+
+typedef struct Vector3 {
+    float x;
+    float y;
+    float z;
+} Vector3;
+
+typedef struct Vector4 {
+    float x;
+    float y;
+    float z;
+    float w;
+} Vector4;
+
+typedef struct Matrix {
+    float m0, m4, m8, m12;
+    float m1, m5, m9, m13;
+    float m2, m6, m10, m14;
+    float m3, m7, m11, m15;
+} Matrix;
+
+typedef struct Color {
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+} Color;
+
+typedef struct Camera3D {
+    Vector3 position;
+    Vector3 target;
+    Vector3 up;
+    float fovy;
+    int projection;
+} Camera3D;
+
+typedef Camera3D Camera;
+
+typedef struct Ray {
+    Vector3 position;
+    Vector3 direction;
+} Ray;
+
+typedef enum {
+    CAMERA_PERSPECTIVE = 0,
+    CAMERA_ORTHOGRAPHIC
+} CameraProjection;
+
+#define LIGHTGRAY  CLITERAL(Color){ 200, 200, 200, 255 }
+#define GRAY       CLITERAL(Color){ 130, 130, 130, 255 }
+#define YELLOW     CLITERAL(Color){ 253, 249, 0, 255 }
+#define RED        CLITERAL(Color){ 230, 41, 55, 255 }
+#define GREEN      CLITERAL(Color){ 0, 228, 48, 255 }
+#define BLUE       CLITERAL(Color){ 0, 121, 241, 255 }
+#define SKYBLUE    CLITERAL(Color){ 102, 191, 255, 255 }
+#define WHITE      CLITERAL(Color){ 255, 255, 255, 255 }
+#define BLACK      CLITERAL(Color){ 0, 0, 0, 255 }
+
+void DrawLine3D(Vector3 startPos, Vector3 endPos, Color color);
+void DrawCube(Vector3 position, float width, float height, float length, Color color);
+void DrawCubeWires(Vector3 position, float width, float height, float length, Color color);
+void DrawSphereEx(Vector3 centerPos, float radius, int rings, int slices, Color color);
+void DrawPlane(Vector3 centerPos, Vector2 size, Color color);
+void DrawGrid(int slices, float spacing);
+void BeginMode3D(Camera3D camera);
+void EndMode3D(void);
+float GetFrameTime(void);
+double GetTime(void);
+int GetScreenWidth(void);
+int GetScreenHeight(void);
+
+#endif // RAYLIB_H
@@ -0,0 +1,114 @@
+#include "raylib.h"
+#include "rlgl.h"
+#include <time.h>
+
+// Submission counters so benchmarks can see how much work reached the
+// render layer without a GPU behind it. Draw calls follow rlgl's batching
+// rules: consecutive rlBegin()s with the same primitive mode share a draw,
+// and a full batch flushes (ending the current draw).
+#define STUB_BATCH_VERTICES (8192 * 4)
+
+unsigned long g_stubDrawCalls = 0;
+unsigned long g_stubVertexCalls = 0;
+
+static int g_stubMode = -1;
+static int g_stubBatchVertices = 0;
+
+static void Stub_Flush(void) {
+    g_stubMode = -1;
+    g_stubBatchVertices = 0;
+}
+
+bool rlCheckRenderBatchLimit(int vCount) {
+    if (g_stubBatchVertices + vCount >= STUB_BATCH_VERTICES) {
+        Stub_Flush();
+        return true;
+    }
+    return false;
+}
+
+void rlBegin(int mode) {
+    if (mode != g_stubMode) {
+        g_stubDrawCalls++;
+        g_stubMode = mode;
+    }
+}
+
+void rlEnd(void) {}
+
+// Vertices land in a buffer like rlgl's, so submission has a realistic cost.
+// Kept out of line: raylib's shape functions call rlVertex3f across
+// translation units, just like the batch renderer does.
+static float g_stubVertices[STUB_BATCH_VERTICES * 3];
+
+__attribute__((noinline)) void rlVertex3f(float x, float y, float z) {
+    if (g_stubBatchVertices >= STUB_BATCH_VERTICES) Stub_Flush();
+    float* vertex = &g_stubVertices[g_stubBatchVertices * 3];
+    vertex[0] = x;
+    vertex[1] = y;
+    vertex[2] = z;
+    g_stubVertexCalls++;
+    g_stubBatchVertices++;
+}
+
+// Shape helpers submit as many vertices as raylib's versions, through the
+// same rlVertex3f path, so immediate and batched drawing cost the same per vertex
+static void Stub_Shape(int mode, int vertices) {
+    rlCheckRenderBatchLimit(vertices);
+    rlBegin(mode);
+    for (int i = 0; i < vertices; i++) rlVertex3f((float)i, 0.0f, 0.0f);
+    rlEnd();
+}
+
+void DrawCube(Vector3 position, float width, float height, float length, Color color) {
+    (void)position; (void)width; (void)height; (void)length; (void)color;
+    Stub_Shape(RL_TRIANGLES, 36);
+}
+
+void DrawCubeWires(Vector3 position, float width, float height, float length, Color color) {
+    (void)position; (void)width; (void)height; (void)length; (void)color;
+    Stub_Shape(RL_LINES, 24);
+}
+
+void DrawLine3D(Vector3 startPos, Vector3 endPos, Color color) {
+    (void)startPos; (void)endPos; (void)color;
+    Stub_Shape(RL_LINES, 2);
+}
+
+void DrawSphereEx(Vector3 centerPos, float radius, int rings, int slices, Color color) {
+    (void)centerPos; (void)radius; (void)color;
+    Stub_Shape(RL_TRIANGLES, (rings + 2) * slices * 6);
+}
+
+void DrawPlane(Vector3 centerPos, Vector2 size, Color color) {
+    (void)centerPos; (void)size; (void)color;
+    Stub_Shape(RL_QUADS, 4);
+}
+
+void DrawGrid(int slices, float spacing) {
+    (void)spacing;
+    Stub_Shape(RL_LINES, (slices + 1) * 4);
+}
+
+void BeginMode3D(Camera3D camera) { (void)camera; }
+void EndMode3D(void) {}
+
+float GetFrameTime(void) { return 1.0f / 60.0f; }
+
+double GetTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int GetScreenWidth(void) { return 480; }
+int GetScreenHeight(void) { return 272; }
+
+void rlColor4ub(unsigned char r, unsigned char g, unsigned char b, unsigned char a) {
+    (void)r; (void)g; (void)b; (void)a;
+}
+void rlPushMatrix(void) {}
+void rlPopMatrix(void) {}
+void rlTranslatef(float x, float y, float z) { (void)x; (void)y; (void)z; }
+void rlMultMatrixf(const float* matf) { (void)matf; }
+void rlSetClipPlanes(double nearPlane, double farPlane) { (void)nearPlane; (void)farPlane; }
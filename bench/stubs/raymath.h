@@ -0,0 +1,59 @@
+// Host stand-in for raymath.h used by the benchmark builds.
+// Only the functions the batch math kernels are checked against, written
+// with raymath's operation order so results compare exactly.
+#ifndef RAYMATH_H
+#define RAYMATH_H
+
+#include "raylib.h"
+#include <math.h>
+
+static inline Vector3 Vector3Add(Vector3 v1, Vector3 v2) {
+    return (Vector3){v1.x + v2.x, v1.y + v2.y, v1.z + v2.z};
+}
+
+static inline Vector3 Vector3Scale(Vector3 v, float scalar) {
+    return (Vector3){v.x * scalar, v.y * scalar, v.z * scalar};
+}
+
+static inline Vector3 Vector3Normalize(Vector3 v) {
+    Vector3 result = v;
+    float length = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+    if (length != 0.0f) {
+        float ilength = 1.0f / length;
+        result.x *= ilength;
+        result.y *= ilength;
+        result.z *= ilength;
+    }
+    return result;
+}
+
+static inline Vector3 Vector3Transform(Vector3 v, Matrix mat) {
+    Vector3 result;
+    result.x = mat.m0 * v.x + mat.m4 * v.y + mat.m8 * v.z + mat.m12;
+    result.y = mat.m1 * v.x + mat.m5 * v.y + mat.m9 * v.z + mat.m13;
+    result.z = mat.m2 * v.x + mat.m6 * v.y + mat.m10 * v.z + mat.m14;
+    return result;
+}
+
+static inline Matrix MatrixMultiply(Matrix left, Matrix right) {
+    Matrix result;
+    result.m0 = left.m0 * right.m0 + left.m1 * right.m4 + left.m2 * right.m8 + left.m3 * right.m12;
+    result.m1 = left.m0 * right.m1 + left.m1 * right.m5 + left.m2 * right.m9 + left.m3 * right.m13;
+    result.m2 = left.m0 * right.m2 + left.m1 * right.m6 + left.m2 * right.m10 + left.m3 * right.m14;
+    result.m3 = left.m0 * right.m3 + left.m1 * right.m7 + left.m2 * right.m11 + left.m3 * right.m15;
+    result.m4 = left.m4 * right.m0 + left.m5 * right.m4 + left.m6 * right.m8 + left.m7 * right.m12;
+    result.m5 = left.m4 * right.m1 + left.m5 * right.m5 + left.m6 * right.m9 + left.m7 * right.m13;
+    result.m6 = left.m4 * right.m2 + left.m5 * right.m6 + left.m6 * right.m10 + left.m7 * right.m14;
+    result.m7 = left.m4 * right.m3 + left.m5 * right.m7 + left.m6 * right.m11 + left.m7 * right.m15;
+    result.m8 = left.m8 * right.m0 + left.m9 * right.m4 + left.m10 * right.m8 + left.m11 * right.m12;
+    result.m9 = left.m8 * right.m1 + left.m9 * right.m5 + left.m10 * right.m9 + left.m11 * right.m13;
+    result.m10 = left.m8 * right.m2 + left.m9 * right.m6 + left.m10 * right.m10 + left.m11 * right.m14;
+    result.m11 = left.m8 * right.m3 + left.m9 * right.m7 + left.m10 * right.m11 + left.m11 * right.m15;
+    result.m12 = left.m12 * right.m0 + left.m13 * right.m4 + left.m14 * right.m8 + left.m15 * right.m12;
+    result.m13 = left.m12 * right.m1 + left.m13 * right.m5 + left.m14 * right.m9 + left.m15 * right.m13;
+    result.m14 = left.m12 * right.m2 + left.m13 * right.m6 + left.m14 * right.m10 + left.m15 * right.m14;
+    result.m15 = left.m12 * right.m3 + left.m13 * right.m7 + left.m14 * right.m11 + left.m15 * right.m15;
+    return result;
+}
+
+#endif // RAYMATH_H
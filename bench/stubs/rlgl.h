@@ -0,0 +1,26 @@
+// Host stand-in for rlgl.h used by the benchmark builds.
+#ifndef RLGL_H
+#define RLGL_H
+
+#include <stdbool.h>
+
+#define RL_LINES      0x0001
+#define RL_TRIANGLES  0x0004
+#define RL_QUADS      0x0007
+
+void rlBegin(int mode);
+void rlEnd(void);
+void rlColor4ub(unsigned char r, unsigned char g, unsigned char b, unsigned char a);
+void rlVertex3f(float x, float y, float z);
+void rlPushMatrix(void);
+void rlPopMatrix(void);
+void rlTranslatef(float x, float y, float z);
+void rlMultMatrixf(const float* matf);
+bool rlCheckRenderBatchLimit(int vCount);
+void rlSetClipPlanes(double nearPlane, double farPlane);
+
+// Host-only: what the stub render layer has been asked to draw
+extern unsigned long g_stubDrawCalls;
+extern unsigned long g_stubVertexCalls;
+
+#endif // RLGL_H
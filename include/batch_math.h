@@ -0,0 +1,43 @@
+#ifndef BATCH_MATH_H
+#define BATCH_MATH_H
+
+#include <raylib.h>
+
+// Vector math over many elements at once. Vectors are passed as separate
+// x/y/z arrays (structure of arrays) so four elements fill one SIMD
+// register; matrices are plain Matrix arrays. Each kernel matches the
+// raymath function named beside it, element by element.
+//
+// The vector path is chosen at compile time: SSE on x86 hosts, NEON on
+// AArch64, the VFPU on the PSP (the calling thread needs THREAD_ATTR_VFPU,
+// which main.c sets). Define BATCH_MATH_SIMD=0 to force plain C everywhere.
+// The VFPU loads 16 bytes at a time and only runs when every array passed
+// is 16-byte aligned; other calls take the plain C loop.
+#ifndef BATCH_MATH_SIMD
+#define BATCH_MATH_SIMD 1
+#endif
+
+typedef struct {
+    float* x;
+    float* y;
+    float* z;
+} Vector3Array;
+
+// out[i] = a[i] + b[i] * scale (Vector3Add(a, Vector3Scale(b, scale))),
+// e.g. positions advanced by velocities over a timestep. out may be a.
+void BatchMath_AddScaled(Vector3Array out, Vector3Array a, Vector3Array b, float scale, int count);
+
+// out[i] = Vector3Transform(in[i], *m). out may be in.
+void BatchMath_Transform(Vector3Array out, Vector3Array in, const Matrix* m, int count);
+
+// v[i] = Vector3Normalize(v[i]); zero-length vectors are left unchanged
+void BatchMath_Normalize(Vector3Array v, int count);
+
+// out[i] = MatrixMultiply(left[i], right[i]): left[i] applied first, so
+// (local, parent) yields a child's world matrix. out may alias either input.
+void BatchMath_MultiplyMatrices(Matrix* out, const Matrix* left, const Matrix* right, int count);
+
+// "scalar", "sse", "neon" or "vfpu"
+const char* BatchMath_GetPathName(void);
+
+#endif // BATCH_MATH_H
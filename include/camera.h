@@ -7,4 +7,12 @@
 // Camera control functions
 void Camera_UpdateControls(CameraComponent* camera, KeyBindingSystem* keybinds, float deltaTime);
 
+// Saves the camera as the state rendering interpolates from; call before
+// the tick moves it. Only the first call per tick counts.
+void Camera_BeginTick(CameraComponent* camera, const ECSWorld* world);
+
+// Camera to draw with: between `previous` and `camera` by the world's
+// interpolation factor if it moved in the latest tick, `camera` otherwise
+Camera3D Camera_GetRenderCamera(const CameraComponent* camera, const ECSWorld* world);
+
 #endif // CAMERA_H
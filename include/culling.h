@@ -0,0 +1,38 @@
+#ifndef CULLING_H
+#define CULLING_H
+
+#include <raylib.h>
+#include <stdbool.h>
+
+// Frustum planes: xyz is the inward-facing unit normal, w the offset, so a
+// point p is inside a plane when dot(xyz, p) + w >= 0.
+typedef enum {
+    FRUSTUM_NEAR,
+    FRUSTUM_FAR,
+    FRUSTUM_LEFT,
+    FRUSTUM_RIGHT,
+    FRUSTUM_TOP,
+    FRUSTUM_BOTTOM,
+    FRUSTUM_PLANE_COUNT
+} FrustumPlane;
+
+typedef struct {
+    Vector4 planes[FRUSTUM_PLANE_COUNT];
+    float screenScale;      // Viewport heights per world unit, at unit view depth when perspective
+    float nearDistance;     // Eye to near plane
+    bool orthographic;
+} Frustum;
+
+// Builds the view frustum of a perspective or orthographic Camera3D.
+// aspect is viewport width / height; nearPlane/farPlane match rlSetClipPlanes.
+Frustum Culling_FrustumFromCamera(const Camera3D* camera, float aspect, float nearPlane, float farPlane);
+
+// Conservative box test: false only when the box lies fully outside a plane
+bool Culling_TestAABB(const Frustum* frustum, Vector3 center, Vector3 halfExtents);
+
+// Projected diameter of a sphere as a fraction of the viewport height (1.0
+// fills it), for picking a level of detail. Spheres reaching the eye plane
+// report FLT_MAX.
+float Culling_ScreenSize(const Frustum* frustum, Vector3 center, float radius);
+
+#endif // CULLING_H
@@ -3,11 +3,51 @@
 
 #include <raylib.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include "mem.h"
+#include "culling.h"
 
-// Maximum entities and components
+// Default entity capacity used by ECS_Init (the handheld budget)
+#ifndef MAX_ENTITIES
 #define MAX_ENTITIES 256
+#endif
+
+// World storage grows in pages of ECS_PAGE_SIZE entity slots / components.
+// Pages are never moved once allocated, so growing the world does not
+// invalidate component pointers.
+#ifndef ECS_PAGE_SHIFT
+#define ECS_PAGE_SHIFT 8
+#endif
+#define ECS_PAGE_SIZE (1 << ECS_PAGE_SHIFT)
+#define ECS_PAGE(index) ((index) >> ECS_PAGE_SHIFT)
+#define ECS_PAGE_OFFSET(index) ((index) & (ECS_PAGE_SIZE - 1))
+
+// Page table length: the hard ceiling for ECS_InitWithCapacity. The PSP
+// keeps it at the default budget; host builds can reach 128k entities.
+#ifndef ECS_MAX_PAGES
+#if defined(__PSP__)
+#define ECS_MAX_PAGES ((MAX_ENTITIES + ECS_PAGE_SIZE - 1) / ECS_PAGE_SIZE)
+#else
+#define ECS_MAX_PAGES 512
+#endif
+#endif
+#define ECS_MAX_CAPACITY (ECS_MAX_PAGES * ECS_PAGE_SIZE)
+
 // MAX_COMPONENTS reserved for future expansion, currently using COMPONENT_COUNT
 #define MAX_COMPONENTS 8
+// Distinct cached queries a world can hold
+#define ECS_MAX_QUERIES 8
+
+// Component storage layout, chosen at compile time:
+//   0 - one sparse set per component type (default)
+//   1 - archetype chunks: entities with the same componentMask share
+//       fixed-size chunks holding one column per component (SoA)
+#ifndef ECS_ARCHETYPE_STORAGE
+#define ECS_ARCHETYPE_STORAGE 0
+#endif
+
+// Bytes per archetype chunk
+#define ECS_CHUNK_SIZE (16 * 1024)
 
 // Component type IDs
 typedef enum {
@@ -15,17 +55,47 @@ typedef enum {
     COMPONENT_RENDERABLE = 1,
     COMPONENT_CAMERA = 2,
     COMPONENT_INPUT = 3,
+    COMPONENT_STATIC = 4,
+    COMPONENT_HIERARCHY = 5,
     COMPONENT_COUNT
 } ComponentType;
 
+#define COMPONENT_BIT(type) (1u << (type))
+
+// One archetype per possible componentMask
+#define ECS_ARCHETYPE_COUNT (1 << COMPONENT_COUNT)
+
 // Entity ID type
+// Low bits hold the slot index, the bits above hold the slot's generation,
+// which is bumped on every destroy so stale IDs stop resolving.
 typedef int EntityID;
 
-// Transform Component
+#define ECS_INVALID_ENTITY -1
+#define ECS_ENTITY_INDEX_BITS 20
+#define ECS_ENTITY_INDEX_MASK ((1 << ECS_ENTITY_INDEX_BITS) - 1)
+#define ECS_ENTITY_GENERATION_MASK 0x7FF
+#define ECS_ENTITY_INDEX(id) ((int)((id) & ECS_ENTITY_INDEX_MASK))
+#define ECS_ENTITY_GENERATION(id) ((int)(((id) >> ECS_ENTITY_INDEX_BITS) & ECS_ENTITY_GENERATION_MASK))
+#define ECS_MAKE_ENTITY(index, generation) \
+    ((EntityID)((((generation) & ECS_ENTITY_GENERATION_MASK) << ECS_ENTITY_INDEX_BITS) | (index)))
+
+#if MAX_ENTITIES > ECS_MAX_CAPACITY
+#error "MAX_ENTITIES exceeds ECS_MAX_PAGES * ECS_PAGE_SIZE"
+#endif
+#if ECS_MAX_CAPACITY > (1 << ECS_ENTITY_INDEX_BITS)
+#error "ECS_MAX_CAPACITY does not fit in ECS_ENTITY_INDEX_BITS"
+#endif
+
+// Transform Component. After changing position, rotation or scale, call
+// ECS_MarkTransformDirty so System_UpdateTransforms refreshes `world`.
 typedef struct {
     Vector3 position;
-    Vector3 rotation;
+    Vector3 rotation;   // Euler angles in radians, applied X, then Y, then Z
     Vector3 scale;
+    Matrix world;       // Cached scale, rotation, then translation
+    Matrix previous;    // `world` before the tick in worldTick, for render interpolation
+    unsigned int worldTick;     // Tick `world` last changed in; set to 0 to jump without interpolating
+    bool dirty;         // Queued for System_UpdateTransforms
 } TransformComponent;
 
 // Renderable Component
@@ -40,6 +110,7 @@ typedef struct {
     RenderableType type;
     Color color;
     Vector3 size;
+    int lod;        // Sphere level of detail last drawn, kept for hysteresis
 } RenderableComponent;
 
 // Camera Component
@@ -48,6 +119,8 @@ typedef struct {
     float moveSpeed;
     float lookSpeed;
     float pitch;  // Vertical angle for clamping
+    Camera3D previous;          // `camera` before the tick in previousTick, for render interpolation
+    unsigned int previousTick;
 } CameraComponent;
 
 // Input Component
@@ -55,30 +128,271 @@ typedef struct {
     bool active;
 } InputComponent;
 
+// Static Component
+// Tag for geometry that never moves once placed. Static renderables are
+// drawn through a StaticBVH instead of being tested one by one each frame;
+// move one only after removing the tag, or call StaticBVH_Invalidate.
+typedef struct {
+    unsigned char reserved;
+} StaticComponent;
+
+// Hierarchy Component
+// Links an entity to a parent, making its TransformComponent local to the
+// parent's. Managed by Hierarchy_SetParent (hierarchy.h); do not add it or
+// edit it directly.
+typedef struct {
+    EntityID parent;    // ECS_INVALID_ENTITY for a root
+    int slot;           // Index in the world's hierarchy node array
+} HierarchyComponent;
+
+// Hierarchy node: entities with a HierarchyComponent, kept sorted by depth
+// so every parent precedes its children
+typedef struct {
+    EntityID entity;    // ECS_INVALID_ENTITY once destroyed, until compacted
+    int parent;         // Node index of the parent, -1 for roots
+    int depth;
+    bool dirty;         // Own transform changed
+    bool changed;       // World matrix rebuilt in the current sweep
+} HierarchyNode;
+
+// Entity::changeFlags
+#define ECS_CHANGE_LISTED 1     // In world->changedSlots
+#define ECS_CHANGE_CREATED 2    // Created since the last ECS_ClearChanges
+
 // Entity structure
 typedef struct {
     bool active;
     unsigned int componentMask;
-    void* components[COMPONENT_COUNT];
+    unsigned short generation;
+    unsigned char changedMask;      // COMPONENT_BIT()s of components changed since the last ECS_ClearChanges
+    unsigned char changeFlags;      // ECS_CHANGE_*
+    int nextFree;                   // Next slot on the free list while inactive
+#if ECS_ARCHETYPE_STORAGE
+    int row;                        // Row in archetypes[componentMask], -1 without components
+#endif
 } Entity;
 
+#if ECS_ARCHETYPE_STORAGE
+// All entities sharing one componentMask. Rows are packed across chunks of
+// ECS_CHUNK_SIZE bytes: row r lives at r % chunkCapacity in chunk
+// r / chunkCapacity. Each chunk starts with an EntityID column followed by
+// one column per component in the mask.
+typedef struct {
+    unsigned int mask;
+    int chunkCapacity;                      // Rows per chunk
+    size_t columnOffsets[COMPONENT_COUNT];  // Byte offset of each component column
+    int count;                              // Live rows
+    int chunkCount;
+    int chunkSlots;                         // Allocated length of chunks[]
+    unsigned char** chunks;
+} Archetype;
+#endif
+
+// Sparse set for one component type.
+// sparse maps an entity to its slot in the packed arrays; dense maps a slot
+// back to its entity. Live components occupy slots [0, count), and removal
+// swaps the last component into the freed slot, so component pointers are
+// only valid until the next removal of the same type. All three arrays are
+// paged: element i lives at page ECS_PAGE(i), offset ECS_PAGE_OFFSET(i).
+typedef struct {
+    int count;
+    int densePages;                         // Pages allocated for dense/data
+    int* sparse[ECS_MAX_PAGES];             // Entity index -> dense slot, -1 if absent
+    EntityID* dense[ECS_MAX_PAGES];         // Dense slot -> owning entity
+    unsigned char* data[ECS_MAX_PAGES];     // Packed components
+} ComponentSet;
+
+// Cached query over every entity whose componentMask contains `required`
+// and none of `excluded`. With sparse sets, matches are kept packed like a ComponentSet and updated
+// incrementally as components are added/removed, so iterating costs
+// O(matches). With archetypes, the query holds the matching archetypes and
+// iterates their chunks directly. `version` changes whenever an entity
+// enters or leaves the query, so consumers can cache derived data.
+typedef struct {
+    unsigned int required;
+    unsigned int excluded;
+    unsigned int version;
+    int typeCount;
+    ComponentType types[COMPONENT_COUNT];   // Component types in `required`
+#if ECS_ARCHETYPE_STORAGE
+    int archetypeCount;
+    unsigned int archetypes[ECS_ARCHETYPE_COUNT];   // Masks of matching archetypes
+#else
+    int count;
+    int densePages;
+    bool stale;                     // An insert failed; refilled on the next ECS_GetQuery outside a run
+    int* sparse[ECS_MAX_PAGES];     // Entity index -> match slot, -1 if not matching
+    EntityID* dense[ECS_MAX_PAGES]; // Match slot -> entity
+#endif
+} ECSQuery;
+
 // ECS World
 typedef struct {
-    Entity entities[MAX_ENTITIES];
+    Entity* entityPages[ECS_MAX_PAGES];
+    int entityPageCount;
+    int capacity;                   // Entity slots this world may grow to
     int entityCount;
+    int freeHead;                   // Most recently destroyed slot, -1 if none
+    int unusedHead;                 // Slots [unusedHead, capacity) were never handed out
+
+    // Simulation tick, starting at 1 so a zero stamp never matches it, and
+    // how far rendering sits between the previous tick's state (0) and the
+    // current one (1)
+    unsigned int tick;
+    float interpolation;
+    int tickTransformCount;         // Transforms whose worldTick became `tick`: the most drawn blended
+
+#if ECS_ARCHETYPE_STORAGE
+    Archetype archetypes[ECS_ARCHETYPE_COUNT];
+#else
+    // Packed per-type component storage
+    ComponentSet sets[COMPONENT_COUNT];
+#endif
+
+    ECSQuery queries[ECS_MAX_QUERIES];
+    int queryCount;
+    bool runningSystems;            // Inside Scheduler_Run: queries may be looked up, not built
+
+    // Entities whose transforms changed since the last System_UpdateTransforms
+    EntityID* dirtyTransforms;
+    int dirtyTransformCount;
+    int dirtyTransformCapacity;
+    bool dirtyTransformOverflow;    // The list could not grow: rescan flags instead
+
+    // Entity slots changed since the last ECS_ClearChanges, each listed once,
+    // for incremental saves. ECS_ClearChanges sizes the list to the world's
+    // capacity, so marking never grows it and is safe from systems running
+    // in parallel. While changesLost is set (a new world, or the list could
+    // not be allocated) nothing is listed and the next save must be full.
+    int* changedSlots;
+    int changedSlotCount;
+    int changedSlotCapacity;
+    bool changesLost;
+
+    // Parented transforms, see hierarchy.h
+    HierarchyNode* hierarchyNodes;
+    int hierarchyCount;
+    int hierarchyCapacity;
+    bool hierarchyDirty;            // Some node needs its world matrix rebuilt
+    bool hierarchyCompact;          // Some node's entity was destroyed
+
+    // Fixed-block pools every storage page comes from (charged to MEM_SUBSYSTEM_ECS)
+    MemPool entityPool;
+#if ECS_ARCHETYPE_STORAGE
+    MemPool chunkPool;                      // Archetype chunks
+#else
+    MemPool indexPool;                      // Sparse/dense pages of sets and queries
+    MemPool dataPools[COMPONENT_COUNT];     // Component data pages, one block size per type
+#endif
 } ECSWorld;
 
+// Query iterator. After each successful ECS_QueryNext(), components[type]
+// points at the entity's component for every type in the query's mask.
+// Adding/removing components or destroying entities invalidates it.
+typedef struct {
+    ECSWorld* world;
+    const ECSQuery* query;
+    int cursor;
+    EntityID entity;
+    void* components[COMPONENT_COUNT];
+#if ECS_ARCHETYPE_STORAGE
+    int chunk;                              // Next chunk of the current archetype
+    int row;                                // Next row in the current chunk
+    int chunkRows;                          // Rows in the current chunk
+    const EntityID* entityColumn;
+    unsigned char* columns[COMPONENT_COUNT];
+#endif
+} ECSQueryIter;
+
 // ECS functions
-void ECS_Init(ECSWorld* world);
+void ECS_Init(ECSWorld* world);     // Capacity of MAX_ENTITIES
+void ECS_InitWithCapacity(ECSWorld* world, int capacity);
+int ECS_GetCapacity(ECSWorld* world);
 EntityID ECS_CreateEntity(ECSWorld* world);
 void ECS_DestroyEntity(ECSWorld* world, EntityID id);
 void* ECS_AddComponent(ECSWorld* world, EntityID id, ComponentType type);
 void* ECS_GetComponent(ECSWorld* world, EntityID id, ComponentType type);
 bool ECS_HasComponent(ECSWorld* world, EntityID id, ComponentType type);
+bool ECS_IsEntityValid(ECSWorld* world, EntityID id);
+unsigned int ECS_GetComponentMask(ECSWorld* world, EntityID id);
+size_t ECS_GetComponentSize(ComponentType type);
 void ECS_RemoveComponent(ECSWorld* world, EntityID id, ComponentType type);
 void ECS_Cleanup(ECSWorld* world);
 
+// Walk every live entity in slot order:
+//   for (EntityID id = ECS_FirstEntity(w); id != ECS_INVALID_ENTITY; id = ECS_NextEntity(w, id))
+EntityID ECS_FirstEntity(ECSWorld* world);
+EntityID ECS_NextEntity(ECSWorld* world, EntityID id);
+
+// Cached queries: ECS_GetQuery returns the world's query for a mask of
+// COMPONENT_BIT()s, building it on first use. NULL if all slots are taken.
+// ECS_GetQueryExcluding also skips entities having any of `excluded`.
+// Building one inside Scheduler_Run is an error (asserted): see scheduler.h.
+ECSQuery* ECS_GetQuery(ECSWorld* world, unsigned int required);
+ECSQuery* ECS_GetQueryExcluding(ECSWorld* world, unsigned int required, unsigned int excluded);
+ECSQueryIter ECS_QueryIter(ECSWorld* world, const ECSQuery* query);
+bool ECS_QueryNext(ECSQueryIter* iter);
+
+// Queues an entity's transform for recompute. Adding a TransformComponent
+// queues it already.
+void ECS_MarkTransformDirty(ECSWorld* world, EntityID id);
+
+// Change tracking for incremental saves. Creating and destroying entities,
+// adding and removing components and ECS_MarkTransformDirty are recorded
+// already; any other edit to a saved component must call ECS_MarkChanged.
+// Systems that do not conflict may mark changes at the same time.
+void ECS_MarkChanged(ECSWorld* world, EntityID id, ComponentType type);
+
+// One entry of world->changedSlots: the slot's entity, ECS_INVALID_ENTITY if
+// it has been destroyed since, and what changed
+typedef struct {
+    int slot;
+    EntityID entity;
+    unsigned int changedMask;
+    bool created;
+} ECSChange;
+
+void ECS_GetChange(ECSWorld* world, int i, ECSChange* change);
+
+// Forgets every recorded change once they have been saved; the cost follows
+// the number of changed slots, or the capacity after changesLost
+void ECS_ClearChanges(ECSWorld* world);
+
+// Matrix of a transform's own position, rotation and scale
+Matrix ECS_ComputeLocalMatrix(const TransformComponent* transform);
+
+// Stores a rebuilt world matrix. The first change in a tick keeps the old
+// matrix in `previous`; a transform never built before starts from `m`.
+void ECS_SetWorldMatrix(ECSWorld* world, TransformComponent* transform, const Matrix* m);
+
+// Fixed-timestep support: ECS_BeginTick starts the next simulation tick,
+// ECS_SetInterpolation sets the fraction of a tick rendering runs ahead of
+// the previous state. Transforms that changed in the latest tick are drawn
+// between `previous` and `world`; everything else is drawn at `world`.
+void ECS_BeginTick(ECSWorld* world);
+void ECS_SetInterpolation(ECSWorld* world, float alpha);
+
 // System functions
-void System_Render(ECSWorld* world);
+struct StaticBVH;
+
+// Recomputes the world matrix of every queued transform; the cost follows
+// the number of changed transforms, not the entity count. Parented
+// transforms are then propagated in one sweep of the hierarchy (when any
+// of them changed). System_Render runs it first, so only code reading
+// `world` before rendering must call it.
+void System_UpdateTransforms(ECSWorld* world);
+
+// Builds the query System_UpdateTransforms rescans after its dirty list
+// overflowed; the SystemPrepareFn for a scheduled transform update
+void System_PrepareTransforms(ECSWorld* world);
+
+// World-space box around what System_Render draws for a renderable
+void System_RenderBounds(const TransformComponent* transform, const RenderableComponent* renderable,
+                         Vector3* center, Vector3* halfExtents);
+
+// Draws every Transform+Renderable entity whose bounds intersect the frustum;
+// a NULL frustum draws everything. With a synced staticBVH, static entities
+// are culled hierarchically through it instead of one at a time.
+void System_Render(ECSWorld* world, const Frustum* frustum, const struct StaticBVH* staticBVH);
 
 #endif // ECS_H
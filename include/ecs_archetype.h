@@ -0,0 +1,20 @@
+#ifndef ECS_ARCHETYPE_H
+#define ECS_ARCHETYPE_H
+
+#include "ecs.h"
+#include "mem.h"
+
+#if ECS_ARCHETYPE_STORAGE
+
+// Archetype chunk storage, used by ecs.c when ECS_ARCHETYPE_STORAGE is set.
+// Chunks come from chunkPool, whose block size must be ECS_CHUNK_SIZE.
+void Archetype_Init(Archetype* archetype, unsigned int mask);
+void Archetype_Release(Archetype* archetype, MemPool* chunkPool);
+int Archetype_Insert(Archetype* archetype, MemPool* chunkPool, EntityID id);    // New row, -1 if no chunk could be allocated
+EntityID Archetype_Remove(Archetype* archetype, MemPool* chunkPool, int row);   // Entity moved into row, or ECS_INVALID_ENTITY
+void* Archetype_GetComponent(const Archetype* archetype, int row, ComponentType type);
+int Archetype_GetChunkRows(const Archetype* archetype, int chunk);
+
+#endif // ECS_ARCHETYPE_STORAGE
+
+#endif // ECS_ARCHETYPE_H
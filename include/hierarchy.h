@@ -0,0 +1,28 @@
+#ifndef HIERARCHY_H
+#define HIERARCHY_H
+
+#include "ecs.h"
+
+// Parent/child transforms. A child's TransformComponent is relative to its
+// parent's; `world` holds parent world * child local once
+// System_UpdateTransforms has run.
+//
+// Every linked entity has a node in world->hierarchyNodes. Nodes are kept
+// sorted by depth, so parents always precede their children and the
+// propagation pass is one linear sweep without recursion. Reparenting only
+// re-sorts the suffix of the array from the shallowest depth involved.
+
+// Attaches child under parent, keeping child's local transform. Passing
+// ECS_INVALID_ENTITY as parent detaches child into a root. Fails when either
+// entity lacks a transform, when parent lies inside child's subtree, or when
+// memory runs out; the hierarchy is unchanged then.
+bool Hierarchy_SetParent(ECSWorld* world, EntityID child, EntityID parent);
+
+// ECS_INVALID_ENTITY for roots and unlinked entities
+EntityID Hierarchy_GetParent(ECSWorld* world, EntityID child);
+
+// Rebuilds the world matrix of every dirty node and of everything below it.
+// Called by System_UpdateTransforms.
+void Hierarchy_Update(ECSWorld* world);
+
+#endif // HIERARCHY_H
@@ -17,6 +17,7 @@ typedef enum {
     ACTION_MENU_SELECT,
     ACTION_MENU_BACK,
     ACTION_TOGGLE_MENU,
+    ACTION_TOGGLE_PROFILER,
     ACTION_COUNT
 } ActionID;
 
@@ -0,0 +1,32 @@
+#ifndef LZ_H
+#define LZ_H
+
+#include <stddef.h>
+
+// Byte-oriented LZ77 block compression in the LZ4 style: greedy matching
+// through a hash of the next four bytes, a 64 KB window, and sequences of
+//   token      literal length (high nibble), match length - 4 (low nibble);
+//              a nibble of 15 continues in following bytes, each adding up
+//              to 255 until one is below 255
+//   literals
+//   offset     2 bytes little-endian, distance back to the match
+// The block ends after the literals of a sequence with no offset. Decoding
+// is a tight copy loop with no tables; every length and offset is checked
+// against both buffers, so corrupt input cannot overrun either of them.
+#define LZ_MIN_MATCH 4
+#define LZ_WINDOW_SIZE 65535
+#define LZ_HASH_BITS 12
+
+// Worst case output size for srcSize input bytes (incompressible data)
+size_t Lz_MaxCompressedSize(size_t srcSize);
+
+// Returns the compressed size, or 0 if dst is smaller than
+// Lz_MaxCompressedSize(srcSize) or the match table (frame scratch, charged
+// to the scene subsystem) cannot be had
+size_t Lz_Compress(const void* src, size_t srcSize, void* dst, size_t dstCapacity);
+
+// Returns the decompressed size, or 0 for malformed input or when the
+// output would not fit in dstCapacity
+size_t Lz_Decompress(const void* src, size_t srcSize, void* dst, size_t dstCapacity);
+
+#endif // LZ_H
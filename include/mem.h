@@ -0,0 +1,94 @@
+#ifndef MEM_H
+#define MEM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Subsystems that allocate through this layer. Every allocation is charged
+// to one of them so usage can be inspected at runtime.
+typedef enum {
+    MEM_SUBSYSTEM_ECS,
+    MEM_SUBSYSTEM_SCENE,
+    MEM_SUBSYSTEM_MENU,
+    MEM_SUBSYSTEM_RENDER,
+    MEM_SUBSYSTEM_SPATIAL,
+    MEM_SUBSYSTEM_COUNT
+} MemSubsystem;
+
+// Per-subsystem counters. currentBytes covers heap blocks, pool blocks and
+// scratch allocations currently handed out; failedCount records every
+// request that could not be served (the caller still receives NULL).
+typedef struct {
+    size_t currentBytes;
+    size_t peakBytes;                   // High-water mark of currentBytes
+    unsigned int allocCount;            // Successful allocations, lifetime
+    size_t allocBytes;                  // Bytes those allocations handed out, lifetime
+    unsigned int failedCount;
+    size_t lastFailedBytes;             // Size of the most recent failed request
+} MemStats;
+
+// Fixed-size block pool. Blocks are carved from slabs of blocksPerSlab and
+// recycled through an intrusive free list; slabs only go back to the heap
+// on MemPool_Release, so repeated alloc/free does not fragment the heap.
+typedef struct {
+    MemSubsystem subsystem;
+    size_t blockSize;                   // Rounded up to MEM_ALIGN
+    int blocksPerSlab;
+    void* freeList;
+    void* slabs;                        // Singly linked through each slab's header
+    int usedBlocks;
+    int totalBlocks;
+} MemPool;
+
+// Linear scratch arena: bump allocation, everything freed at once by
+// MemArena_Reset. Usage is charged per subsystem until the reset.
+typedef struct {
+    unsigned char* base;
+    size_t size;
+    size_t offset;
+    size_t peak;                        // High-water mark of offset
+    size_t used[MEM_SUBSYSTEM_COUNT];
+} MemArena;
+
+#define MEM_ALIGN 16
+
+// Size of the per-frame scratch arena
+#ifndef MEM_FRAME_ARENA_SIZE
+#if defined(__PSP__)
+#define MEM_FRAME_ARENA_SIZE (64 * 1024)
+#else
+#define MEM_FRAME_ARENA_SIZE (1024 * 1024)
+#endif
+#endif
+
+// Heap allocations with accounting. Mem_Free needs the size that was requested.
+void* Mem_Alloc(MemSubsystem subsystem, size_t size);
+void* Mem_Realloc(MemSubsystem subsystem, void* ptr, size_t oldSize, size_t newSize);
+void Mem_Free(MemSubsystem subsystem, void* ptr, size_t size);
+
+void MemPool_Init(MemPool* pool, MemSubsystem subsystem, size_t blockSize, int blocksPerSlab);
+void* MemPool_Alloc(MemPool* pool);
+void MemPool_Free(MemPool* pool, void* block);
+void MemPool_Release(MemPool* pool);    // Frees every slab, outstanding blocks included
+
+bool MemArena_Init(MemArena* arena, size_t size);
+void* MemArena_Alloc(MemArena* arena, MemSubsystem subsystem, size_t size);
+void MemArena_Reset(MemArena* arena);
+void MemArena_Release(MemArena* arena);
+
+// Frame scratch: Mem_BeginFrame() resets it at the top of every frame, so
+// anything taken from it must not outlive the frame.
+bool Mem_Init(void);
+void Mem_Shutdown(void);
+void Mem_BeginFrame(void);
+MemArena* Mem_GetFrameArena(void);
+
+// Transient buffers: served from the frame arena when it has room, from the
+// heap otherwise. Mem_ScratchFree only returns heap-backed buffers.
+void* Mem_ScratchAlloc(MemSubsystem subsystem, size_t size);
+void Mem_ScratchFree(MemSubsystem subsystem, void* ptr, size_t size);
+
+const MemStats* Mem_GetStats(MemSubsystem subsystem);
+const char* Mem_GetSubsystemName(MemSubsystem subsystem);
+
+#endif // MEM_H
@@ -0,0 +1,57 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <raylib.h>
+#include <stdbool.h>
+
+// Prebuilt vertex arrays for fixed helper geometry (plane quads, plane
+// outlines, the ground grid). A mesh is built the first time its key
+// (kind, size, color) is requested and replayed from then on, so unchanged
+// geometry costs no per-frame vertex generation. Editing a renderable
+// changes its key; the stale mesh is never hit again and is evicted once
+// its slot is needed (least recently used first).
+#define MESH_CACHE_CAPACITY 32
+
+typedef enum {
+    MESH_KIND_PLANE,        // RL_QUADS, size.x by size.z around the origin
+    MESH_KIND_PLANE_WIRE,   // RL_LINES outline of the same plane
+    MESH_KIND_GRID          // RL_LINES, size.x slices of size.z spacing
+} MeshKind;
+
+typedef struct {
+    MeshKind kind;
+    Vector3 size;
+    Color color;
+    int mode;               // rlgl primitive
+    int vertexCount;
+    Vector3* vertices;
+    Color* colors;          // Per-vertex colors, NULL when all use `color`
+    unsigned int lastUsed;  // Frame of the last lookup
+    bool used;
+} CachedMesh;
+
+typedef struct {
+    int hits;
+    int builds;
+    int evictions;
+    int meshes;             // Live cached meshes
+    int vertices;           // Vertices held by live meshes
+} MeshCacheStats;
+
+// Lookups return NULL when a mesh cannot be allocated, or when the cache is
+// full of meshes already drawn this frame; callers then draw the primitive
+// directly
+const CachedMesh* MeshCache_GetPlane(Vector2 size, Color color);
+const CachedMesh* MeshCache_GetPlaneWire(Vector2 size, Color color);
+const CachedMesh* MeshCache_GetGrid(int slices, float spacing);
+
+// Replays a mesh placed by `world` (an entity's world matrix), or as built
+// when world is NULL
+void MeshCache_Draw(const CachedMesh* mesh, const Matrix* world);
+
+void MeshCache_BeginFrame(void);    // Advances the LRU clock
+void MeshCache_Clear(void);         // Drops every mesh
+void MeshCache_Shutdown(void);
+const MeshCacheStats* MeshCache_GetStats(void);
+
+#endif // MESH_CACHE_H
@@ -0,0 +1,64 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+// Frame profiler. Code between PROFILE_BEGIN(scope) and PROFILE_END(scope)
+// is timed and summed per frame, so a scope entered once per simulation
+// tick reports its whole frame cost. Profiler_BeginFrame closes the frame
+// into a ring of the last PROFILER_HISTORY frames, from which
+// Profiler_GetStats reports min/avg/max/p99. Scopes may nest (times are
+// inclusive), and each scope must be timed from one thread at a time.
+//
+// Built with PROFILER_ENABLED=0 the macros expand to nothing and no clock
+// is read.
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+#define PROFILER_HISTORY 128
+
+typedef enum {
+    PROFILE_FRAME,          // Profiler_BeginFrame to Profiler_BeginFrame
+    PROFILE_INPUT,
+    PROFILE_MENU,
+    PROFILE_CAMERA,
+    PROFILE_CULLING,        // Visibility tests and queueing inside System_Render
+    PROFILE_RENDER,         // System_Render
+    PROFILE_PRESENT,        // EndDrawing, including the wait for vblank
+    PROFILE_SCOPE_COUNT
+} ProfileScope;
+
+// Microseconds over the frames recorded so far
+typedef struct {
+    float min;
+    float avg;
+    float max;
+    float p99;
+    int frames;
+} ProfileStats;
+
+#if PROFILER_ENABLED
+#define PROFILE_BEGIN(scope) Profiler_Begin(scope)
+#define PROFILE_END(scope) Profiler_End(scope)
+#define PROFILE_FRAME_BEGIN() Profiler_BeginFrame()
+#else
+#define PROFILE_BEGIN(scope) ((void)0)
+#define PROFILE_END(scope) ((void)0)
+#define PROFILE_FRAME_BEGIN() ((void)0)
+#endif
+
+// Clock in Profiler_TicksPerSecond() units: sceKernelGetSystemTimeWide (1 us)
+// on the PSP, CLOCK_MONOTONIC (1 ns) elsewhere
+uint64_t Profiler_Now(void);
+uint64_t Profiler_TicksPerSecond(void);
+
+void Profiler_Begin(ProfileScope scope);
+void Profiler_End(ProfileScope scope);
+void Profiler_BeginFrame(void);
+void Profiler_Reset(void);
+
+void Profiler_GetStats(ProfileScope scope, ProfileStats* stats);
+const char* Profiler_GetScopeName(ProfileScope scope);
+
+#endif // PROFILER_H
@@ -0,0 +1,71 @@
+#ifndef RENDER_BATCH_H
+#define RENDER_BATCH_H
+
+#include <raylib.h>
+
+// Cubes emitted per rlBegin/rlEnd block. Room for a whole block is reserved
+// in the rlgl batch first, so a flush never splits a cube.
+#define RENDER_BATCH_CUBES_PER_BLOCK 64
+
+// Sphere levels of detail, finest first. Each is a precomputed unit sphere
+// (bands x slices); the level for an instance comes from its projected size,
+// see RenderBatch_SelectSphereLod().
+#define RENDER_SPHERE_LOD_COUNT 4
+
+// A level is kept until the screen size moves this fraction past the
+// threshold it crossed, so a sphere sitting on a boundary does not pop
+#define RENDER_SPHERE_LOD_HYSTERESIS 0.15f
+
+// Collected cube for the current batch: its center and edge vectors, the
+// world matrix's axes scaled by the cube size
+typedef struct {
+    Vector3 position;
+    Vector3 axes[3];
+    Color color;
+} CubeInstance;
+
+// Collected sphere: center and axes as for cubes, the axes spanning the
+// diameter
+typedef struct {
+    Vector3 position;
+    Vector3 axes[3];
+    Color color;
+    int lod;
+} SphereInstance;
+
+// Submission counters, accumulated until RenderBatch_ResetStats()
+typedef struct {
+    int drawCalls;      // Primitive-mode runs plus rlgl batch flushes
+    int stateChanges;   // Primitive-mode or color switches between consecutive draws
+    int vertices;
+    int cubes;
+    int sphereLods[RENDER_SPHERE_LOD_COUNT];        // Spheres drawn at each level
+    int sphereTriangles[RENDER_SPHERE_LOD_COUNT];   // Triangles those spheres emitted
+    int visible;        // Entities that passed frustum culling
+    int culled;         // Entities rejected before any draw
+} RenderStats;
+
+// Cube batching: instances are collected between Begin and End, then drawn
+// as one solid pass and one wire pass with vertices transformed on the CPU,
+// instead of a DrawCube + DrawCubeWires pair per entity. `world` places a
+// unit box scaled by `size`, so entity rotation and scale apply.
+void RenderBatch_Begin(Color wireColor);   // wireColor outlines every cube
+void RenderBatch_AddCube(const Matrix* world, Vector3 size, Color color);
+// Spheres join the solid pass after the cubes, without outlines
+void RenderBatch_AddSphere(const Matrix* world, Vector3 size, Color color, int lod);
+void RenderBatch_End(void);
+void RenderBatch_Shutdown(void);    // Frees the instance buffer
+
+// Level for a sphere covering screenSize of the viewport height (see
+// Culling_ScreenSize), given the level it was drawn at last frame
+int RenderBatch_SelectSphereLod(float screenSize, int currentLod);
+int RenderBatch_GetSphereTriangles(int lod);
+
+// Draws issued outside the batch (grid, planes) are added by the caller:
+// mode is the rlgl primitive, color the one the draw starts with
+void RenderBatch_CountDraw(int mode, Color color, int vertices);
+void RenderBatch_CountCulling(int visible, int culled);
+void RenderBatch_ResetStats(void);
+const RenderStats* RenderBatch_GetStats(void);
+
+#endif // RENDER_BATCH_H
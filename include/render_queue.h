@@ -0,0 +1,46 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <stdint.h>
+#include "ecs.h"
+
+// Per-frame list of draw commands, sorted by a 64-bit key before
+// submission so that draws sharing a primitive mode and color end up
+// adjacent. Key layout, most significant bits first:
+//   [63:62] pass     solid geometry before wireframes/lines
+//   [61:56] type     RenderableType
+//   [55:24] color    RGBA
+//   [23:0]  depth    distance from the near plane, front to back
+typedef enum {
+    RENDER_PASS_SOLID = 0,
+    RENDER_PASS_WIRE = 1
+} RenderPass;
+
+#define RENDER_KEY_PASS(key) ((RenderPass)((key) >> 62))
+#define RENDER_KEY_TYPE(key) ((RenderableType)(((key) >> 56) & 0x3F))
+
+// Depths beyond this many units share the last key value
+#define RENDER_QUEUE_DEPTH_RANGE 1024.0f
+
+typedef struct {
+    uint64_t key;
+    const Matrix* world;                    // Matrix the renderable is drawn with
+    const RenderableComponent* renderable;
+} RenderCommand;
+
+uint64_t RenderQueue_MakeKey(RenderPass pass, RenderableType type, Color color, float depth);
+
+// Commands are collected between Begin and Sort; pointers must stay valid
+// until the queue has been submitted. Push fails only when the queue
+// cannot grow, in which case the caller should draw the command directly.
+void RenderQueue_Begin(void);
+bool RenderQueue_Push(uint64_t key, const Matrix* world, const RenderableComponent* renderable);
+void RenderQueue_Sort(void);
+int RenderQueue_GetCount(void);
+const RenderCommand* RenderQueue_GetCommands(void);
+void RenderQueue_Shutdown(void);    // Frees the command buffers
+
+// Submission order for A/B measurements; sorting is on by default
+void RenderQueue_SetSortEnabled(bool enabled);
+
+#endif // RENDER_QUEUE_H
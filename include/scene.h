@@ -3,6 +3,12 @@
 
 #include "ecs.h"
 
+// Seconds of play between autosaves; 0 (the default) turns autosave off, as
+// each write stalls the frame it lands on
+#ifndef SCENE_AUTOSAVE_SECONDS
+#define SCENE_AUTOSAVE_SECONDS 0
+#endif
+
 // Scene management
 void Scene_Init(ECSWorld* world);
 void Scene_CreateTestScene(ECSWorld* world);
@@ -11,4 +17,10 @@ bool Scene_Load(ECSWorld* world);
 void Scene_ResetToDefault(ECSWorld* world);
 int Scene_GetPopulatedSaveCount(void);
 
+// Autosave without a dialog: appends what changed since the last autosave to
+// a journal (scene_journal.h), compacting it into a new snapshot as needed
+bool Scene_Autosave(ECSWorld* world);
+bool Scene_LoadAutosave(ECSWorld* world);
+bool Scene_HasAutosave(void);
+
 #endif // SCENE_H
@@ -0,0 +1,100 @@
+#ifndef SCENE_FORMAT_H
+#define SCENE_FORMAT_H
+
+#include "ecs.h"
+
+// Binary scene encoding, independent of where the bytes are stored.
+//
+// Layout, all fields little-endian:
+//   header   magic, version, minReader, headerSize, totalSize, entityCount, chunkCount
+//   chunks   one per component type present in the world:
+//            tag (ComponentType), recordSize, count, byteSize,
+//            a membership bitset of entityCount bits (bit i = i-th saved entity),
+//            then count packed records of recordSize bytes in entity order
+//
+// Entities are numbered in save order; hierarchy parents are stored as those
+// numbers. Readers skip chunks with unknown tags and read only the fields they
+// know from longer records, so later versions may add component types or
+// append fields. A change older readers cannot ignore raises minReader.
+#define SCENE_FORMAT_MAGIC 0x53434550u      // "PECS"
+#define SCENE_FORMAT_VERSION 1
+#define SCENE_FORMAT_HEADER_SIZE 24
+#define SCENE_FORMAT_CHUNK_HEADER_SIZE 12
+
+// Snapshots for the autosave journal (scene_journal.h) add a chunk with this
+// tag: the slot each entity held in the world that saved it, as 32-bit
+// records. Deltas name entities by those slots. Plain saves leave it out.
+#define SCENE_FORMAT_SLOT_TAG 0x100
+
+// Buffer size that always fits an encoding of entityCount entities, snapshot or not
+size_t SceneFormat_MaxEncodedSize(int entityCount);
+
+// Writes the world into buffer and returns the bytes used, 0 if it does not fit
+size_t SceneFormat_Encode(ECSWorld* world, void* buffer, size_t bufferSize);
+
+// True when data starts with a compact scene header
+bool SceneFormat_IsCompact(const void* data, size_t size);
+
+// Replaces the world's contents with the scene in data, keeping its capacity.
+// The data is fully validated first; on failure the world is left untouched.
+bool SceneFormat_Decode(ECSWorld* world, const void* data, size_t size);
+
+// Encode/Decode with the slot chunk. Decoding fills slotMap[slot] with the
+// entity now standing for each saved slot (ECS_INVALID_ENTITY for the rest),
+// and fails without a slot chunk or when a slot is not below slotCount.
+size_t SceneFormat_EncodeSnapshot(ECSWorld* world, void* buffer, size_t bufferSize);
+bool SceneFormat_DecodeSnapshot(ECSWorld* world, const void* data, size_t size, EntityID* slotMap, int slotCount);
+
+// Delta: the entities a world changed since its last ECS_ClearChanges.
+//   header   magic, version, minReader, headerSize, totalSize, recordCount,
+//            typeMask (u16) and a reserved u16
+//   sizes    a u16 record size for each bit of typeMask, lowest first
+//   records  slot (u32), flags (SCENE_DELTA_*), componentMask and
+//            changedMask (u16 each), then a record laid out as in the
+//            chunks for each component in both masks, lowest bit first
+// A hierarchy record holds the parent's slot. Record sizes follow the same
+// rules as chunks, so later versions may append fields.
+#define SCENE_FORMAT_DELTA_MAGIC 0x44434550u    // "PECD"
+#define SCENE_FORMAT_DELTA_HEADER_SIZE 24
+#define SCENE_DELTA_ALIVE 1     // Without it the slot's entity was destroyed
+#define SCENE_DELTA_CREATED 2   // A new entity took the slot: replace what was there
+
+// Buffer size that always fits a delta of changedCount slots
+size_t SceneFormat_MaxDeltaSize(int changedCount);
+
+// Returns the bytes used, 0 if the delta does not fit or the world's change
+// list is incomplete (world->changesLost), which calls for a snapshot
+size_t SceneFormat_EncodeDelta(ECSWorld* world, void* buffer, size_t bufferSize);
+
+bool SceneFormat_IsDelta(const void* data, size_t size);
+
+// Applies a delta on top of a decoded snapshot, keeping slotMap current.
+// Validated first; on failure the world is left untouched.
+bool SceneFormat_ApplyDelta(ECSWorld* world, const void* data, size_t size, EntityID* slotMap, int slotCount);
+
+// Savedata container for a compressed scene (lz.h): magic, raw size and
+// compressed size as 32-bit little-endian words, then the compressed block.
+// Data without this magic is an uncompressed save, compact or legacy.
+#define SCENE_FORMAT_PACKED_MAGIC 0x5A434550u   // "PECZ"
+#define SCENE_FORMAT_PACKED_HEADER_SIZE 12
+
+size_t SceneFormat_MaxPackedSize(size_t rawSize);
+
+// Compresses an encoded scene into buffer and returns the packed size; 0 if
+// that would not be smaller than rawSize, which means save it as it is
+size_t SceneFormat_Pack(const void* raw, size_t rawSize, void* buffer, size_t bufferSize);
+
+// Size the packed save in data expands to, 0 if data is not packed
+size_t SceneFormat_PackedRawSize(const void* data, size_t size);
+
+// Expands a packed save into raw; returns the raw size, 0 if data is corrupt
+size_t SceneFormat_Unpack(const void* data, size_t size, void* raw, size_t rawCapacity);
+
+// The original fixed-record dump: an entity count followed by one record per
+// entity holding every saveable component, present or not. Still read so old
+// saves load, and kept as the baseline the compact format is measured against.
+size_t SceneFormat_LegacySize(int entityCount);
+size_t SceneFormat_EncodeLegacy(ECSWorld* world, void* buffer, size_t bufferSize);
+bool SceneFormat_DecodeLegacy(ECSWorld* world, const void* data, size_t size);
+
+#endif // SCENE_FORMAT_H
@@ -0,0 +1,64 @@
+#ifndef SCENE_JOURNAL_H
+#define SCENE_JOURNAL_H
+
+#include "ecs.h"
+
+// Autosave journal: one full snapshot followed by the deltas saved after it
+// (scene_format.h), so an autosave writes what changed rather than the whole
+// scene. Records are stored back to back, each framed as
+//   magic, payload size, FNV-1a checksum of the payload (32-bit LE words)
+//   payload    snapshot or delta, LZ-packed when that makes it smaller
+// A record cut short by a failed write does not match its checksum; replay
+// stops there and keeps the state the records before it describe.
+#define SCENE_JOURNAL_MAGIC 0x4A434550u     // "PECJ"
+#define SCENE_JOURNAL_HEADER_SIZE 12
+
+// Compaction: a new snapshot replaces the journal once the deltas after the
+// current one would outgrow it (replay reads at most twice a snapshot), or
+// after this many deltas
+#ifndef SCENE_JOURNAL_MAX_DELTAS
+#define SCENE_JOURNAL_MAX_DELTAS 64
+#endif
+
+typedef struct {
+    bool compress;
+    size_t snapshotSize;    // Framed size of the journal's snapshot, 0 while there is none
+    size_t deltaSize;       // Framed bytes of the deltas after it
+    int deltaCount;
+} SceneJournal;
+
+// A framed record waiting to be stored, in scene scratch memory
+typedef struct {
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+    bool snapshot;          // Replaces the journal instead of being appended to it
+} SceneJournalRecord;
+
+void SceneJournal_Init(SceneJournal* journal, bool compress);
+
+// The next record will be a snapshot
+void SceneJournal_Reset(SceneJournal* journal);
+
+// False when the journal already holds the world as it is
+bool SceneJournal_HasChanges(const SceneJournal* journal, const ECSWorld* world);
+
+// Builds the next record: a delta of the world's changes, or a snapshot when
+// the journal is empty, the world's change list is incomplete or compaction
+// is due. False when out of memory.
+bool SceneJournal_BeginRecord(SceneJournal* journal, ECSWorld* world, SceneJournalRecord* record);
+
+// Releases the record. Once it is stored the world's changes are cleared;
+// otherwise the journal may end in a partial record, so the next is a snapshot.
+void SceneJournal_EndRecord(SceneJournal* journal, ECSWorld* world, SceneJournalRecord* record, bool stored);
+
+// Largest journal a world of `capacity` entities can leave behind
+size_t SceneJournal_MaxSize(int capacity);
+
+// Rebuilds the world from a journal: its snapshot, then each delta in order,
+// stopping at the first damaged or unreadable record. slotMap, if given, has
+// room for the world's capacity and ends up mapping saved slots to entities.
+// Returns the records applied; with 0 the world is left untouched.
+int SceneJournal_Replay(ECSWorld* world, const void* data, size_t size, EntityID* slotMap);
+
+#endif // SCENE_JOURNAL_H
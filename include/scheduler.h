@@ -0,0 +1,79 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "ecs.h"
+
+// System registry and scheduler. Each system declares the components it
+// reads and writes as COMPONENT_BIT() masks. Two systems conflict when
+// either one writes something the other reads or writes; a system then
+// waits for every conflicting system registered before it. Registration
+// order is therefore always a valid serial order, and systems that do not
+// conflict may run at the same time.
+//
+// Host builds run ready systems on a pool of worker threads that steal work
+// from each other; the PSP runs them one after another on the calling
+// thread (SCHEDULER_THREADS=0 forces this everywhere).
+//
+// Systems running in parallel must not create or destroy entities, add or
+// remove components, or build new queries. A system's prepare function
+// builds every query it uses; Scheduler_Run calls them all on the calling
+// thread before starting any system, so lookups inside the run only read.
+// Scene loads rebuild the world, which is why this repeats every run.
+// ECS_GetQuery asserts that it builds nothing while a run is in progress.
+// Any system may call ECS_MarkChanged; ECS_MarkTransformDirty also queues
+// the entity on a shared list, so only systems writing COMPONENT_TRANSFORM
+// (which never run together) may call it.
+#ifndef SCHEDULER_THREADS
+#if defined(__PSP__)
+#define SCHEDULER_THREADS 0
+#else
+#define SCHEDULER_THREADS 1
+#endif
+#endif
+
+#define SCHEDULER_MAX_SYSTEMS 32
+#define SCHEDULER_MAX_WORKERS 16
+
+// Declares access to everything: the system runs alone, after every system
+// registered before it and before every system registered after it
+#define SCHEDULER_ACCESS_ALL 0xFFFFFFFFu
+
+typedef void (*SystemUpdateFn)(ECSWorld* world, float deltaTime, void* user);
+typedef void (*SystemPrepareFn)(ECSWorld* world);
+
+typedef struct {
+    const char* name;
+    SystemUpdateFn update;
+    void* user;
+    unsigned int reads;         // COMPONENT_BIT()s read
+    unsigned int writes;        // COMPONENT_BIT()s written
+    SystemPrepareFn prepare;    // Builds the system's queries; NULL if it has none
+} SystemDesc;
+
+typedef struct SchedulerPool SchedulerPool;
+
+typedef struct {
+    SystemDesc systems[SCHEDULER_MAX_SYSTEMS];
+    int systemCount;
+    unsigned int dependents[SCHEDULER_MAX_SYSTEMS];     // Bit j: system j waits for this one
+    int dependencyCounts[SCHEDULER_MAX_SYSTEMS];        // Systems this one waits for
+    int workerCount;                                    // Threads running systems, the caller included
+    SchedulerPool* pool;                                // NULL when running serially
+} Scheduler;
+
+// Starts workerCount - 1 worker threads; the thread calling Scheduler_Run
+// is the remaining one. workerCount <= 0 uses one per online CPU. Without
+// threads, or if they cannot be started, the scheduler runs serially.
+void Scheduler_Init(Scheduler* scheduler, int workerCount);
+void Scheduler_Shutdown(Scheduler* scheduler);
+
+// Returns the system's index, or -1 if SCHEDULER_MAX_SYSTEMS are registered
+int Scheduler_AddSystem(Scheduler* scheduler, const SystemDesc* desc);
+
+// Runs every system once and returns when all have finished
+void Scheduler_Run(Scheduler* scheduler, ECSWorld* world, float deltaTime);
+
+// Runs every system once in registration order on the calling thread
+void Scheduler_RunSerial(Scheduler* scheduler, ECSWorld* world, float deltaTime);
+
+#endif // SCHEDULER_H
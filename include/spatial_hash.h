@@ -0,0 +1,57 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include "ecs.h"
+
+// Uniform-grid spatial hash over entity positions. Space is cut into cubic
+// cells of cellSize; each occupied cell hashes into a bucket holding a list
+// of entries. Entries are indexed by entity slot, so update and removal are
+// O(1) and only entities that change cell touch the bucket lists.
+typedef struct {
+    EntityID id;
+    Vector3 position;
+    int cell[3];
+    int bucket;
+    int prev;               // Entry indices within the bucket, -1 at the ends
+    int next;
+    int denseSlot;          // Position in SpatialHash.dense, -1 if absent
+    unsigned int syncStamp;
+} SpatialHashEntry;
+
+typedef struct {
+    float cellSize;
+    float invCellSize;
+    int capacity;           // Entity slots covered, matches the world's capacity
+    int bucketMask;         // Bucket count - 1 (power of two)
+    int* buckets;           // Head entry per bucket, -1 if empty
+    SpatialHashEntry* entries;
+    int* dense;             // Entity slots currently in the hash
+    int count;
+    unsigned int syncStamp;
+    unsigned int version;   // Transform query version at the last full sync
+    bool synced;            // A full sync has run since the hash was cleared
+} SpatialHash;
+
+bool SpatialHash_Init(SpatialHash* hash, int capacity, float cellSize);
+void SpatialHash_Release(SpatialHash* hash);
+void SpatialHash_Clear(SpatialHash* hash);
+
+// Inserts the entity or moves it; re-buckets only when its cell changed
+void SpatialHash_Update(SpatialHash* hash, EntityID id, Vector3 position);
+void SpatialHash_Remove(SpatialHash* hash, EntityID id);
+
+// Brings the hash in line with every TransformComponent in the world. While
+// no entity has gained or lost a transform since the last sync, only the
+// transforms marked dirty are read: the world's dirty list and dirty
+// hierarchy nodes, so call it after movement and before
+// System_UpdateTransforms drains them. Otherwise the whole Transform query
+// is walked: moved entities are updated, new ones inserted, vanished ones
+// removed.
+void SpatialHash_Sync(SpatialHash* hash, ECSWorld* world);
+
+// Queries write up to maxResults IDs to results and return the total number
+// of matches (which may exceed maxResults)
+int SpatialHash_QueryRadius(const SpatialHash* hash, Vector3 center, float radius, EntityID* results, int maxResults);
+int SpatialHash_QueryAABB(const SpatialHash* hash, Vector3 min, Vector3 max, EntityID* results, int maxResults);
+
+#endif // SPATIAL_HASH_H
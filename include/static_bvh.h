@@ -0,0 +1,58 @@
+#ifndef STATIC_BVH_H
+#define STATIC_BVH_H
+
+#include "ecs.h"
+
+// Bounding volume hierarchy over static renderables (Transform + Renderable
+// + Static). Nodes live in one flat array with both children of an interior
+// node stored side by side; items are reordered during the build so every
+// node covers a contiguous item range. The tree is rebuilt only when an
+// entity enters or leaves the static query, never for camera movement.
+#define STATIC_BVH_LEAF_SIZE 4
+
+typedef struct {
+    Vector3 min;
+    Vector3 max;
+    int left;               // Index of the left child (right is left + 1), -1 for leaves
+    int first;              // First item covered by this node
+    int count;              // Items covered by this node
+} StaticBVHNode;
+
+typedef struct {
+    EntityID id;
+    Vector3 min;
+    Vector3 max;
+} StaticBVHItem;
+
+struct StaticBVH {
+    StaticBVHNode* nodes;
+    int nodeCount;
+    int nodeCapacity;
+    StaticBVHItem* items;
+    int itemCount;
+    int itemCapacity;
+    unsigned int version;   // Static query version the tree was built from
+    bool valid;
+};
+typedef struct StaticBVH StaticBVH;
+
+void StaticBVH_Init(StaticBVH* bvh);
+void StaticBVH_Release(StaticBVH* bvh);
+
+// Rebuilds the tree if the world's static set changed since the last build.
+// Returns true when a rebuild happened.
+bool StaticBVH_Sync(StaticBVH* bvh, ECSWorld* world);
+
+// Forces the next Sync to rebuild, e.g. after moving a static entity
+void StaticBVH_Invalidate(StaticBVH* bvh);
+
+// Writes up to maxResults IDs of items intersecting the frustum (all items
+// for a NULL frustum) and returns the total number found. Subtrees fully
+// outside a plane are skipped; subtrees fully inside are taken whole.
+int StaticBVH_QueryFrustum(const StaticBVH* bvh, const Frustum* frustum, EntityID* results, int maxResults);
+
+// Nearest item box hit by the ray within maxDistance. direction need not be
+// normalized; distances are in units of its length.
+bool StaticBVH_Raycast(const StaticBVH* bvh, Ray ray, float maxDistance, EntityID* hitEntity, float* hitDistance);
+
+#endif // STATIC_BVH_H
@@ -0,0 +1,44 @@
+#ifndef STRESS_SCENE_H
+#define STRESS_SCENE_H
+
+#include "ecs.h"
+
+// Procedural load for profiling: entityCount renderables scattered over a
+// ground grid, plus one camera. Everything is drawn from a seeded RNG, so
+// the same config always builds the same scene.
+#define STRESS_SCENE_TYPE_COUNT (RENDERABLE_GRID + 1)
+
+// Spawned in place of the test scene when non-zero. The world must have the
+// capacity: raise MAX_ENTITIES along with it.
+#ifndef STRESS_SCENE_ENTITIES
+#define STRESS_SCENE_ENTITIES 0
+#endif
+
+typedef struct {
+    int entityCount;            // Renderables to spawn; the camera comes on top
+    unsigned int seed;
+    float typeWeights[STRESS_SCENE_TYPE_COUNT];     // Relative share per RenderableType
+    float staticRatio;          // Fraction tagged COMPONENT_STATIC, 0 to 1
+    float minSize;              // Edge length or diameter, picked uniformly in between
+    float maxSize;
+    float spacing;              // Distance between neighbouring grid cells
+    const Color* palette;       // Colors to pick from; NULL for random opaque colors
+    int paletteCount;
+    float spinSpeed;            // Radians per second for StressScene_Animate
+} StressSceneConfig;
+
+// Cubes and spheres, a few planes, a quarter static, sizes 0.5 to 2
+void StressScene_DefaultConfig(StressSceneConfig* config);
+
+// Spawns the scene into the world and returns the camera entity. Stops early
+// if the world runs out of capacity; the camera is created first.
+EntityID StressScene_Create(ECSWorld* world, const StressSceneConfig* config);
+
+// SystemUpdateFn that spins every non-static renderable about its Y axis at
+// the config's (user) spinSpeed, so transforms and bounds change each tick
+void StressScene_Animate(ECSWorld* world, float deltaTime, void* user);
+
+// SystemPrepareFn for StressScene_Animate: builds the query it iterates
+void StressScene_PrepareAnimate(ECSWorld* world);
+
+#endif // STRESS_SCENE_H
@@ -0,0 +1,32 @@
+#ifndef TIMESTEP_H
+#define TIMESTEP_H
+
+// Fixed-timestep clock. Frame times are accumulated and paid out in ticks of
+// `step` seconds, so the simulation advances by the same amount every tick
+// whatever the frame rate. At most maxSteps ticks run per frame; time beyond
+// that (a hitch, a breakpoint) is dropped instead of caught up, which keeps
+// the per-frame cost bounded. The leftover fraction of a tick is the
+// interpolation factor for rendering.
+#ifndef TIMESTEP_DEFAULT_RATE
+#define TIMESTEP_DEFAULT_RATE 60.0f
+#endif
+#ifndef TIMESTEP_DEFAULT_MAX_STEPS
+#define TIMESTEP_DEFAULT_MAX_STEPS 4
+#endif
+
+typedef struct {
+    float step;             // Seconds per tick
+    int maxSteps;           // Ticks run at most per frame
+    float accumulator;      // Time not yet simulated, below one step after Advance
+    unsigned int droppedSteps;  // Ticks skipped because of maxSteps, lifetime
+} FixedTimestep;
+
+void FixedTimestep_Init(FixedTimestep* timestep, float tickRate, int maxSteps);
+
+// Adds a frame's elapsed time and returns the number of ticks to run now
+int FixedTimestep_Advance(FixedTimestep* timestep, float frameTime);
+
+// Fraction of a tick elapsed since the last one, in [0, 1)
+float FixedTimestep_GetAlpha(const FixedTimestep* timestep);
+
+#endif // TIMESTEP_H
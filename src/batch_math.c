@@ -0,0 +1,427 @@
+#include "batch_math.h"
+#include <math.h>
+#include <stdint.h>
+
+#define BATCH_MATH_PATH_SCALAR 0
+#define BATCH_MATH_PATH_SSE 1
+#define BATCH_MATH_PATH_NEON 2
+#define BATCH_MATH_PATH_VFPU 3
+
+// NEON needs AArch64 for full-precision square root and divide
+#if !BATCH_MATH_SIMD
+#define BATCH_MATH_PATH BATCH_MATH_PATH_SCALAR
+#elif defined(__PSP__)
+#define BATCH_MATH_PATH BATCH_MATH_PATH_VFPU
+#elif defined(__SSE__)
+#define BATCH_MATH_PATH BATCH_MATH_PATH_SSE
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define BATCH_MATH_PATH BATCH_MATH_PATH_NEON
+#include <arm_neon.h>
+#else
+#define BATCH_MATH_PATH BATCH_MATH_PATH_SCALAR
+#endif
+
+// Plain C kernels over [first, count): the whole batch on the scalar path,
+// the tails the vector loops leave otherwise. Operation order follows
+// raymath, so results match it exactly. Inputs are read into locals before
+// anything is stored: out may alias them, so a store between two loads
+// would force every later load to go back to memory.
+
+// out = a + b * scale over one float array, four elements per step
+static void BatchMath_AddScaledLane(float* out, const float* a, const float* b, float scale, int first, int count) {
+    int i = first;
+    for (; i + 4 <= count; i += 4) {
+        float x[4], y[4];
+        for (int k = 0; k < 4; k++) {
+            x[k] = a[i + k];
+            y[k] = b[i + k];
+        }
+        for (int k = 0; k < 4; k++) out[i + k] = x[k] + y[k] * scale;
+    }
+    for (; i < count; i++) {
+        out[i] = a[i] + b[i] * scale;
+    }
+}
+
+static void BatchMath_AddScaledScalar(Vector3Array out, Vector3Array a, Vector3Array b, float scale, int first, int count) {
+    BatchMath_AddScaledLane(out.x, a.x, b.x, scale, first, count);
+    BatchMath_AddScaledLane(out.y, a.y, b.y, scale, first, count);
+    BatchMath_AddScaledLane(out.z, a.z, b.z, scale, first, count);
+}
+
+static void BatchMath_TransformScalar(Vector3Array out, Vector3Array in, const Matrix* m, int first, int count) {
+    // A local copy keeps the matrix in registers across the stores
+    const Matrix t = *m;
+    int i = first;
+    for (; i + 4 <= count; i += 4) {
+        float x[4], y[4], z[4];
+        for (int k = 0; k < 4; k++) {
+            x[k] = in.x[i + k];
+            y[k] = in.y[i + k];
+            z[k] = in.z[i + k];
+        }
+        for (int k = 0; k < 4; k++) out.x[i + k] = t.m0 * x[k] + t.m4 * y[k] + t.m8 * z[k] + t.m12;
+        for (int k = 0; k < 4; k++) out.y[i + k] = t.m1 * x[k] + t.m5 * y[k] + t.m9 * z[k] + t.m13;
+        for (int k = 0; k < 4; k++) out.z[i + k] = t.m2 * x[k] + t.m6 * y[k] + t.m10 * z[k] + t.m14;
+    }
+    for (; i < count; i++) {
+        float x = in.x[i];
+        float y = in.y[i];
+        float z = in.z[i];
+        out.x[i] = t.m0 * x + t.m4 * y + t.m8 * z + t.m12;
+        out.y[i] = t.m1 * x + t.m5 * y + t.m9 * z + t.m13;
+        out.z[i] = t.m2 * x + t.m6 * y + t.m10 * z + t.m14;
+    }
+}
+
+static void BatchMath_NormalizeScalar(Vector3Array v, int first, int count) {
+    for (int i = first; i < count; i++) {
+        float x = v.x[i];
+        float y = v.y[i];
+        float z = v.z[i];
+        float length = sqrtf(x * x + y * y + z * z);
+        if (length != 0.0f) {
+            float inverse = 1.0f / length;
+            v.x[i] = x * inverse;
+            v.y[i] = y * inverse;
+            v.z[i] = z * inverse;
+        }
+    }
+}
+
+// Matrix memory viewed as four rows of four floats: row r holds
+// m[r], m[r+4], m[r+8], m[r+12]. Row r of the product is the sum over k of
+// right[r][k] * left row k.
+static void BatchMath_MultiplyScalar(Matrix* out, const Matrix* left, const Matrix* right, int first, int count) {
+    for (int i = first; i < count; i++) {
+        const Matrix a = left[i];
+        const Matrix b = right[i];
+        const float* l = (const float*)&a;
+        const float* r = (const float*)&b;
+        float* o = (float*)&out[i];
+        for (int row = 0; row < 16; row += 4) {
+            float r0 = r[row], r1 = r[row + 1], r2 = r[row + 2], r3 = r[row + 3];
+            o[row] = r0 * l[0] + r1 * l[4] + r2 * l[8] + r3 * l[12];
+            o[row + 1] = r0 * l[1] + r1 * l[5] + r2 * l[9] + r3 * l[13];
+            o[row + 2] = r0 * l[2] + r1 * l[6] + r2 * l[10] + r3 * l[14];
+            o[row + 3] = r0 * l[3] + r1 * l[7] + r2 * l[11] + r3 * l[15];
+        }
+    }
+}
+
+// Vector kernels: each handles the largest multiple of four elements and
+// returns how many it did
+
+#if BATCH_MATH_PATH == BATCH_MATH_PATH_SSE
+
+static int BatchMath_AddScaledSimd(Vector3Array out, Vector3Array a, Vector3Array b, float scale, int count) {
+    __m128 s = _mm_set1_ps(scale);
+    int end = count & ~3;
+    for (int i = 0; i < end; i += 4) {
+        _mm_storeu_ps(out.x + i, _mm_add_ps(_mm_loadu_ps(a.x + i), _mm_mul_ps(_mm_loadu_ps(b.x + i), s)));
+        _mm_storeu_ps(out.y + i, _mm_add_ps(_mm_loadu_ps(a.y + i), _mm_mul_ps(_mm_loadu_ps(b.y + i), s)));
+        _mm_storeu_ps(out.z + i, _mm_add_ps(_mm_loadu_ps(a.z + i), _mm_mul_ps(_mm_loadu_ps(b.z + i), s)));
+    }
+    return end;
+}
+
+static int BatchMath_TransformSimd(Vector3Array out, Vector3Array in, const Matrix* m, int count) {
+    __m128 m0 = _mm_set1_ps(m->m0), m4 = _mm_set1_ps(m->m4), m8 = _mm_set1_ps(m->m8), m12 = _mm_set1_ps(m->m12);
+    __m128 m1 = _mm_set1_ps(m->m1), m5 = _mm_set1_ps(m->m5), m9 = _mm_set1_ps(m->m9), m13 = _mm_set1_ps(m->m13);
+    __m128 m2 = _mm_set1_ps(m->m2), m6 = _mm_set1_ps(m->m6), m10 = _mm_set1_ps(m->m10), m14 = _mm_set1_ps(m->m14);
+    int end = count & ~3;
+    for (int i = 0; i < end; i += 4) {
+        __m128 x = _mm_loadu_ps(in.x + i);
+        __m128 y = _mm_loadu_ps(in.y + i);
+        __m128 z = _mm_loadu_ps(in.z + i);
+        __m128 ox = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m4, y)), _mm_mul_ps(m8, z)), m12);
+        __m128 oy = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m1, x), _mm_mul_ps(m5, y)), _mm_mul_ps(m9, z)), m13);
+        __m128 oz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m2, x), _mm_mul_ps(m6, y)), _mm_mul_ps(m10, z)), m14);
+        _mm_storeu_ps(out.x + i, ox);
+        _mm_storeu_ps(out.y + i, oy);
+        _mm_storeu_ps(out.z + i, oz);
+    }
+    return end;
+}
+
+static int BatchMath_NormalizeSimd(Vector3Array v, int count) {
+    __m128 zero = _mm_setzero_ps();
+    __m128 one = _mm_set1_ps(1.0f);
+    int end = count & ~3;
+    for (int i = 0; i < end; i += 4) {
+        __m128 x = _mm_loadu_ps(v.x + i);
+        __m128 y = _mm_loadu_ps(v.y + i);
+        __m128 z = _mm_loadu_ps(v.z + i);
+        __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+        __m128 inverse = _mm_div_ps(one, length);
+        // Lanes of zero length keep their input
+        __m128 nonzero = _mm_cmpneq_ps(length, zero);
+        _mm_storeu_ps(v.x + i, _mm_or_ps(_mm_and_ps(nonzero, _mm_mul_ps(x, inverse)), _mm_andnot_ps(nonzero, x)));
+        _mm_storeu_ps(v.y + i, _mm_or_ps(_mm_and_ps(nonzero, _mm_mul_ps(y, inverse)), _mm_andnot_ps(nonzero, y)));
+        _mm_storeu_ps(v.z + i, _mm_or_ps(_mm_and_ps(nonzero, _mm_mul_ps(z, inverse)), _mm_andnot_ps(nonzero, z)));
+    }
+    return end;
+}
+
+// One right-hand row at a time: its four entries broadcast against the
+// four left rows, all loaded before anything is stored so out may alias
+static inline __m128 BatchMath_MultiplyRow(const float* r, __m128 l0, __m128 l1, __m128 l2, __m128 l3) {
+    __m128 row = _mm_loadu_ps(r);
+    __m128 x = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), l0);
+    __m128 y = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), l1);
+    __m128 z = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), l2);
+    __m128 w = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), l3);
+    return _mm_add_ps(_mm_add_ps(_mm_add_ps(x, y), z), w);
+}
+
+static int BatchMath_MultiplySimd(Matrix* out, const Matrix* left, const Matrix* right, int count) {
+    for (int i = 0; i < count; i++) {
+        const float* l = (const float*)&left[i];
+        const float* r = (const float*)&right[i];
+        __m128 l0 = _mm_loadu_ps(l);
+        __m128 l1 = _mm_loadu_ps(l + 4);
+        __m128 l2 = _mm_loadu_ps(l + 8);
+        __m128 l3 = _mm_loadu_ps(l + 12);
+        __m128 row0 = BatchMath_MultiplyRow(r, l0, l1, l2, l3);
+        __m128 row1 = BatchMath_MultiplyRow(r + 4, l0, l1, l2, l3);
+        __m128 row2 = BatchMath_MultiplyRow(r + 8, l0, l1, l2, l3);
+        __m128 row3 = BatchMath_MultiplyRow(r + 12, l0, l1, l2, l3);
+        float* o = (float*)&out[i];
+        _mm_storeu_ps(o, row0);
+        _mm_storeu_ps(o + 4, row1);
+        _mm_storeu_ps(o + 8, row2);
+        _mm_storeu_ps(o + 12, row3);
+    }
+    return count;
+}
+
+#elif BATCH_MATH_PATH == BATCH_MATH_PATH_NEON
+
+static int BatchMath_AddScaledSimd(Vector3Array out, Vector3Array a, Vector3Array b, float scale, int count) {
+    float32x4_t s = vdupq_n_f32(scale);
+    int end = count & ~3;
+    for (int i = 0; i < end; i += 4) {
+        vst1q_f32(out.x + i, vaddq_f32(vld1q_f32(a.x + i), vmulq_f32(vld1q_f32(b.x + i), s)));
+        vst1q_f32(out.y + i, vaddq_f32(vld1q_f32(a.y + i), vmulq_f32(vld1q_f32(b.y + i), s)));
+        vst1q_f32(out.z + i, vaddq_f32(vld1q_f32(a.z + i), vmulq_f32(vld1q_f32(b.z + i), s)));
+    }
+    return end;
+}
+
+static int BatchMath_TransformSimd(Vector3Array out, Vector3Array in, const Matrix* m, int count) {
+    int end = count & ~3;
+    for (int i = 0; i < end; i += 4) {
+        float32x4_t x = vld1q_f32(in.x + i);
+        float32x4_t y = vld1q_f32(in.y + i);
+        float32x4_t z = vld1q_f32(in.z + i);
+        float32x4_t ox = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(x, m->m0), vmulq_n_f32(y, m->m4)), vmulq_n_f32(z, m->m8)),
+                                   vdupq_n_f32(m->m12));
+        float32x4_t oy = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(x, m->m1), vmulq_n_f32(y, m->m5)), vmulq_n_f32(z, m->m9)),
+                                   vdupq_n_f32(m->m13));
+        float32x4_t oz = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(x, m->m2), vmulq_n_f32(y, m->m6)), vmulq_n_f32(z, m->m10)),
+                                   vdupq_n_f32(m->m14));
+        vst1q_f32(out.x + i, ox);
+        vst1q_f32(out.y + i, oy);
+        vst1q_f32(out.z + i, oz);
+    }
+    return end;
+}
+
+static int BatchMath_NormalizeSimd(Vector3Array v, int count) {
+    float32x4_t zero = vdupq_n_f32(0.0f);
+    float32x4_t one = vdupq_n_f32(1.0f);
+    int end = count & ~3;
+    for (int i = 0; i < end; i += 4) {
+        float32x4_t x = vld1q_f32(v.x + i);
+        float32x4_t y = vld1q_f32(v.y + i);
+        float32x4_t z = vld1q_f32(v.z + i);
+        float32x4_t length = vsqrtq_f32(vaddq_f32(vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y)), vmulq_f32(z, z)));
+        float32x4_t inverse = vdivq_f32(one, length);
+        // Lanes of zero length keep their input
+        uint32x4_t isZero = vceqq_f32(length, zero);
+        vst1q_f32(v.x + i, vbslq_f32(isZero, x, vmulq_f32(x, inverse)));
+        vst1q_f32(v.y + i, vbslq_f32(isZero, y, vmulq_f32(y, inverse)));
+        vst1q_f32(v.z + i, vbslq_f32(isZero, z, vmulq_f32(z, inverse)));
+    }
+    return end;
+}
+
+static int BatchMath_MultiplySimd(Matrix* out, const Matrix* left, const Matrix* right, int count) {
+    for (int i = 0; i < count; i++) {
+        const float* l = (const float*)&left[i];
+        const float* r = (const float*)&right[i];
+        float32x4_t l0 = vld1q_f32(l);
+        float32x4_t l1 = vld1q_f32(l + 4);
+        float32x4_t l2 = vld1q_f32(l + 8);
+        float32x4_t l3 = vld1q_f32(l + 12);
+        float32x4_t rows[4];
+        for (int row = 0; row < 4; row++) {
+            const float* rr = r + row * 4;
+            rows[row] = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(l0, rr[0]), vmulq_n_f32(l1, rr[1])), vmulq_n_f32(l2, rr[2])),
+                                  vmulq_n_f32(l3, rr[3]));
+        }
+        float* o = (float*)&out[i];
+        for (int row = 0; row < 4; row++) {
+            vst1q_f32(o + row * 4, rows[row]);
+        }
+    }
+    return count;
+}
+
+#elif BATCH_MATH_PATH == BATCH_MATH_PATH_VFPU
+
+// lv.q/sv.q move 16 aligned bytes. The VFPU registers are not touched by
+// compiler-generated code, so values loaded by one asm block stay put for
+// the next within a kernel.
+static int BatchMath_Aligned(const void* a, const void* b, const void* c) {
+    return ((((uintptr_t)a) | ((uintptr_t)b) | ((uintptr_t)c)) & 15) == 0;
+}
+
+// out = a + b * scale over one float array, count a multiple of four
+static void BatchMath_AddScaledVfpu(float* out, const float* a, const float* b, float scale, int count) {
+    __asm__ volatile(
+        "mfc1    $8, %0\n"
+        "mtv     $8, S200\n"
+        : : "f"(scale) : "$8");
+    for (int i = 0; i < count; i += 4) {
+        __asm__ volatile(
+            "lv.q    C000, 0(%1)\n"
+            "lv.q    C010, 0(%2)\n"
+            "vscl.q  C010, C010, S200\n"
+            "vadd.q  C000, C000, C010\n"
+            "sv.q    C000, 0(%0)\n"
+            : : "r"(out + i), "r"(a + i), "r"(b + i) : "memory");
+    }
+}
+
+static int BatchMath_AddScaledSimd(Vector3Array out, Vector3Array a, Vector3Array b, float scale, int count) {
+    if (!BatchMath_Aligned(out.x, out.y, out.z) || !BatchMath_Aligned(a.x, a.y, a.z) ||
+        !BatchMath_Aligned(b.x, b.y, b.z)) {
+        return 0;
+    }
+    int end = count & ~3;
+    BatchMath_AddScaledVfpu(out.x, a.x, b.x, scale, end);
+    BatchMath_AddScaledVfpu(out.y, a.y, b.y, scale, end);
+    BatchMath_AddScaledVfpu(out.z, a.z, b.z, scale, end);
+    return end;
+}
+
+static int BatchMath_TransformSimd(Vector3Array out, Vector3Array in, const Matrix* m, int count) {
+    if (!BatchMath_Aligned(out.x, out.y, out.z) || !BatchMath_Aligned(in.x, in.y, in.z)) {
+        return 0;
+    }
+
+    // Rows of the 3x3 part as scalars; translations broadcast to all lanes
+    __asm__ volatile(
+        "lv.s    S200, 0(%0)\n"
+        "lv.s    S201, 4(%0)\n"
+        "lv.s    S202, 8(%0)\n"
+        "lv.s    S210, 16(%0)\n"
+        "lv.s    S211, 20(%0)\n"
+        "lv.s    S212, 24(%0)\n"
+        "lv.s    S220, 32(%0)\n"
+        "lv.s    S221, 36(%0)\n"
+        "lv.s    S222, 40(%0)\n"
+        "lv.s    S300, 12(%0)\n"
+        "lv.s    S301, 12(%0)\n"
+        "lv.s    S302, 12(%0)\n"
+        "lv.s    S303, 12(%0)\n"
+        "lv.s    S310, 28(%0)\n"
+        "lv.s    S311, 28(%0)\n"
+        "lv.s    S312, 28(%0)\n"
+        "lv.s    S313, 28(%0)\n"
+        "lv.s    S320, 44(%0)\n"
+        "lv.s    S321, 44(%0)\n"
+        "lv.s    S322, 44(%0)\n"
+        "lv.s    S323, 44(%0)\n"
+        : : "r"(m) : "memory");
+
+    int end = count & ~3;
+    for (int i = 0; i < end; i += 4) {
+        // All inputs are loaded before the first store, so out may be in
+        __asm__ volatile(
+            "lv.q    C000, 0(%3)\n"
+            "lv.q    C010, 0(%4)\n"
+            "lv.q    C020, 0(%5)\n"
+            "vscl.q  C100, C000, S200\n"
+            "vscl.q  C110, C010, S201\n"
+            "vadd.q  C100, C100, C110\n"
+            "vscl.q  C110, C020, S202\n"
+            "vadd.q  C100, C100, C110\n"
+            "vadd.q  C100, C100, C300\n"
+            "vscl.q  C120, C000, S210\n"
+            "vscl.q  C110, C010, S211\n"
+            "vadd.q  C120, C120, C110\n"
+            "vscl.q  C110, C020, S212\n"
+            "vadd.q  C120, C120, C110\n"
+            "vadd.q  C120, C120, C310\n"
+            "vscl.q  C130, C000, S220\n"
+            "vscl.q  C110, C010, S221\n"
+            "vadd.q  C130, C130, C110\n"
+            "vscl.q  C110, C020, S222\n"
+            "vadd.q  C130, C130, C110\n"
+            "vadd.q  C130, C130, C320\n"
+            "sv.q    C100, 0(%0)\n"
+            "sv.q    C120, 0(%1)\n"
+            "sv.q    C130, 0(%2)\n"
+            : : "r"(out.x + i), "r"(out.y + i), "r"(out.z + i), "r"(in.x + i), "r"(in.y + i), "r"(in.z + i)
+            : "memory");
+    }
+    return end;
+}
+
+// The VFPU's square root and reciprocal are approximations, and a matrix
+// product per element gains little over the FPU: both stay in plain C
+static int BatchMath_NormalizeSimd(Vector3Array v, int count) {
+    (void)v;
+    (void)count;
+    return 0;
+}
+
+static int BatchMath_MultiplySimd(Matrix* out, const Matrix* left, const Matrix* right, int count) {
+    (void)out;
+    (void)left;
+    (void)right;
+    (void)count;
+    return 0;
+}
+
+#endif
+
+void BatchMath_AddScaled(Vector3Array out, Vector3Array a, Vector3Array b, float scale, int count) {
+    int first = 0;
+#if BATCH_MATH_PATH != BATCH_MATH_PATH_SCALAR
+    first = BatchMath_AddScaledSimd(out, a, b, scale, count);
+#endif
+    BatchMath_AddScaledScalar(out, a, b, scale, first, count);
+}
+
+void BatchMath_Transform(Vector3Array out, Vector3Array in, const Matrix* m, int count) {
+    int first = 0;
+#if BATCH_MATH_PATH != BATCH_MATH_PATH_SCALAR
+    first = BatchMath_TransformSimd(out, in, m, count);
+#endif
+    BatchMath_TransformScalar(out, in, m, first, count);
+}
+
+void BatchMath_Normalize(Vector3Array v, int count) {
+    int first = 0;
+#if BATCH_MATH_PATH != BATCH_MATH_PATH_SCALAR
+    first = BatchMath_NormalizeSimd(v, count);
+#endif
+    BatchMath_NormalizeScalar(v, first, count);
+}
+
+void BatchMath_MultiplyMatrices(Matrix* out, const Matrix* left, const Matrix* right, int count) {
+    int first = 0;
+#if BATCH_MATH_PATH != BATCH_MATH_PATH_SCALAR
+    first = BatchMath_MultiplySimd(out, left, right, count);
+#endif
+    BatchMath_MultiplyScalar(out, left, right, first, count);
+}
+
+const char* BatchMath_GetPathName(void) {
+    static const char* names[] = {"scalar", "sse", "neon", "vfpu"};
+    return names[BATCH_MATH_PATH];
+}
@@ -80,3 +80,24 @@ void Camera_UpdateControls(CameraComponent* camera, KeyBindingSystem* keybinds,
         camera->camera.target = Vector3Add(camera->camera.position, Vector3Scale(direction, distance));
     }
 }
+
+void Camera_BeginTick(CameraComponent* camera, const ECSWorld* world) {
+    if (camera->previousTick != world->tick) {
+        camera->previous = camera->camera;
+        camera->previousTick = world->tick;
+    }
+}
+
+Camera3D Camera_GetRenderCamera(const CameraComponent* camera, const ECSWorld* world) {
+    float t = world->interpolation;
+    if (t >= 1.0f || camera->previousTick != world->tick) {
+        return camera->camera;
+    }
+
+    Camera3D result = camera->camera;
+    result.position = Vector3Lerp(camera->previous.position, camera->camera.position, t);
+    result.target = Vector3Lerp(camera->previous.target, camera->camera.target, t);
+    result.up = Vector3Lerp(camera->previous.up, camera->camera.up, t);
+    result.fovy = camera->previous.fovy + (camera->camera.fovy - camera->previous.fovy) * t;
+    return result;
+}
@@ -0,0 +1,102 @@
+#include "culling.h"
+#include <float.h>
+#include <math.h>
+
+static Vector3 Culling_Sub(Vector3 a, Vector3 b) {
+    return (Vector3){a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+static Vector3 Culling_AddScaled(Vector3 a, Vector3 b, float s) {
+    return (Vector3){a.x + b.x * s, a.y + b.y * s, a.z + b.z * s};
+}
+
+static Vector3 Culling_Cross(Vector3 a, Vector3 b) {
+    return (Vector3){a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+static float Culling_Dot(Vector3 a, Vector3 b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static Vector3 Culling_Normalize(Vector3 v) {
+    float length = sqrtf(Culling_Dot(v, v));
+    if (length <= 0.0f) return v;
+    return (Vector3){v.x / length, v.y / length, v.z / length};
+}
+
+// Plane through `point` with inward normal `normal`
+static Vector4 Culling_Plane(Vector3 normal, Vector3 point) {
+    normal = Culling_Normalize(normal);
+    return (Vector4){normal.x, normal.y, normal.z, -Culling_Dot(normal, point)};
+}
+
+Frustum Culling_FrustumFromCamera(const Camera3D* camera, float aspect, float nearPlane, float farPlane) {
+    Frustum frustum;
+
+    // Camera basis, matching the lookAt raylib builds for BeginMode3D
+    Vector3 forward = Culling_Normalize(Culling_Sub(camera->target, camera->position));
+    Vector3 right = Culling_Normalize(Culling_Cross(forward, camera->up));
+    Vector3 up = Culling_Cross(right, forward);
+    Vector3 eye = camera->position;
+
+    frustum.planes[FRUSTUM_NEAR] = Culling_Plane(forward, Culling_AddScaled(eye, forward, nearPlane));
+    frustum.planes[FRUSTUM_FAR] = Culling_Plane((Vector3){-forward.x, -forward.y, -forward.z},
+                                                Culling_AddScaled(eye, forward, farPlane));
+
+    if (camera->projection == CAMERA_ORTHOGRAPHIC) {
+        // fovy is the view height in world units
+        float halfHeight = camera->fovy * 0.5f;
+        float halfWidth = halfHeight * aspect;
+        Vector3 left = {-right.x, -right.y, -right.z};
+        Vector3 down = {-up.x, -up.y, -up.z};
+
+        frustum.planes[FRUSTUM_LEFT] = Culling_Plane(right, Culling_AddScaled(eye, right, -halfWidth));
+        frustum.planes[FRUSTUM_RIGHT] = Culling_Plane(left, Culling_AddScaled(eye, right, halfWidth));
+        frustum.planes[FRUSTUM_TOP] = Culling_Plane(down, Culling_AddScaled(eye, up, halfHeight));
+        frustum.planes[FRUSTUM_BOTTOM] = Culling_Plane(up, Culling_AddScaled(eye, up, -halfHeight));
+        frustum.screenScale = 1.0f / camera->fovy;
+        frustum.orthographic = true;
+    } else {
+        // Side planes pass through the eye along each edge direction of the view volume
+        float halfV = tanf(camera->fovy * DEG2RAD * 0.5f);
+        float halfH = halfV * aspect;
+
+        frustum.planes[FRUSTUM_LEFT] = Culling_Plane(Culling_Cross(Culling_AddScaled(forward, right, -halfH), up), eye);
+        frustum.planes[FRUSTUM_RIGHT] = Culling_Plane(Culling_Cross(up, Culling_AddScaled(forward, right, halfH)), eye);
+        frustum.planes[FRUSTUM_TOP] = Culling_Plane(Culling_Cross(Culling_AddScaled(forward, up, halfV), right), eye);
+        frustum.planes[FRUSTUM_BOTTOM] = Culling_Plane(Culling_Cross(right, Culling_AddScaled(forward, up, -halfV)), eye);
+        frustum.screenScale = 0.5f / halfV;
+        frustum.orthographic = false;
+    }
+    frustum.nearDistance = nearPlane;
+
+    return frustum;
+}
+
+bool Culling_TestAABB(const Frustum* frustum, Vector3 center, Vector3 halfExtents) {
+    for (int i = 0; i < FRUSTUM_PLANE_COUNT; i++) {
+        const Vector4* plane = &frustum->planes[i];
+
+        // Distance of the box corner furthest along the plane normal
+        float reach = fabsf(plane->x) * halfExtents.x + fabsf(plane->y) * halfExtents.y + fabsf(plane->z) * halfExtents.z;
+        float distance = plane->x * center.x + plane->y * center.y + plane->z * center.z + plane->w;
+        if (distance + reach < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+float Culling_ScreenSize(const Frustum* frustum, Vector3 center, float radius) {
+    if (frustum->orthographic) {
+        return 2.0f * radius * frustum->screenScale;
+    }
+
+    // View depth: distance past the near plane plus the near plane's own
+    const Vector4* plane = &frustum->planes[FRUSTUM_NEAR];
+    float depth = plane->x * center.x + plane->y * center.y + plane->z * center.z + plane->w + frustum->nearDistance;
+    if (depth <= radius) {
+        return FLT_MAX;
+    }
+    return 2.0f * radius * frustum->screenScale / depth;
+}
@@ -1,111 +1,99 @@
 #include "ecs.h"
+#include "ecs_archetype.h"
+#include "render_batch.h"
+#include "render_queue.h"
+#include "profiler.h"
+#include "mesh_cache.h"
+#include "static_bvh.h"
+#include "hierarchy.h"
 #include <rlgl.h>
-#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
 #include <string.h>
 
-static void DrawPlaneWireframe(Vector3 center, Vector2 size, Color color) {
-    float halfWidth = size.x * 0.5f;
-    float halfLength = size.y * 0.5f;
+static const size_t g_componentSizes[COMPONENT_COUNT] = {
+    sizeof(TransformComponent),
+    sizeof(RenderableComponent),
+    sizeof(CameraComponent),
+    sizeof(InputComponent),
+    sizeof(StaticComponent),
+    sizeof(HierarchyComponent)
+};
 
-    rlBegin(RL_LINES);
-    rlColor4ub(color.r, color.g, color.b, color.a);
-    rlVertex3f(center.x - halfWidth, center.y, center.z - halfLength);
-    rlVertex3f(center.x + halfWidth, center.y, center.z - halfLength);
+// Source of query versions; global so a rebuilt world never repeats one
+static unsigned int g_queryVersion;
 
-    rlVertex3f(center.x + halfWidth, center.y, center.z - halfLength);
-    rlVertex3f(center.x + halfWidth, center.y, center.z + halfLength);
-
-    rlVertex3f(center.x + halfWidth, center.y, center.z + halfLength);
-    rlVertex3f(center.x - halfWidth, center.y, center.z + halfLength);
-
-    rlVertex3f(center.x - halfWidth, center.y, center.z + halfLength);
-    rlVertex3f(center.x - halfWidth, center.y, center.z - halfLength);
-    rlEnd();
+static bool ECS_QueryMatches(const ECSQuery* query, unsigned int mask) {
+    return (mask & query->required) == query->required && (mask & query->excluded) == 0;
 }
 
-void ECS_Init(ECSWorld* world) {
-    memset(world, 0, sizeof(ECSWorld));
-    world->entityCount = 0;
+// Pages per pool slab: one at a time for small worlds, batches of up to
+// 16 for large ones
+static int ECS_SlabPages(int capacity) {
+    int pages = capacity / ECS_PAGE_SIZE;
+    if (pages < 1) return 1;
+    return pages < 16 ? pages : 16;
 }
 
-EntityID ECS_CreateEntity(ECSWorld* world) {
-    if (world->entityCount >= MAX_ENTITIES) {
-        return -1;
-    }
-    
-    for (int i = 0; i < MAX_ENTITIES; i++) {
-        if (!world->entities[i].active) {
-            world->entities[i].active = true;
-            world->entities[i].componentMask = 0;
-            memset(world->entities[i].components, 0, sizeof(void*) * COMPONENT_COUNT);
-            world->entityCount++;
-            return i;
+#if !ECS_ARCHETYPE_STORAGE
+// Sparse index page with every entry marked absent
+static int* ECS_AllocSparsePage(ECSWorld* world) {
+    int* page = (int*)MemPool_Alloc(&world->indexPool);
+    if (page) {
+        for (int i = 0; i < ECS_PAGE_SIZE; i++) {
+            page[i] = -1;
         }
     }
-    
-    return -1;
+    return page;
 }
+#endif
 
-void ECS_DestroyEntity(ECSWorld* world, EntityID id) {
-    if (id < 0 || id >= MAX_ENTITIES || !world->entities[id].active) {
-        return;
-    }
-    
-    // Free all components
-    for (int i = 0; i < COMPONENT_COUNT; i++) {
-        if (world->entities[id].components[i] != NULL) {
-            free(world->entities[id].components[i]);
-            world->entities[id].components[i] = NULL;
-        }
-    }
-    
-    world->entities[id].active = false;
-    world->entities[id].componentMask = 0;
-    world->entityCount--;
+static Entity* ECS_EntitySlot(ECSWorld* world, int index) {
+    return &world->entityPages[ECS_PAGE(index)][ECS_PAGE_OFFSET(index)];
 }
 
-void* ECS_AddComponent(ECSWorld* world, EntityID id, ComponentType type) {
-    if (id < 0 || id >= MAX_ENTITIES || !world->entities[id].active) {
+// Returns the entity a live ID refers to, or NULL for invalid/stale IDs
+static Entity* ECS_ResolveEntity(ECSWorld* world, EntityID id) {
+    if (id < 0) {
         return NULL;
     }
-    
-    if (world->entities[id].components[type] != NULL) {
-        return world->entities[id].components[type];
+
+    int index = ECS_ENTITY_INDEX(id);
+    if (index >= world->unusedHead) {
+        return NULL;
     }
-    
-    void* component = NULL;
-    size_t size = 0;
-    
+
+    Entity* entity = ECS_EntitySlot(world, index);
+    if (!entity->active || entity->generation != ECS_ENTITY_GENERATION(id)) {
+        return NULL;
+    }
+
+    return entity;
+}
+
+static void ECS_InitComponent(ComponentType type, void* component) {
     switch (type) {
-        case COMPONENT_TRANSFORM:
-            size = sizeof(TransformComponent);
-            component = malloc(size);
-            if (!component) {
-                // Memory allocation failed - critical on PSP with limited RAM
-                return NULL;
-            }
+        case COMPONENT_TRANSFORM: {
             TransformComponent* transform = (TransformComponent*)component;
             transform->position = (Vector3){0, 0, 0};
             transform->rotation = (Vector3){0, 0, 0};
             transform->scale = (Vector3){1, 1, 1};
+            transform->world = (Matrix){1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 0,  0, 0, 0, 1};
+            transform->previous = transform->world;
+            transform->worldTick = 0;
+            transform->dirty = false;
             break;
-        case COMPONENT_RENDERABLE:
-            size = sizeof(RenderableComponent);
-            component = malloc(size);
-            if (!component) {
-                return NULL;
-            }
+        }
+        case COMPONENT_RENDERABLE: {
             RenderableComponent* renderable = (RenderableComponent*)component;
             renderable->type = RENDERABLE_CUBE;
             renderable->color = WHITE;
             renderable->size = (Vector3){1, 1, 1};
+            renderable->lod = 0;
             break;
-        case COMPONENT_CAMERA:
-            size = sizeof(CameraComponent);
-            component = malloc(size);
-            if (!component) {
-                return NULL;
-            }
+        }
+        case COMPONENT_CAMERA: {
             CameraComponent* camera = (CameraComponent*)component;
             camera->camera.position = (Vector3){10.0f, 10.0f, 10.0f};
             camera->camera.target = (Vector3){0.0f, 0.0f, 0.0f};
@@ -115,101 +103,1282 @@ void* ECS_AddComponent(ECSWorld* world, EntityID id, ComponentType type) {
             camera->moveSpeed = 5.0f;
             camera->lookSpeed = 2.0f;
             camera->pitch = 0.0f;
+            camera->previous = camera->camera;
+            camera->previousTick = 0;
             break;
-        case COMPONENT_INPUT:
-            size = sizeof(InputComponent);
-            component = malloc(size);
-            if (!component) {
-                return NULL;
-            }
+        }
+        case COMPONENT_INPUT: {
             InputComponent* input = (InputComponent*)component;
             input->active = true;
             break;
+        }
+        case COMPONENT_STATIC: {
+            StaticComponent* tag = (StaticComponent*)component;
+            tag->reserved = 0;
+            break;
+        }
+        case COMPONENT_HIERARCHY: {
+            HierarchyComponent* hierarchy = (HierarchyComponent*)component;
+            hierarchy->parent = ECS_INVALID_ENTITY;
+            hierarchy->slot = -1;
+            break;
+        }
         default:
+            break;
+    }
+}
+
+#if ECS_ARCHETYPE_STORAGE
+
+// Removes a row and patches the row of whichever entity was swapped into it
+static void ECS_ArchetypeDetach(ECSWorld* world, unsigned int mask, int row) {
+    EntityID moved = Archetype_Remove(&world->archetypes[mask], &world->chunkPool, row);
+    if (moved != ECS_INVALID_ENTITY) {
+        ECS_EntitySlot(world, ECS_ENTITY_INDEX(moved))->row = row;
+    }
+}
+
+// Moves an entity's shared components to the archetype for newMask
+static bool ECS_ArchetypeMove(ECSWorld* world, Entity* entity, EntityID id, unsigned int newMask) {
+    unsigned int oldMask = entity->componentMask;
+    int newRow = -1;
+
+    if (newMask != 0) {
+        Archetype* to = &world->archetypes[newMask];
+        newRow = Archetype_Insert(to, &world->chunkPool, id);
+        if (newRow < 0) {
+            return false;
+        }
+
+        if (oldMask != 0) {
+            const Archetype* from = &world->archetypes[oldMask];
+            unsigned int shared = oldMask & newMask;
+            for (int type = 0; type < COMPONENT_COUNT; type++) {
+                if (shared & COMPONENT_BIT(type)) {
+                    memcpy(Archetype_GetComponent(to, newRow, (ComponentType)type),
+                           Archetype_GetComponent(from, entity->row, (ComponentType)type),
+                           g_componentSizes[type]);
+                }
+            }
+        }
+    }
+
+    if (oldMask != 0) {
+        ECS_ArchetypeDetach(world, oldMask, entity->row);
+    }
+
+    entity->row = newRow;
+    return true;
+}
+
+static bool ECS_StorageAddPage(ECSWorld* world, int page) {
+    // Archetype rows are addressed through Entity.row, no per-page index
+    (void)world; (void)page;
+    return true;
+}
+
+static void* ECS_StorageAdd(ECSWorld* world, Entity* entity, EntityID id, ComponentType type) {
+    if (!ECS_ArchetypeMove(world, entity, id, entity->componentMask | COMPONENT_BIT(type))) {
+        return NULL;
+    }
+    return Archetype_GetComponent(&world->archetypes[entity->componentMask | COMPONENT_BIT(type)], entity->row, type);
+}
+
+static void* ECS_StorageGet(ECSWorld* world, const Entity* entity, EntityID id, ComponentType type) {
+    (void)id;
+    return Archetype_GetComponent(&world->archetypes[entity->componentMask], entity->row, type);
+}
+
+static bool ECS_StorageRemove(ECSWorld* world, Entity* entity, EntityID id, ComponentType type) {
+    return ECS_ArchetypeMove(world, entity, id, entity->componentMask & ~COMPONENT_BIT(type));
+}
+
+static void ECS_StorageRemoveAll(ECSWorld* world, Entity* entity, EntityID id) {
+    (void)id;
+    if (entity->componentMask != 0) {
+        ECS_ArchetypeDetach(world, entity->componentMask, entity->row);
+    }
+    entity->row = -1;
+}
+
+static void ECS_StorageInit(ECSWorld* world) {
+    for (int mask = 0; mask < ECS_ARCHETYPE_COUNT; mask++) {
+        Archetype_Init(&world->archetypes[mask], (unsigned int)mask);
+    }
+    MemPool_Init(&world->chunkPool, MEM_SUBSYSTEM_ECS, ECS_CHUNK_SIZE, ECS_SlabPages(world->capacity));
+}
+
+static void ECS_StorageRelease(ECSWorld* world) {
+    for (int mask = 0; mask < ECS_ARCHETYPE_COUNT; mask++) {
+        Archetype_Release(&world->archetypes[mask], &world->chunkPool);
+    }
+    MemPool_Release(&world->chunkPool);
+}
+
+static void ECS_UpdateQueries(ECSWorld* world, EntityID id, unsigned int oldMask, unsigned int newMask) {
+    // Archetype queries match whole archetypes, so only the versions need tracking
+    (void)id;
+    for (int i = 0; i < world->queryCount; i++) {
+        ECSQuery* query = &world->queries[i];
+        if (ECS_QueryMatches(query, oldMask) != ECS_QueryMatches(query, newMask)) {
+            query->version = ++g_queryVersion;
+        }
+    }
+}
+
+#else
+
+static void* ECS_SetSlot(ECSWorld* world, ComponentType type, int slot) {
+    return world->sets[type].data[ECS_PAGE(slot)] + (size_t)ECS_PAGE_OFFSET(slot) * g_componentSizes[type];
+}
+
+static int ECS_SetLookup(const ComponentSet* set, int index) {
+    return set->sparse[ECS_PAGE(index)][ECS_PAGE_OFFSET(index)];
+}
+
+static void ECS_SetRemove(ECSWorld* world, ComponentType type, EntityID id) {
+    ComponentSet* set = &world->sets[type];
+    int index = ECS_ENTITY_INDEX(id);
+    int slot = ECS_SetLookup(set, index);
+    int last = set->count - 1;
+
+    // Swap-and-pop keeps the packed range hole-free
+    if (slot != last) {
+        EntityID moved = set->dense[ECS_PAGE(last)][ECS_PAGE_OFFSET(last)];
+        int movedIndex = ECS_ENTITY_INDEX(moved);
+        memcpy(ECS_SetSlot(world, type, slot), ECS_SetSlot(world, type, last), g_componentSizes[type]);
+        set->dense[ECS_PAGE(slot)][ECS_PAGE_OFFSET(slot)] = moved;
+        set->sparse[ECS_PAGE(movedIndex)][ECS_PAGE_OFFSET(movedIndex)] = slot;
+    }
+
+    set->sparse[ECS_PAGE(index)][ECS_PAGE_OFFSET(index)] = -1;
+    set->count--;
+}
+
+// Sparse index pages mirror the entity pages, one per set
+static bool ECS_StorageAddPage(ECSWorld* world, int page) {
+    for (int type = 0; type < COMPONENT_COUNT; type++) {
+        if (!world->sets[type].sparse[page]) {
+            world->sets[type].sparse[page] = ECS_AllocSparsePage(world);
+        }
+        if (!world->sets[type].sparse[page]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void* ECS_StorageAdd(ECSWorld* world, Entity* entity, EntityID id, ComponentType type) {
+    (void)entity;
+    ComponentSet* set = &world->sets[type];
+    int slot = set->count;
+    int page = ECS_PAGE(slot);
+
+    // Dense and data pages are added as the packed range grows into them
+    if (page >= set->densePages) {
+        set->dense[page] = (EntityID*)MemPool_Alloc(&world->indexPool);
+        set->data[page] = (unsigned char*)MemPool_Alloc(&world->dataPools[type]);
+        if (!set->dense[page] || !set->data[page]) {
+            MemPool_Free(&world->indexPool, set->dense[page]);
+            MemPool_Free(&world->dataPools[type], set->data[page]);
+            set->dense[page] = NULL;
+            set->data[page] = NULL;
             return NULL;
+        }
+        set->densePages++;
+    }
+
+    int index = ECS_ENTITY_INDEX(id);
+    set->count++;
+    set->sparse[ECS_PAGE(index)][ECS_PAGE_OFFSET(index)] = slot;
+    set->dense[page][ECS_PAGE_OFFSET(slot)] = id;
+
+    return ECS_SetSlot(world, type, slot);
+}
+
+static void* ECS_StorageGet(ECSWorld* world, const Entity* entity, EntityID id, ComponentType type) {
+    (void)entity;
+    return ECS_SetSlot(world, type, ECS_SetLookup(&world->sets[type], ECS_ENTITY_INDEX(id)));
+}
+
+static bool ECS_StorageRemove(ECSWorld* world, Entity* entity, EntityID id, ComponentType type) {
+    (void)entity;
+    ECS_SetRemove(world, type, id);
+    return true;
+}
+
+static void ECS_StorageRemoveAll(ECSWorld* world, Entity* entity, EntityID id) {
+    for (int i = 0; i < COMPONENT_COUNT; i++) {
+        if (entity->componentMask & (1 << i)) {
+            ECS_SetRemove(world, (ComponentType)i, id);
+        }
+    }
+}
+
+static void ECS_StorageInit(ECSWorld* world) {
+    // Sparse and dense pages are both ECS_PAGE_SIZE ints and share a pool
+    int slabPages = ECS_SlabPages(world->capacity);
+    MemPool_Init(&world->indexPool, MEM_SUBSYSTEM_ECS, sizeof(int) * ECS_PAGE_SIZE, slabPages);
+    for (int type = 0; type < COMPONENT_COUNT; type++) {
+        MemPool_Init(&world->dataPools[type], MEM_SUBSYSTEM_ECS, g_componentSizes[type] * ECS_PAGE_SIZE, slabPages);
+    }
+}
+
+// Pages are returned wholesale by releasing the pools
+static void ECS_StorageRelease(ECSWorld* world) {
+    memset(world->sets, 0, sizeof(world->sets));
+    memset(world->queries, 0, sizeof(world->queries));
+
+    MemPool_Release(&world->indexPool);
+    for (int type = 0; type < COMPONENT_COUNT; type++) {
+        MemPool_Release(&world->dataPools[type]);
+    }
+}
+
+static bool ECS_QueryInsert(ECSWorld* world, ECSQuery* query, EntityID id) {
+    int slot = query->count;
+    int page = ECS_PAGE(slot);
+
+    if (page >= query->densePages) {
+        query->dense[page] = (EntityID*)MemPool_Alloc(&world->indexPool);
+        if (!query->dense[page]) {
+            return false;
+        }
+        query->densePages++;
+    }
+
+    int index = ECS_ENTITY_INDEX(id);
+    query->count++;
+    query->sparse[ECS_PAGE(index)][ECS_PAGE_OFFSET(index)] = slot;
+    query->dense[page][ECS_PAGE_OFFSET(slot)] = id;
+    return true;
+}
+
+static void ECS_QueryErase(ECSQuery* query, EntityID id) {
+    int index = ECS_ENTITY_INDEX(id);
+    int slot = query->sparse[ECS_PAGE(index)][ECS_PAGE_OFFSET(index)];
+    int last = query->count - 1;
+
+    if (slot < 0) {
+        return;
+    }
+
+    if (slot != last) {
+        EntityID moved = query->dense[ECS_PAGE(last)][ECS_PAGE_OFFSET(last)];
+        int movedIndex = ECS_ENTITY_INDEX(moved);
+        query->dense[ECS_PAGE(slot)][ECS_PAGE_OFFSET(slot)] = moved;
+        query->sparse[ECS_PAGE(movedIndex)][ECS_PAGE_OFFSET(movedIndex)] = slot;
+    }
+
+    query->sparse[ECS_PAGE(index)][ECS_PAGE_OFFSET(index)] = -1;
+    query->count--;
+}
+
+// Empties a query and rescans every entity into it. An insert that fails
+// leaves the query stale, to be filled again on a later lookup.
+static void ECS_FillQuery(ECSWorld* world, ECSQuery* query) {
+    for (int slot = 0; slot < query->count; slot++) {
+        int index = ECS_ENTITY_INDEX(query->dense[ECS_PAGE(slot)][ECS_PAGE_OFFSET(slot)]);
+        query->sparse[ECS_PAGE(index)][ECS_PAGE_OFFSET(index)] = -1;
+    }
+    query->count = 0;
+    query->stale = false;
+    query->version = ++g_queryVersion;
+
+    for (int i = 0; i < world->unusedHead; i++) {
+        const Entity* entity = ECS_EntitySlot(world, i);
+        if (entity->active && ECS_QueryMatches(query, entity->componentMask) &&
+            !ECS_QueryInsert(world, query, ECS_MAKE_ENTITY(i, entity->generation))) {
+            query->stale = true;
+            return;
+        }
+    }
+}
+
+// Moves an entity in/out of every cached query after its mask changed
+static void ECS_UpdateQueries(ECSWorld* world, EntityID id, unsigned int oldMask, unsigned int newMask) {
+    for (int i = 0; i < world->queryCount; i++) {
+        ECSQuery* query = &world->queries[i];
+        bool matched = ECS_QueryMatches(query, oldMask);
+        bool matches = ECS_QueryMatches(query, newMask);
+
+        // A stale query is refilled as a whole, so it skips incremental updates
+        if (query->stale) {
+            continue;
+        }
+
+        if (matches && !matched) {
+            // Out of index pages: the match is missing, so refill on the next lookup
+            if (!ECS_QueryInsert(world, query, id)) {
+                query->stale = true;
+            }
+            query->version = ++g_queryVersion;
+        } else if (matched && !matches) {
+            ECS_QueryErase(query, id);
+            query->version = ++g_queryVersion;
+        }
+    }
+}
+
+#endif // ECS_ARCHETYPE_STORAGE
+
+// Adds the next entity page along with the storage indices that mirror it
+static bool ECS_AddEntityPage(ECSWorld* world) {
+    int page = world->entityPageCount;
+
+    // Pages left over from a partially failed attempt are kept and reused
+    if (!world->entityPages[page]) {
+        Entity* entities = (Entity*)MemPool_Alloc(&world->entityPool);
+        if (!entities) {
+            return false;
+        }
+        memset(entities, 0, sizeof(Entity) * ECS_PAGE_SIZE);
+        world->entityPages[page] = entities;
+    }
+
+    if (!ECS_StorageAddPage(world, page)) {
+        return false;
+    }
+
+#if !ECS_ARCHETYPE_STORAGE
+    for (int i = 0; i < world->queryCount; i++) {
+        if (!world->queries[i].sparse[page]) {
+            world->queries[i].sparse[page] = ECS_AllocSparsePage(world);
+        }
+        if (!world->queries[i].sparse[page]) {
+            return false;
+        }
+    }
+#endif
+
+    world->entityPageCount++;
+    return true;
+}
+
+void ECS_Init(ECSWorld* world) {
+    ECS_InitWithCapacity(world, MAX_ENTITIES);
+}
+
+void ECS_InitWithCapacity(ECSWorld* world, int capacity) {
+    memset(world, 0, sizeof(ECSWorld));
+    world->entityCount = 0;
+    world->freeHead = -1;
+    world->unusedHead = 0;
+    world->tick = 1;
+    world->interpolation = 1.0f;
+    world->changesLost = true;      // Nothing saved yet to be incremental against
+
+    // Round up to whole pages and clamp to the page table
+    if (capacity < 1) capacity = 1;
+    if (capacity > ECS_MAX_CAPACITY) capacity = ECS_MAX_CAPACITY;
+    world->capacity = ((capacity + ECS_PAGE_SIZE - 1) / ECS_PAGE_SIZE) * ECS_PAGE_SIZE;
+
+    MemPool_Init(&world->entityPool, MEM_SUBSYSTEM_ECS, sizeof(Entity) * ECS_PAGE_SIZE, ECS_SlabPages(world->capacity));
+    ECS_StorageInit(world);
+}
+
+int ECS_GetCapacity(ECSWorld* world) {
+    return world->capacity;
+}
+
+// Records a change to the entity in `index`, listing the slot on its first
+// change. Nothing is listed while changes are lost anyway.
+// Systems that do not conflict may mark changes from several threads at once
+// (scheduler.h), so the flag bits are set atomically and each slot claims its
+// list entry with one fetch-and-add. The PSP runs every system on one thread.
+static unsigned char ECS_FetchOrFlags(unsigned char* flags, unsigned char bits) {
+#if defined(__PSP__)
+    unsigned char old = *flags;
+    *flags = (unsigned char)(old | bits);
+    return old;
+#else
+    return __atomic_fetch_or(flags, bits, __ATOMIC_RELAXED);
+#endif
+}
+
+static int ECS_FetchAddCount(int* count) {
+#if defined(__PSP__)
+    return (*count)++;
+#else
+    return __atomic_fetch_add(count, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+// A slot is listed at most once between clears and the list holds the
+// world's capacity, so the entry claimed is always in range
+static void ECS_NoteChange(ECSWorld* world, Entity* entity, int index, unsigned int bits) {
+    if (bits) {
+        ECS_FetchOrFlags(&entity->changedMask, (unsigned char)bits);
+    }
+    if (world->changesLost || (ECS_FetchOrFlags(&entity->changeFlags, ECS_CHANGE_LISTED) & ECS_CHANGE_LISTED)) {
+        return;
+    }
+    world->changedSlots[ECS_FetchAddCount(&world->changedSlotCount)] = index;
+}
+
+EntityID ECS_CreateEntity(ECSWorld* world) {
+    int index;
+
+    // Reuse the most recently destroyed slot, otherwise take a fresh one
+    if (world->freeHead >= 0) {
+        index = world->freeHead;
+        world->freeHead = ECS_EntitySlot(world, index)->nextFree;
+    } else if (world->unusedHead < world->capacity) {
+        if (ECS_PAGE(world->unusedHead) >= world->entityPageCount && !ECS_AddEntityPage(world)) {
+            // Memory allocation failed - critical on PSP with limited RAM
+            return ECS_INVALID_ENTITY;
+        }
+        index = world->unusedHead++;
+    } else {
+        return ECS_INVALID_ENTITY;
+    }
+
+    Entity* entity = ECS_EntitySlot(world, index);
+    entity->active = true;
+    entity->componentMask = 0;
+    entity->nextFree = -1;
+#if ECS_ARCHETYPE_STORAGE
+    entity->row = -1;
+#endif
+    world->entityCount++;
+    entity->changedMask = 0;
+    entity->changeFlags |= ECS_CHANGE_CREATED;
+    ECS_NoteChange(world, entity, index, 0);
+
+    return ECS_MAKE_ENTITY(index, entity->generation);
+}
+
+// The node stays in place until the next update compacts the array; its
+// children become roots there
+static void ECS_DropHierarchyNode(ECSWorld* world, int slot) {
+    if (slot >= 0) {
+        world->hierarchyNodes[slot].entity = ECS_INVALID_ENTITY;
+        world->hierarchyCompact = true;
+    }
+}
+
+void ECS_DestroyEntity(ECSWorld* world, EntityID id) {
+    Entity* entity = ECS_ResolveEntity(world, id);
+    if (!entity) {
+        return;
     }
     
-    world->entities[id].components[type] = component;
-    world->entities[id].componentMask |= (1 << type);
+    // Release all components
+    if (entity->componentMask & COMPONENT_BIT(COMPONENT_HIERARCHY)) {
+        ECS_DropHierarchyNode(world, ((const HierarchyComponent*)ECS_StorageGet(world, entity, id, COMPONENT_HIERARCHY))->slot);
+    }
+    ECS_StorageRemoveAll(world, entity, id);
+    ECS_UpdateQueries(world, id, entity->componentMask, 0);
+    
+    int index = ECS_ENTITY_INDEX(id);
+    ECS_NoteChange(world, entity, index, 0);
+    entity->active = false;
+    entity->componentMask = 0;
+    entity->changedMask = 0;
+    entity->generation = (unsigned short)((entity->generation + 1) & ECS_ENTITY_GENERATION_MASK);
+    entity->nextFree = world->freeHead;
+    world->freeHead = index;
+    world->entityCount--;
+}
+
+void* ECS_AddComponent(ECSWorld* world, EntityID id, ComponentType type) {
+    Entity* entity = ECS_ResolveEntity(world, id);
+    if (!entity) {
+        return NULL;
+    }
+
+    if (type < 0 || type >= COMPONENT_COUNT) {
+        return NULL;
+    }
+    
+    if (entity->componentMask & (1 << type)) {
+        return ECS_StorageGet(world, entity, id, type);
+    }
+    
+    void* component = ECS_StorageAdd(world, entity, id, type);
+    if (!component) {
+        // Memory allocation failed - critical on PSP with limited RAM
+        return NULL;
+    }
+
+    ECS_InitComponent(type, component);
+    
+    unsigned int oldMask = entity->componentMask;
+    entity->componentMask |= (1 << type);
+    ECS_UpdateQueries(world, id, oldMask, entity->componentMask);
+    ECS_NoteChange(world, entity, ECS_ENTITY_INDEX(id), COMPONENT_BIT(type));
+
+    // Callers set the fields next; the matrix is built on the next update
+    if (type == COMPONENT_TRANSFORM) {
+        ECS_MarkTransformDirty(world, id);
+    }
     
     return component;
 }
 
 void* ECS_GetComponent(ECSWorld* world, EntityID id, ComponentType type) {
-    if (id < 0 || id >= MAX_ENTITIES || !world->entities[id].active) {
+    Entity* entity = ECS_ResolveEntity(world, id);
+    if (!entity) {
+        return NULL;
+    }
+
+    if (!(entity->componentMask & (1 << type))) {
         return NULL;
     }
     
-    return world->entities[id].components[type];
+    return ECS_StorageGet(world, entity, id, type);
 }
 
 bool ECS_HasComponent(ECSWorld* world, EntityID id, ComponentType type) {
-    if (id < 0 || id >= MAX_ENTITIES || !world->entities[id].active) {
+    Entity* entity = ECS_ResolveEntity(world, id);
+    if (!entity) {
         return false;
     }
     
-    return (world->entities[id].componentMask & (1 << type)) != 0;
+    return (entity->componentMask & (1 << type)) != 0;
+}
+
+bool ECS_IsEntityValid(ECSWorld* world, EntityID id) {
+    return ECS_ResolveEntity(world, id) != NULL;
+}
+
+unsigned int ECS_GetComponentMask(ECSWorld* world, EntityID id) {
+    Entity* entity = ECS_ResolveEntity(world, id);
+    return entity ? entity->componentMask : 0;
+}
+
+size_t ECS_GetComponentSize(ComponentType type) {
+    if (type < 0 || type >= COMPONENT_COUNT) {
+        return 0;
+    }
+    return g_componentSizes[type];
 }
 
 void ECS_RemoveComponent(ECSWorld* world, EntityID id, ComponentType type) {
-    if (id < 0 || id >= MAX_ENTITIES || !world->entities[id].active) {
+    Entity* entity = ECS_ResolveEntity(world, id);
+    if (!entity) {
         return;
     }
     
-    if (world->entities[id].components[type] != NULL) {
-        free(world->entities[id].components[type]);
-        world->entities[id].components[type] = NULL;
-        world->entities[id].componentMask &= ~(1 << type);
-    }
-}
-
-void System_Render(ECSWorld* world) {
-    // Render all entities with transform and renderable components
-    for (int i = 0; i < MAX_ENTITIES; i++) {
-        if (!world->entities[i].active) continue;
-        
-        if (ECS_HasComponent(world, i, COMPONENT_TRANSFORM) && 
-            ECS_HasComponent(world, i, COMPONENT_RENDERABLE)) {
-            
-            TransformComponent* transform = (TransformComponent*)ECS_GetComponent(world, i, COMPONENT_TRANSFORM);
-            RenderableComponent* renderable = (RenderableComponent*)ECS_GetComponent(world, i, COMPONENT_RENDERABLE);
-            
-            if (transform && renderable) {
-                switch (renderable->type) {
-                    case RENDERABLE_CUBE:
-                        DrawCube(transform->position, 
-                                renderable->size.x, 
-                                renderable->size.y, 
-                                renderable->size.z, 
-                                renderable->color);
-                        DrawCubeWires(transform->position, 
-                                     renderable->size.x, 
-                                     renderable->size.y, 
-                                     renderable->size.z, 
-                                     BLACK);
-                        break;
-                    case RENDERABLE_GRID:
-                        DrawGrid(10, 5.0f);
-                        break;
-                    case RENDERABLE_PLANE: {
-                        Vector2 size = {renderable->size.x, renderable->size.z};
-                        DrawPlane(transform->position, size, renderable->color);
-                        DrawPlaneWireframe(transform->position, size, (Color){80, 80, 80, 255});
-                        break;
-                    }
-                    default:
-                        break;
+    if (entity->componentMask & (1 << type)) {
+        int hierarchySlot = -1;
+        if (type == COMPONENT_HIERARCHY) {
+            hierarchySlot = ((const HierarchyComponent*)ECS_StorageGet(world, entity, id, type))->slot;
+        }
+
+        // Archetype storage may need a chunk for the smaller archetype;
+        // if that fails the entity keeps the component
+        if (!ECS_StorageRemove(world, entity, id, type)) {
+            return;
+        }
+        ECS_DropHierarchyNode(world, hierarchySlot);
+
+        unsigned int oldMask = entity->componentMask;
+        entity->componentMask &= ~(1 << type);
+        ECS_UpdateQueries(world, id, oldMask, entity->componentMask);
+        ECS_NoteChange(world, entity, ECS_ENTITY_INDEX(id), COMPONENT_BIT(type));
+
+        // Unparented: the transform is world-space again
+        if (hierarchySlot >= 0) {
+            TransformComponent* transform = (TransformComponent*)ECS_GetComponent(world, id, COMPONENT_TRANSFORM);
+            if (transform) {
+                transform->dirty = false;
+                ECS_MarkTransformDirty(world, id);
+            }
+        }
+    }
+}
+
+void ECS_MarkTransformDirty(ECSWorld* world, EntityID id) {
+    Entity* entity = ECS_ResolveEntity(world, id);
+    if (!entity || !(entity->componentMask & COMPONENT_BIT(COMPONENT_TRANSFORM))) {
+        return;
+    }
+    ECS_NoteChange(world, entity, ECS_ENTITY_INDEX(id), COMPONENT_BIT(COMPONENT_TRANSFORM));
+
+    TransformComponent* transform = (TransformComponent*)ECS_StorageGet(world, entity, id, COMPONENT_TRANSFORM);
+    if (transform->dirty) {
+        return;
+    }
+    transform->dirty = true;
+
+    // Parented transforms are rebuilt by the hierarchy sweep, with their subtrees
+    const HierarchyComponent* hierarchy = (const HierarchyComponent*)ECS_GetComponent(world, id, COMPONENT_HIERARCHY);
+    if (hierarchy && hierarchy->slot >= 0) {
+        world->hierarchyNodes[hierarchy->slot].dirty = true;
+        world->hierarchyDirty = true;
+        return;
+    }
+
+    if (world->dirtyTransformCount == world->dirtyTransformCapacity) {
+        int capacity = world->dirtyTransformCapacity > 0 ? world->dirtyTransformCapacity * 2 : 256;
+        EntityID* ids = (EntityID*)Mem_Realloc(MEM_SUBSYSTEM_ECS, world->dirtyTransforms,
+                                               sizeof(EntityID) * (size_t)world->dirtyTransformCapacity,
+                                               sizeof(EntityID) * (size_t)capacity);
+        if (!ids) {
+            // The flag is set; the next update finds it by scanning
+            world->dirtyTransformOverflow = true;
+            return;
+        }
+        world->dirtyTransforms = ids;
+        world->dirtyTransformCapacity = capacity;
+    }
+    world->dirtyTransforms[world->dirtyTransformCount++] = id;
+}
+
+void ECS_MarkChanged(ECSWorld* world, EntityID id, ComponentType type) {
+    Entity* entity = ECS_ResolveEntity(world, id);
+    if (entity && (entity->componentMask & COMPONENT_BIT(type))) {
+        ECS_NoteChange(world, entity, ECS_ENTITY_INDEX(id), COMPONENT_BIT(type));
+    }
+}
+
+void ECS_GetChange(ECSWorld* world, int i, ECSChange* change) {
+    int slot = world->changedSlots[i];
+    const Entity* entity = ECS_EntitySlot(world, slot);
+    change->slot = slot;
+    change->entity = entity->active ? ECS_MAKE_ENTITY(slot, entity->generation) : ECS_INVALID_ENTITY;
+    change->changedMask = entity->changedMask;
+    change->created = (entity->changeFlags & ECS_CHANGE_CREATED) != 0;
+}
+
+void ECS_ClearChanges(ECSWorld* world) {
+    if (world->changesLost) {
+        for (int i = 0; i < world->unusedHead; i++) {
+            Entity* entity = ECS_EntitySlot(world, i);
+            entity->changedMask = 0;
+            entity->changeFlags = 0;
+        }
+        world->changesLost = false;
+    } else {
+        for (int i = 0; i < world->changedSlotCount; i++) {
+            Entity* entity = ECS_EntitySlot(world, world->changedSlots[i]);
+            entity->changedMask = 0;
+            entity->changeFlags = 0;
+        }
+    }
+    world->changedSlotCount = 0;
+
+    // Sized once, here on the main thread, so marking never has to grow it
+    if (world->changedSlotCapacity < world->capacity) {
+        int* slots = (int*)Mem_Realloc(MEM_SUBSYSTEM_ECS, world->changedSlots,
+                                       sizeof(int) * (size_t)world->changedSlotCapacity,
+                                       sizeof(int) * (size_t)world->capacity);
+        if (!slots) {
+            world->changesLost = true;
+            return;
+        }
+        world->changedSlots = slots;
+        world->changedSlotCapacity = world->capacity;
+    }
+}
+
+static EntityID ECS_ScanEntities(ECSWorld* world, int start) {
+    for (int i = start; i < world->unusedHead; i++) {
+        const Entity* entity = ECS_EntitySlot(world, i);
+        if (entity->active) {
+            return ECS_MAKE_ENTITY(i, entity->generation);
+        }
+    }
+    return ECS_INVALID_ENTITY;
+}
+
+EntityID ECS_FirstEntity(ECSWorld* world) {
+    return ECS_ScanEntities(world, 0);
+}
+
+EntityID ECS_NextEntity(ECSWorld* world, EntityID id) {
+    if (id < 0) {
+        return ECS_INVALID_ENTITY;
+    }
+    return ECS_ScanEntities(world, ECS_ENTITY_INDEX(id) + 1);
+}
+
+ECSQuery* ECS_GetQuery(ECSWorld* world, unsigned int required) {
+    return ECS_GetQueryExcluding(world, required, 0);
+}
+
+ECSQuery* ECS_GetQueryExcluding(ECSWorld* world, unsigned int required, unsigned int excluded) {
+    for (int i = 0; i < world->queryCount; i++) {
+        ECSQuery* query = &world->queries[i];
+        if (query->required == required && query->excluded == excluded) {
+#if !ECS_ARCHETYPE_STORAGE
+            // Systems may share the query, so a run leaves refilling to after it
+            if (query->stale && !world->runningSystems) {
+                ECS_FillQuery(world, query);
+            }
+#endif
+            return query;
+        }
+    }
+
+    // Systems running in parallel only look queries up (scheduler.h)
+    assert(!world->runningSystems && "query built inside Scheduler_Run; build it in the system's prepare");
+
+    if (world->queryCount >= ECS_MAX_QUERIES) {
+        return NULL;
+    }
+
+    ECSQuery* query = &world->queries[world->queryCount];
+    memset(query, 0, sizeof(ECSQuery));
+    query->required = required;
+    query->excluded = excluded;
+    query->version = ++g_queryVersion;
+    query->typeCount = 0;
+    for (int type = 0; type < COMPONENT_COUNT; type++) {
+        if (required & COMPONENT_BIT(type)) {
+            query->types[query->typeCount++] = (ComponentType)type;
+        }
+    }
+
+#if ECS_ARCHETYPE_STORAGE
+    // Every archetype whose mask is a superset (minus exclusions) matches;
+    // entities without components have no archetype row
+    query->archetypeCount = 0;
+    for (unsigned int mask = 1; mask < ECS_ARCHETYPE_COUNT; mask++) {
+        if (ECS_QueryMatches(query, mask)) {
+            query->archetypes[query->archetypeCount++] = mask;
+        }
+    }
+#else
+    for (int page = 0; page < world->entityPageCount; page++) {
+        query->sparse[page] = ECS_AllocSparsePage(world);
+        if (!query->sparse[page]) {
+            for (int i = 0; i < page; i++) {
+                MemPool_Free(&world->indexPool, query->sparse[i]);
+            }
+            return NULL;
+        }
+    }
+
+    // One scan to pick up entities that already match; incremental after that
+    ECS_FillQuery(world, query);
+#endif
+
+    world->queryCount++;
+    return query;
+}
+
+ECSQueryIter ECS_QueryIter(ECSWorld* world, const ECSQuery* query) {
+    ECSQueryIter iter;
+    memset(&iter, 0, sizeof(iter));
+    iter.world = world;
+    iter.query = query;
+    iter.cursor = 0;
+    iter.entity = ECS_INVALID_ENTITY;
+    return iter;
+}
+
+#if ECS_ARCHETYPE_STORAGE
+
+// Points the iterator at the next non-empty chunk of a matching archetype
+static bool ECS_QueryNextChunk(ECSQueryIter* iter) {
+    const ECSQuery* query = iter->query;
+
+    while (iter->cursor < query->archetypeCount) {
+        const Archetype* archetype = &iter->world->archetypes[query->archetypes[iter->cursor]];
+        int rows = iter->chunk < archetype->chunkCount ? Archetype_GetChunkRows(archetype, iter->chunk) : 0;
+
+        if (rows > 0) {
+            unsigned char* chunk = archetype->chunks[iter->chunk++];
+            iter->entityColumn = (const EntityID*)chunk;
+            for (int i = 0; i < query->typeCount; i++) {
+                ComponentType type = query->types[i];
+                iter->columns[type] = chunk + archetype->columnOffsets[type];
+            }
+            iter->row = 0;
+            iter->chunkRows = rows;
+            return true;
+        }
+
+        iter->cursor++;
+        iter->chunk = 0;
+    }
+
+    return false;
+}
+
+bool ECS_QueryNext(ECSQueryIter* iter) {
+    const ECSQuery* query = iter->query;
+    if (!query) {
+        return false;
+    }
+
+    if (iter->row >= iter->chunkRows && !ECS_QueryNextChunk(iter)) {
+        return false;
+    }
+
+    // Rows of a chunk are contiguous in every column: no lookups, no mask tests
+    int row = iter->row++;
+    int typeCount = query->typeCount;
+    iter->entity = iter->entityColumn[row];
+
+    for (int i = 0; i < typeCount; i++) {
+        ComponentType type = query->types[i];
+        iter->components[type] = iter->columns[type] + (size_t)row * g_componentSizes[type];
+    }
+
+    return true;
+}
+
+#else
+
+bool ECS_QueryNext(ECSQueryIter* iter) {
+    const ECSQuery* query = iter->query;
+    if (!query || iter->cursor >= query->count) {
+        return false;
+    }
+
+    // Query membership guarantees the entity is live and has every
+    // required component, so the sparse lookups need no validation
+    ECSWorld* world = iter->world;
+    int typeCount = query->typeCount;
+    int cursor = iter->cursor++;
+    iter->entity = query->dense[ECS_PAGE(cursor)][ECS_PAGE_OFFSET(cursor)];
+    int index = ECS_ENTITY_INDEX(iter->entity);
+
+    for (int i = 0; i < typeCount; i++) {
+        ComponentType type = query->types[i];
+        iter->components[type] = ECS_SetSlot(world, type, ECS_SetLookup(&world->sets[type], index));
+    }
+
+    return true;
+}
+
+#endif // ECS_ARCHETYPE_STORAGE
+
+// translation * rotationZ * rotationY * rotationX * scale
+Matrix ECS_ComputeLocalMatrix(const TransformComponent* transform) {
+    Vector3 r = transform->rotation;
+    Vector3 s = transform->scale;
+
+    if (r.x == 0.0f && r.y == 0.0f && r.z == 0.0f) {
+        return (Matrix){s.x, 0, 0, transform->position.x,
+                        0, s.y, 0, transform->position.y,
+                        0, 0, s.z, transform->position.z,
+                        0, 0, 0, 1};
+    }
+
+    Matrix result;
+    Matrix* m = &result;
+
+    float cx = cosf(r.x), sx = sinf(r.x);
+    float cy = cosf(r.y), sy = sinf(r.y);
+    float cz = cosf(r.z), sz = sinf(r.z);
+
+    m->m0 = cz * cy * s.x;
+    m->m1 = sz * cy * s.x;
+    m->m2 = -sy * s.x;
+    m->m4 = (cz * sy * sx - sz * cx) * s.y;
+    m->m5 = (sz * sy * sx + cz * cx) * s.y;
+    m->m6 = cy * sx * s.y;
+    m->m8 = (cz * sy * cx + sz * sx) * s.z;
+    m->m9 = (sz * sy * cx - cz * sx) * s.z;
+    m->m10 = cy * cx * s.z;
+    m->m12 = transform->position.x;
+    m->m13 = transform->position.y;
+    m->m14 = transform->position.z;
+    m->m3 = 0.0f;
+    m->m7 = 0.0f;
+    m->m11 = 0.0f;
+    m->m15 = 1.0f;
+    return result;
+}
+
+void ECS_SetWorldMatrix(ECSWorld* world, TransformComponent* transform, const Matrix* m) {
+    if (transform->worldTick != world->tick) {
+        transform->previous = transform->worldTick ? transform->world : *m;
+        transform->worldTick = world->tick;
+        world->tickTransformCount++;
+    }
+    transform->world = *m;
+}
+
+void ECS_BeginTick(ECSWorld* world) {
+    world->tick++;
+    // Tick 0 marks transforms that were never built
+    if (world->tick == 0) world->tick = 1;
+    world->tickTransformCount = 0;
+}
+
+void ECS_SetInterpolation(ECSWorld* world, float alpha) {
+    world->interpolation = alpha < 0.0f ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+}
+
+// Unparented transforms, rescanned after the dirty list overflowed
+static ECSQuery* System_TransformQuery(ECSWorld* world) {
+    return ECS_GetQueryExcluding(world, COMPONENT_BIT(COMPONENT_TRANSFORM), COMPONENT_BIT(COMPONENT_HIERARCHY));
+}
+
+void System_PrepareTransforms(ECSWorld* world) {
+    System_TransformQuery(world);
+}
+
+void System_UpdateTransforms(ECSWorld* world) {
+    unsigned int hierarchyBit = COMPONENT_BIT(COMPONENT_HIERARCHY);
+    bool linked = world->hierarchyCount > 0;
+
+    // Entities destroyed or stripped of their transform since being queued
+    // resolve to NULL; ones queued twice are clean the second time. Entities
+    // parented after being queued are left to the hierarchy sweep.
+    for (int i = 0; i < world->dirtyTransformCount; i++) {
+        EntityID id = world->dirtyTransforms[i];
+        TransformComponent* transform = (TransformComponent*)ECS_GetComponent(world, id, COMPONENT_TRANSFORM);
+        if (transform && transform->dirty && !(linked && (ECS_GetComponentMask(world, id) & hierarchyBit))) {
+            Matrix local = ECS_ComputeLocalMatrix(transform);
+            ECS_SetWorldMatrix(world, transform, &local);
+            transform->dirty = false;
+        }
+    }
+    world->dirtyTransformCount = 0;
+
+    if (world->dirtyTransformOverflow) {
+        ECSQueryIter iter = ECS_QueryIter(world, System_TransformQuery(world));
+        while (ECS_QueryNext(&iter)) {
+            TransformComponent* transform = (TransformComponent*)iter.components[COMPONENT_TRANSFORM];
+            if (transform->dirty) {
+                Matrix local = ECS_ComputeLocalMatrix(transform);
+                ECS_SetWorldMatrix(world, transform, &local);
+                transform->dirty = false;
+            }
+        }
+        world->dirtyTransformOverflow = false;
+    }
+
+    if (world->hierarchyDirty || world->hierarchyCompact) {
+        Hierarchy_Update(world);
+    }
+}
+
+// Blended matrices for one System_Render: a single scratch array with a
+// slot for every transform that changed in the latest tick, since queued
+// commands point at their matrix until the frame is drawn
+typedef struct {
+    Matrix* matrices;
+    int count;
+    int capacity;
+} SystemBlendArray;
+
+static void System_BeginBlend(const ECSWorld* world, SystemBlendArray* blend) {
+    blend->count = 0;
+    blend->capacity = world->interpolation < 1.0f ? world->tickTransformCount : 0;
+    blend->matrices = blend->capacity > 0
+        ? (Matrix*)Mem_ScratchAlloc(MEM_SUBSYSTEM_RENDER, sizeof(Matrix) * (size_t)blend->capacity)
+        : NULL;
+    if (!blend->matrices) {
+        blend->capacity = 0;
+    }
+}
+
+static void System_EndBlend(SystemBlendArray* blend) {
+    Mem_ScratchFree(MEM_SUBSYSTEM_RENDER, blend->matrices, sizeof(Matrix) * (size_t)blend->capacity);
+    blend->matrices = NULL;
+    blend->capacity = 0;
+}
+
+// Matrix a transform is drawn with: `world`, or for transforms that changed
+// in the latest tick a blend from `previous` in the next slot of `blend`.
+// Falls back to `world` when there is no slot left.
+static const Matrix* System_RenderMatrix(const ECSWorld* world, const TransformComponent* transform,
+                                         SystemBlendArray* blend) {
+    float t = world->interpolation;
+    if (t >= 1.0f || transform->worldTick != world->tick || blend->count >= blend->capacity) {
+        return &transform->world;
+    }
+
+    Matrix* m = &blend->matrices[blend->count++];
+    const float* from = (const float*)&transform->previous;
+    const float* to = (const float*)&transform->world;
+    float* out = (float*)m;
+    for (int i = 0; i < 16; i++) {
+        out[i] = from[i] + (to[i] - from[i]) * t;
+    }
+    return m;
+}
+
+static void System_MatrixBounds(const Matrix* m, const RenderableComponent* renderable,
+                                Vector3* center, Vector3* halfExtents) {
+    Vector3 local;
+
+    switch (renderable->type) {
+        case RENDERABLE_GRID:
+            // DrawGrid(10, 5.0f) is always centered on the origin
+            *center = (Vector3){0.0f, 0.0f, 0.0f};
+            *halfExtents = (Vector3){25.0f, 0.0f, 25.0f};
+            return;
+        case RENDERABLE_PLANE:
+            local = (Vector3){renderable->size.x * 0.5f, 0.0f, renderable->size.z * 0.5f};
+            break;
+        default:
+            local = (Vector3){renderable->size.x * 0.5f, renderable->size.y * 0.5f, renderable->size.z * 0.5f};
+            break;
+    }
+
+    // Box around the transformed local box
+    *center = (Vector3){m->m12, m->m13, m->m14};
+    *halfExtents = (Vector3){fabsf(m->m0) * local.x + fabsf(m->m4) * local.y + fabsf(m->m8) * local.z,
+                             fabsf(m->m1) * local.x + fabsf(m->m5) * local.y + fabsf(m->m9) * local.z,
+                             fabsf(m->m2) * local.x + fabsf(m->m6) * local.y + fabsf(m->m10) * local.z};
+}
+
+void System_RenderBounds(const TransformComponent* transform, const RenderableComponent* renderable,
+                         Vector3* center, Vector3* halfExtents) {
+    System_MatrixBounds(&transform->world, renderable, center, halfExtents);
+}
+
+// Plane outlines and grid lines have fixed colors
+#define SYSTEM_PLANE_WIRE_COLOR (Color){80, 80, 80, 255}
+#define SYSTEM_GRID_COLOR LIGHTGRAY
+
+// Issues one queued command. Cubes and spheres go to the batch; planes and
+// the grid are drawn immediately, split so solid and line draws fall into
+// separate passes
+static void System_DrawCommand(RenderPass pass, const Matrix* m, const RenderableComponent* renderable) {
+    switch (renderable->type) {
+        case RENDERABLE_CUBE:
+            RenderBatch_AddCube(m, renderable->size, renderable->color);
+            break;
+        case RENDERABLE_SPHERE:
+            RenderBatch_AddSphere(m, renderable->size, renderable->color, renderable->lod);
+            break;
+        case RENDERABLE_GRID: {
+            const CachedMesh* mesh = MeshCache_GetGrid(10, 5.0f);
+            if (mesh) {
+                MeshCache_Draw(mesh, NULL);
+            } else {
+                DrawGrid(10, 5.0f);
+            }
+            RenderBatch_CountDraw(RL_LINES, SYSTEM_GRID_COLOR, (10 + 1) * 4);
+            break;
+        }
+        case RENDERABLE_PLANE: {
+            // Plane geometry is replayed from the mesh cache. raylib's
+            // DrawPlane and DrawLine3D (which ignore rotation and scale) are
+            // only a fallback when the cache returns NULL: a mesh cannot be
+            // allocated, or every cached mesh was already drawn this frame
+            Vector2 size = {renderable->size.x, renderable->size.z};
+            Vector3 position = {m->m12, m->m13, m->m14};
+            if (pass == RENDER_PASS_SOLID) {
+                const CachedMesh* mesh = MeshCache_GetPlane(size, renderable->color);
+                if (mesh) {
+                    MeshCache_Draw(mesh, m);
+                } else {
+                    DrawPlane(position, size, renderable->color);
+                }
+                RenderBatch_CountDraw(RL_QUADS, renderable->color, 4);
+            } else {
+                const CachedMesh* mesh = MeshCache_GetPlaneWire(size, SYSTEM_PLANE_WIRE_COLOR);
+                if (mesh) {
+                    MeshCache_Draw(mesh, m);
+                } else {
+                    Vector3 a = {position.x - size.x * 0.5f, position.y, position.z - size.y * 0.5f};
+                    Vector3 b = {position.x + size.x * 0.5f, position.y, position.z - size.y * 0.5f};
+                    Vector3 c = {position.x + size.x * 0.5f, position.y, position.z + size.y * 0.5f};
+                    Vector3 d = {position.x - size.x * 0.5f, position.y, position.z + size.y * 0.5f};
+                    DrawLine3D(a, b, SYSTEM_PLANE_WIRE_COLOR);
+                    DrawLine3D(b, c, SYSTEM_PLANE_WIRE_COLOR);
+                    DrawLine3D(c, d, SYSTEM_PLANE_WIRE_COLOR);
+                    DrawLine3D(d, a, SYSTEM_PLANE_WIRE_COLOR);
                 }
+                RenderBatch_CountDraw(RL_LINES, SYSTEM_PLANE_WIRE_COLOR, 8);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void System_QueueCommand(RenderPass pass, Color color, float depth,
+                                const Matrix* m, const RenderableComponent* renderable) {
+    uint64_t key = RenderQueue_MakeKey(pass, renderable->type, color, depth);
+    if (!RenderQueue_Push(key, m, renderable)) {
+        // Queue full: draw now, unsorted
+        System_DrawCommand(pass, m, renderable);
+    }
+}
+
+// Picks a sphere's level of detail from its projected size, updating the
+// level it keeps between frames. Without a frustum spheres stay at level 0.
+static void System_SelectSphereLod(const Frustum* frustum, Vector3 center, Vector3 halfExtents,
+                                   RenderableComponent* renderable) {
+    float radius = halfExtents.x;
+    if (halfExtents.y > radius) radius = halfExtents.y;
+    if (halfExtents.z > radius) radius = halfExtents.z;
+    renderable->lod = RenderBatch_SelectSphereLod(Culling_ScreenSize(frustum, center, radius), renderable->lod);
+}
+
+// Queues every command a visible renderable needs. depth is its distance
+// in front of the near plane (0 without a frustum).
+static void System_QueueEntity(float depth, const Matrix* m, const RenderableComponent* renderable) {
+    switch (renderable->type) {
+        case RENDERABLE_CUBE:
+        case RENDERABLE_SPHERE:
+            System_QueueCommand(RENDER_PASS_SOLID, renderable->color, depth, m, renderable);
+            break;
+        case RENDERABLE_GRID:
+            System_QueueCommand(RENDER_PASS_WIRE, SYSTEM_GRID_COLOR, depth, m, renderable);
+            break;
+        case RENDERABLE_PLANE:
+            System_QueueCommand(RENDER_PASS_SOLID, renderable->color, depth, m, renderable);
+            System_QueueCommand(RENDER_PASS_WIRE, SYSTEM_PLANE_WIRE_COLOR, depth, m, renderable);
+            break;
+        default:
+            break;
+    }
+}
+
+static float System_ViewDepth(const Frustum* frustum, Vector3 center) {
+    if (!frustum) {
+        return 0.0f;
+    }
+    const Vector4* plane = &frustum->planes[FRUSTUM_NEAR];
+    return plane->x * center.x + plane->y * center.y + plane->z * center.z + plane->w;
+}
+
+// Queues the static entities the BVH finds in the frustum; false if the tree
+// cannot be used this frame and they must go through the per-entity loop
+static bool System_RenderStatic(ECSWorld* world, const Frustum* frustum, const StaticBVH* staticBVH,
+                                SystemBlendArray* blend, int* visible, int* culled) {
+    unsigned int staticMask = COMPONENT_BIT(COMPONENT_TRANSFORM) | COMPONENT_BIT(COMPONENT_RENDERABLE) |
+                              COMPONENT_BIT(COMPONENT_STATIC);
+    ECSQuery* staticQuery = ECS_GetQuery(world, staticMask);
+    if (!staticQuery || !staticBVH->valid || staticBVH->version != staticQuery->version) {
+        return false;
+    }
+    if (staticBVH->itemCount == 0) {
+        return true;
+    }
+
+    size_t bytes = sizeof(EntityID) * (size_t)staticBVH->itemCount;
+    EntityID* ids = (EntityID*)Mem_ScratchAlloc(MEM_SUBSYSTEM_RENDER, bytes);
+    if (!ids) {
+        return false;
+    }
+
+    int found = StaticBVH_QueryFrustum(staticBVH, frustum, ids, staticBVH->itemCount);
+    for (int i = 0; i < found; i++) {
+        const TransformComponent* transform = (const TransformComponent*)ECS_GetComponent(world, ids[i], COMPONENT_TRANSFORM);
+        RenderableComponent* renderable = (RenderableComponent*)ECS_GetComponent(world, ids[i], COMPONENT_RENDERABLE);
+        const Matrix* m = System_RenderMatrix(world, transform, blend);
+
+        float depth = 0.0f;
+        if (frustum) {
+            Vector3 center;
+            Vector3 halfExtents;
+            System_MatrixBounds(m, renderable, &center, &halfExtents);
+            depth = System_ViewDepth(frustum, center);
+            if (renderable->type == RENDERABLE_SPHERE) System_SelectSphereLod(frustum, center, halfExtents, renderable);
+        } else if (renderable->type == RENDERABLE_SPHERE) {
+            renderable->lod = 0;
+        }
+        System_QueueEntity(depth, m, renderable);
+    }
+
+    *visible += found;
+    *culled += staticBVH->itemCount - found;
+    Mem_ScratchFree(MEM_SUBSYSTEM_RENDER, ids, bytes);
+    return true;
+}
+
+void System_Render(ECSWorld* world, const Frustum* frustum, const StaticBVH* staticBVH) {
+    unsigned int required = COMPONENT_BIT(COMPONENT_TRANSFORM) | COMPONENT_BIT(COMPONENT_RENDERABLE);
+    int visible = 0;
+    int culled = 0;
+
+    // Bounds and draws read the cached world matrices
+    System_UpdateTransforms(world);
+
+    // Visible renderables are queued, sorted by key, then submitted; cubes
+    // end up in the batch and are drawn in two passes at the end
+    RenderBatch_Begin(BLACK);
+    RenderQueue_Begin();
+    MeshCache_BeginFrame();
+
+    SystemBlendArray blend;
+    System_BeginBlend(world, &blend);
+
+    PROFILE_BEGIN(PROFILE_CULLING);
+
+    // Static entities come from the BVH when it is in sync with the world
+    unsigned int excluded = 0;
+    if (staticBVH && System_RenderStatic(world, frustum, staticBVH, &blend, &visible, &culled)) {
+        excluded = COMPONENT_BIT(COMPONENT_STATIC);
+    }
+
+    ECSQueryIter iter = ECS_QueryIter(world, ECS_GetQueryExcluding(world, required, excluded));
+    while (ECS_QueryNext(&iter)) {
+        TransformComponent* transform = (TransformComponent*)iter.components[COMPONENT_TRANSFORM];
+        RenderableComponent* renderable = (RenderableComponent*)iter.components[COMPONENT_RENDERABLE];
+        const Matrix* m = System_RenderMatrix(world, transform, &blend);
+
+        // Reject off-screen entities before anything is queued
+        float depth = 0.0f;
+        if (frustum) {
+            Vector3 center;
+            Vector3 halfExtents;
+            System_MatrixBounds(m, renderable, &center, &halfExtents);
+            if (!Culling_TestAABB(frustum, center, halfExtents)) {
+                culled++;
+                continue;
             }
+            depth = System_ViewDepth(frustum, center);
+            if (renderable->type == RENDERABLE_SPHERE) System_SelectSphereLod(frustum, center, halfExtents, renderable);
+        } else if (renderable->type == RENDERABLE_SPHERE) {
+            renderable->lod = 0;
         }
+        visible++;
+
+        System_QueueEntity(depth, m, renderable);
     }
+
+    PROFILE_END(PROFILE_CULLING);
+
+    RenderQueue_Sort();
+    const RenderCommand* commands = RenderQueue_GetCommands();
+    int count = RenderQueue_GetCount();
+    for (int i = 0; i < count; i++) {
+        System_DrawCommand(RENDER_KEY_PASS(commands[i].key), commands[i].world, commands[i].renderable);
+    }
+
+    RenderBatch_End();
+    RenderBatch_CountCulling(visible, culled);
+    System_EndBlend(&blend);
 }
 
 void ECS_Cleanup(ECSWorld* world) {
-    // Destroy all active entities and free their components
-    for (int i = 0; i < MAX_ENTITIES; i++) {
-        if (world->entities[i].active) {
-            ECS_DestroyEntity(world, i);
-        }
+    // Nothing left to save incrementally; skips listing every destroy below
+    world->changesLost = true;
+
+    // Destroy all active entities and release their components
+    for (EntityID id = ECS_FirstEntity(world); id != ECS_INVALID_ENTITY; id = ECS_NextEntity(world, id)) {
+        ECS_DestroyEntity(world, id);
     }
+
+    // Return every page; the world must be re-initialized before reuse
+    ECS_StorageRelease(world);
+    MemPool_Release(&world->entityPool);
+    memset(world->entityPages, 0, sizeof(world->entityPages));
+    world->entityPageCount = 0;
+    world->unusedHead = 0;
+    world->freeHead = -1;
+    world->queryCount = 0;
+
+    Mem_Free(MEM_SUBSYSTEM_ECS, world->dirtyTransforms, sizeof(EntityID) * (size_t)world->dirtyTransformCapacity);
+    world->dirtyTransforms = NULL;
+    world->dirtyTransformCount = 0;
+    world->dirtyTransformCapacity = 0;
+    world->dirtyTransformOverflow = false;
+
+    Mem_Free(MEM_SUBSYSTEM_ECS, world->changedSlots, sizeof(int) * (size_t)world->changedSlotCapacity);
+    world->changedSlots = NULL;
+    world->changedSlotCount = 0;
+    world->changedSlotCapacity = 0;
+
+    Mem_Free(MEM_SUBSYSTEM_ECS, world->hierarchyNodes, sizeof(HierarchyNode) * (size_t)world->hierarchyCapacity);
+    world->hierarchyNodes = NULL;
+    world->hierarchyCount = 0;
+    world->hierarchyCapacity = 0;
+    world->hierarchyDirty = false;
+    world->hierarchyCompact = false;
 }
@@ -0,0 +1,132 @@
+#include "ecs_archetype.h"
+
+#if ECS_ARCHETYPE_STORAGE
+
+#include <string.h>
+
+// Columns start on 16-byte boundaries so they can be streamed with vector loads
+#define ARCHETYPE_COLUMN_ALIGN 16
+#define ARCHETYPE_ALIGN(offset) (((offset) + (ARCHETYPE_COLUMN_ALIGN - 1)) & ~(size_t)(ARCHETYPE_COLUMN_ALIGN - 1))
+
+void Archetype_Init(Archetype* archetype, unsigned int mask) {
+    memset(archetype, 0, sizeof(Archetype));
+    archetype->mask = mask;
+
+    size_t rowBytes = sizeof(EntityID);
+    for (int type = 0; type < COMPONENT_COUNT; type++) {
+        if (mask & COMPONENT_BIT(type)) {
+            rowBytes += ECS_GetComponentSize((ComponentType)type);
+        }
+    }
+
+    // Start from the unpadded estimate and back off until the aligned columns fit
+    int capacity = (int)(ECS_CHUNK_SIZE / rowBytes);
+    while (capacity > 0) {
+        size_t offset = (size_t)capacity * sizeof(EntityID);
+        for (int type = 0; type < COMPONENT_COUNT; type++) {
+            if (mask & COMPONENT_BIT(type)) {
+                offset = ARCHETYPE_ALIGN(offset);
+                archetype->columnOffsets[type] = offset;
+                offset += (size_t)capacity * ECS_GetComponentSize((ComponentType)type);
+            }
+        }
+        if (offset <= ECS_CHUNK_SIZE) break;
+        capacity--;
+    }
+
+    archetype->chunkCapacity = capacity;
+}
+
+void Archetype_Release(Archetype* archetype, MemPool* chunkPool) {
+    for (int i = 0; i < archetype->chunkCount; i++) {
+        MemPool_Free(chunkPool, archetype->chunks[i]);
+    }
+    Mem_Free(MEM_SUBSYSTEM_ECS, archetype->chunks, sizeof(unsigned char*) * (size_t)archetype->chunkSlots);
+
+    archetype->chunks = NULL;
+    archetype->chunkCount = 0;
+    archetype->chunkSlots = 0;
+    archetype->count = 0;
+}
+
+int Archetype_Insert(Archetype* archetype, MemPool* chunkPool, EntityID id) {
+    int row = archetype->count;
+    int chunk = row / archetype->chunkCapacity;
+
+    if (chunk >= archetype->chunkCount) {
+        if (archetype->chunkCount == archetype->chunkSlots) {
+            int slots = archetype->chunkSlots > 0 ? archetype->chunkSlots * 2 : 4;
+            unsigned char** chunks = (unsigned char**)Mem_Realloc(MEM_SUBSYSTEM_ECS, archetype->chunks,
+                                                                 sizeof(unsigned char*) * (size_t)archetype->chunkSlots,
+                                                                 sizeof(unsigned char*) * (size_t)slots);
+            if (!chunks) {
+                return -1;
+            }
+            archetype->chunks = chunks;
+            archetype->chunkSlots = slots;
+        }
+
+        unsigned char* block = (unsigned char*)MemPool_Alloc(chunkPool);
+        if (!block) {
+            // Memory allocation failed - critical on PSP with limited RAM
+            return -1;
+        }
+        archetype->chunks[archetype->chunkCount++] = block;
+    }
+
+    EntityID* entityColumn = (EntityID*)archetype->chunks[chunk];
+    entityColumn[row % archetype->chunkCapacity] = id;
+    archetype->count++;
+
+    return row;
+}
+
+EntityID Archetype_Remove(Archetype* archetype, MemPool* chunkPool, int row) {
+    int last = archetype->count - 1;
+    EntityID moved = ECS_INVALID_ENTITY;
+
+    // Swap-and-pop: the last row fills the hole so chunks stay packed
+    if (row != last) {
+        int capacity = archetype->chunkCapacity;
+        unsigned char* dstChunk = archetype->chunks[row / capacity];
+        unsigned char* srcChunk = archetype->chunks[last / capacity];
+        int dst = row % capacity;
+        int src = last % capacity;
+
+        moved = ((EntityID*)srcChunk)[src];
+        ((EntityID*)dstChunk)[dst] = moved;
+
+        for (int type = 0; type < COMPONENT_COUNT; type++) {
+            if (archetype->mask & COMPONENT_BIT(type)) {
+                size_t size = ECS_GetComponentSize((ComponentType)type);
+                size_t column = archetype->columnOffsets[type];
+                memcpy(dstChunk + column + (size_t)dst * size, srcChunk + column + (size_t)src * size, size);
+            }
+        }
+    }
+
+    archetype->count--;
+
+    // Keep one empty chunk as slack so an entity flipping around a chunk
+    // boundary does not allocate and free on every move
+    int neededChunks = (archetype->count + archetype->chunkCapacity - 1) / archetype->chunkCapacity;
+    while (archetype->chunkCount > neededChunks + 1) {
+        MemPool_Free(chunkPool, archetype->chunks[--archetype->chunkCount]);
+    }
+
+    return moved;
+}
+
+void* Archetype_GetComponent(const Archetype* archetype, int row, ComponentType type) {
+    int capacity = archetype->chunkCapacity;
+    unsigned char* chunk = archetype->chunks[row / capacity];
+    return chunk + archetype->columnOffsets[type] + (size_t)(row % capacity) * ECS_GetComponentSize(type);
+}
+
+int Archetype_GetChunkRows(const Archetype* archetype, int chunk) {
+    int rows = archetype->count - chunk * archetype->chunkCapacity;
+    if (rows > archetype->chunkCapacity) rows = archetype->chunkCapacity;
+    return rows > 0 ? rows : 0;
+}
+
+#endif // ECS_ARCHETYPE_STORAGE
@@ -0,0 +1,337 @@
+#include "hierarchy.h"
+#include "mem.h"
+#include <string.h>
+
+// Transient buffers for re-sorting the node array
+typedef struct {
+    int* remap;             // Node index -> new index (subtree marks before that)
+    HierarchyNode* sorted;
+    int* offsets;           // Per depth: next free index
+    int depthCount;
+    size_t bytes;
+    void* block;
+} HierarchyScratch;
+
+static bool Hierarchy_BeginScratch(HierarchyScratch* scratch, int nodeCount, int depthCount) {
+    size_t nodeBytes = sizeof(HierarchyNode) * (size_t)nodeCount;
+    size_t indexBytes = sizeof(int) * (size_t)nodeCount;
+    scratch->bytes = nodeBytes + indexBytes + sizeof(int) * (size_t)depthCount;
+    scratch->block = Mem_ScratchAlloc(MEM_SUBSYSTEM_ECS, scratch->bytes);
+    if (!scratch->block) {
+        return false;
+    }
+    // Nodes first, so the int arrays after them stay aligned
+    scratch->sorted = (HierarchyNode*)scratch->block;
+    scratch->remap = (int*)((unsigned char*)scratch->block + nodeBytes);
+    scratch->offsets = (int*)((unsigned char*)scratch->block + nodeBytes + indexBytes);
+    scratch->depthCount = depthCount;
+    return true;
+}
+
+static void Hierarchy_EndScratch(HierarchyScratch* scratch) {
+    Mem_ScratchFree(MEM_SUBSYSTEM_ECS, scratch->block, scratch->bytes);
+}
+
+static HierarchyComponent* Hierarchy_Link(ECSWorld* world, EntityID id) {
+    return (HierarchyComponent*)ECS_GetComponent(world, id, COMPONENT_HIERARCHY);
+}
+
+static void Hierarchy_SetSlot(ECSWorld* world, int slot) {
+    EntityID id = world->hierarchyNodes[slot].entity;
+    if (id != ECS_INVALID_ENTITY) {
+        Hierarchy_Link(world, id)->slot = slot;
+    }
+}
+
+// First node at least `depth` deep
+static int Hierarchy_LowerBound(const ECSWorld* world, int depth) {
+    int lo = 0;
+    int hi = world->hierarchyCount;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (world->hierarchyNodes[mid].depth < depth) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Stable counting sort of nodes [lo, count) by depth. Every node before lo
+// must be shallower than every node from lo on.
+static void Hierarchy_Sort(ECSWorld* world, int lo, HierarchyScratch* scratch) {
+    HierarchyNode* nodes = world->hierarchyNodes;
+    int count = world->hierarchyCount;
+    int* offsets = scratch->offsets;
+
+    memset(offsets, 0, sizeof(int) * (size_t)scratch->depthCount);
+    for (int i = lo; i < count; i++) {
+        offsets[nodes[i].depth]++;
+    }
+    int next = lo;
+    for (int depth = 0; depth < scratch->depthCount; depth++) {
+        int run = offsets[depth];
+        offsets[depth] = next;
+        next += run;
+    }
+    for (int i = lo; i < count; i++) {
+        scratch->remap[i] = offsets[nodes[i].depth]++;
+    }
+
+    // Parents precede children, so a parent index below lo never moves
+    for (int i = lo; i < count; i++) {
+        HierarchyNode node = nodes[i];
+        if (node.parent >= lo) {
+            node.parent = scratch->remap[node.parent];
+        }
+        scratch->sorted[scratch->remap[i] - lo] = node;
+    }
+    memcpy(&nodes[lo], scratch->sorted, sizeof(HierarchyNode) * (size_t)(count - lo));
+
+    for (int i = lo; i < count; i++) {
+        if (scratch->remap[i] != i) {
+            Hierarchy_SetSlot(world, scratch->remap[i]);
+        }
+    }
+}
+
+// Drops destroyed nodes; their children become roots. Without scratch
+// memory the dead nodes stay, the sweep skips them, and this runs again on
+// the next update.
+static void Hierarchy_Compact(ECSWorld* world) {
+    HierarchyNode* nodes = world->hierarchyNodes;
+    int count = world->hierarchyCount;
+    int depthCount = count > 0 ? nodes[count - 1].depth + 1 : 1;
+
+    HierarchyScratch scratch;
+    if (!Hierarchy_BeginScratch(&scratch, count, depthCount)) {
+        return;
+    }
+
+    int write = 0;
+    bool orphaned = false;
+    for (int i = 0; i < count; i++) {
+        HierarchyNode node = nodes[i];
+        if (node.entity == ECS_INVALID_ENTITY) {
+            scratch.remap[i] = -1;
+            continue;
+        }
+        if (node.parent >= 0) {
+            node.parent = scratch.remap[node.parent];
+            if (node.parent < 0) {
+                Hierarchy_Link(world, node.entity)->parent = ECS_INVALID_ENTITY;
+                node.dirty = true;
+                world->hierarchyDirty = true;
+                orphaned = true;
+            }
+        }
+        // Parents were written already, with their depths updated
+        node.depth = node.parent >= 0 ? nodes[node.parent].depth + 1 : 0;
+        scratch.remap[i] = write;
+        nodes[write] = node;
+        if (write != i) {
+            Hierarchy_SetSlot(world, write);
+        }
+        write++;
+    }
+    world->hierarchyCount = write;
+
+    // Orphaned subtrees moved up, so the depth order no longer holds
+    if (orphaned) {
+        Hierarchy_Sort(world, 0, &scratch);
+    }
+    Hierarchy_EndScratch(&scratch);
+    world->hierarchyCompact = false;
+}
+
+// Node slot of an entity, first linking it as an unparented node `depth`
+// deep if needed; -1 on failure
+static int Hierarchy_EnsureNode(ECSWorld* world, EntityID id, int depth) {
+    HierarchyComponent* link = Hierarchy_Link(world, id);
+    if (link) {
+        return link->slot;
+    }
+
+    if (world->hierarchyCount == world->hierarchyCapacity) {
+        int capacity = world->hierarchyCapacity > 0 ? world->hierarchyCapacity * 2 : 64;
+        HierarchyNode* nodes = (HierarchyNode*)Mem_Realloc(MEM_SUBSYSTEM_ECS, world->hierarchyNodes,
+                                                           sizeof(HierarchyNode) * (size_t)world->hierarchyCapacity,
+                                                           sizeof(HierarchyNode) * (size_t)capacity);
+        if (!nodes) {
+            return -1;
+        }
+        world->hierarchyNodes = nodes;
+        world->hierarchyCapacity = capacity;
+    }
+    if (!ECS_AddComponent(world, id, COMPONENT_HIERARCHY)) {
+        return -1;
+    }
+
+    // The node goes after the last one as deep; deeper nodes shift up by one.
+    // Linking parents before children appends, so building costs O(1) per node.
+    HierarchyNode* nodes = world->hierarchyNodes;
+    int slot = Hierarchy_LowerBound(world, depth + 1);
+    int count = world->hierarchyCount;
+    memmove(&nodes[slot + 1], &nodes[slot], sizeof(HierarchyNode) * (size_t)(count - slot));
+    nodes[slot] = (HierarchyNode){id, -1, depth, true, false};
+    world->hierarchyCount = count + 1;
+    for (int i = slot + 1; i <= count; i++) {
+        if (nodes[i].parent >= slot) {
+            nodes[i].parent++;
+        }
+        Hierarchy_SetSlot(world, i);
+    }
+    Hierarchy_SetSlot(world, slot);
+    world->hierarchyDirty = true;
+    return slot;
+}
+
+// Moves the subtree at `slot` by `delta` levels and restores the depth order
+static bool Hierarchy_MoveSubtree(ECSWorld* world, int slot, int delta) {
+    HierarchyNode* nodes = world->hierarchyNodes;
+    int count = world->hierarchyCount;
+    int oldDepth = nodes[slot].depth;
+    int depthCount = nodes[count - 1].depth + (delta > 0 ? delta : 0) + 1;
+
+    HierarchyScratch scratch;
+    if (!Hierarchy_BeginScratch(&scratch, count, depthCount)) {
+        return false;
+    }
+
+    // Nodes shallower than both the old and new depth keep their places
+    int lo = Hierarchy_LowerBound(world, delta < 0 ? oldDepth + delta : oldDepth);
+
+    // The subtree is `slot` plus every later node whose parent is in it
+    int* marks = scratch.remap;
+    for (int i = slot; i < count; i++) {
+        int parent = nodes[i].parent;
+        marks[i] = i == slot || (parent >= slot && marks[parent]);
+        if (marks[i]) {
+            nodes[i].depth += delta;
+        }
+    }
+
+    Hierarchy_Sort(world, lo, &scratch);
+    Hierarchy_EndScratch(&scratch);
+    return true;
+}
+
+bool Hierarchy_SetParent(ECSWorld* world, EntityID child, EntityID parent) {
+    if (!ECS_HasComponent(world, child, COMPONENT_TRANSFORM)) {
+        return false;
+    }
+    if (parent == ECS_INVALID_ENTITY) {
+        if (!ECS_HasComponent(world, child, COMPONENT_HIERARCHY)) {
+            return true;
+        }
+    } else {
+        if (parent == child || !ECS_HasComponent(world, parent, COMPONENT_TRANSFORM)) {
+            return false;
+        }
+        // Refuse cycles: child must not be an ancestor of parent
+        const HierarchyComponent* parentLink = Hierarchy_Link(world, parent);
+        const HierarchyComponent* childLink = Hierarchy_Link(world, child);
+        if (parentLink && childLink) {
+            for (int slot = parentLink->slot; slot >= 0; slot = world->hierarchyNodes[slot].parent) {
+                if (slot == childLink->slot) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    int depth = 0;
+    if (parent != ECS_INVALID_ENTITY) {
+        int parentSlot = Hierarchy_EnsureNode(world, parent, 0);
+        if (parentSlot < 0) {
+            return false;
+        }
+        depth = world->hierarchyNodes[parentSlot].depth + 1;
+    }
+    if (Hierarchy_EnsureNode(world, child, depth) < 0) {
+        return false;
+    }
+
+    // Inserting nodes shifts slots, so they are read back after each step
+    int childSlot = Hierarchy_Link(world, child)->slot;
+    int parentSlot = parent != ECS_INVALID_ENTITY ? Hierarchy_Link(world, parent)->slot : -1;
+    int delta = depth - world->hierarchyNodes[childSlot].depth;
+    if (delta != 0) {
+        if (!Hierarchy_MoveSubtree(world, childSlot, delta)) {
+            return false;
+        }
+        childSlot = Hierarchy_Link(world, child)->slot;
+        parentSlot = parent != ECS_INVALID_ENTITY ? Hierarchy_Link(world, parent)->slot : -1;
+    }
+
+    HierarchyNode* node = &world->hierarchyNodes[childSlot];
+    node->parent = parentSlot;
+    node->dirty = true;
+    Hierarchy_Link(world, child)->parent = parent;
+    world->hierarchyDirty = true;
+    ECS_MarkChanged(world, child, COMPONENT_HIERARCHY);
+    return true;
+}
+
+EntityID Hierarchy_GetParent(ECSWorld* world, EntityID child) {
+    const HierarchyComponent* link = Hierarchy_Link(world, child);
+    return link ? link->parent : ECS_INVALID_ENTITY;
+}
+
+// parent * local for affine matrices (bottom row 0 0 0 1)
+static Matrix Hierarchy_Combine(const Matrix* p, const Matrix* l) {
+    Matrix m;
+    m.m0 = p->m0 * l->m0 + p->m4 * l->m1 + p->m8 * l->m2;
+    m.m1 = p->m1 * l->m0 + p->m5 * l->m1 + p->m9 * l->m2;
+    m.m2 = p->m2 * l->m0 + p->m6 * l->m1 + p->m10 * l->m2;
+    m.m4 = p->m0 * l->m4 + p->m4 * l->m5 + p->m8 * l->m6;
+    m.m5 = p->m1 * l->m4 + p->m5 * l->m5 + p->m9 * l->m6;
+    m.m6 = p->m2 * l->m4 + p->m6 * l->m5 + p->m10 * l->m6;
+    m.m8 = p->m0 * l->m8 + p->m4 * l->m9 + p->m8 * l->m10;
+    m.m9 = p->m1 * l->m8 + p->m5 * l->m9 + p->m9 * l->m10;
+    m.m10 = p->m2 * l->m8 + p->m6 * l->m9 + p->m10 * l->m10;
+    m.m12 = p->m0 * l->m12 + p->m4 * l->m13 + p->m8 * l->m14 + p->m12;
+    m.m13 = p->m1 * l->m12 + p->m5 * l->m13 + p->m9 * l->m14 + p->m13;
+    m.m14 = p->m2 * l->m12 + p->m6 * l->m13 + p->m10 * l->m14 + p->m14;
+    m.m3 = 0.0f;
+    m.m7 = 0.0f;
+    m.m11 = 0.0f;
+    m.m15 = 1.0f;
+    return m;
+}
+
+void Hierarchy_Update(ECSWorld* world) {
+    if (world->hierarchyCompact) {
+        Hierarchy_Compact(world);
+    }
+
+    // Parents come first, so `changed` is final by the time children read it
+    HierarchyNode* nodes = world->hierarchyNodes;
+    for (int i = 0; i < world->hierarchyCount; i++) {
+        HierarchyNode* node = &nodes[i];
+        const HierarchyNode* parent = node->parent >= 0 ? &nodes[node->parent] : NULL;
+        bool inherited = parent && parent->changed;
+        node->changed = false;
+        if (node->entity == ECS_INVALID_ENTITY || (!node->dirty && !inherited)) {
+            continue;
+        }
+        node->dirty = false;
+
+        TransformComponent* transform = (TransformComponent*)ECS_GetComponent(world, node->entity, COMPONENT_TRANSFORM);
+        if (!transform) {
+            continue;
+        }
+        const TransformComponent* parentTransform = NULL;
+        if (parent && parent->entity != ECS_INVALID_ENTITY) {
+            parentTransform = (const TransformComponent*)ECS_GetComponent(world, parent->entity, COMPONENT_TRANSFORM);
+        }
+
+        Matrix local = ECS_ComputeLocalMatrix(transform);
+        Matrix combined = parentTransform ? Hierarchy_Combine(&parentTransform->world, &local) : local;
+        ECS_SetWorldMatrix(world, transform, &combined);
+        transform->dirty = false;
+        node->changed = true;
+    }
+    world->hierarchyDirty = false;
+}
@@ -13,7 +13,8 @@ static const char* actionNames[ACTION_COUNT] = {
     "Menu Down",
     "Menu Select",
     "Menu Back",
-    "Toggle Menu"
+    "Toggle Menu",
+    "Toggle Profiler"
 };
 
 void Keybinds_Init(KeyBindingSystem* system) {
@@ -50,6 +51,9 @@ void Keybinds_Init(KeyBindingSystem* system) {
     
     system->bindings[ACTION_TOGGLE_MENU].button = PSP_CTRL_START;
     system->bindings[ACTION_TOGGLE_MENU].name = actionNames[ACTION_TOGGLE_MENU];
+    
+    system->bindings[ACTION_TOGGLE_PROFILER].button = PSP_CTRL_SELECT;
+    system->bindings[ACTION_TOGGLE_PROFILER].name = actionNames[ACTION_TOGGLE_PROFILER];
 }
 
 void Keybinds_SetBinding(KeyBindingSystem* system, ActionID action, unsigned int button) {
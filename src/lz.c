@@ -0,0 +1,173 @@
+#include "lz.h"
+#include "mem.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LZ_HASH_SIZE (1 << LZ_HASH_BITS)
+
+static uint32_t Lz_Read32(const unsigned char* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint32_t Lz_Hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+// Length nibble plus continuation bytes for values of 15 and up
+static unsigned char* Lz_WriteLength(unsigned char* out, size_t length) {
+    length -= 15;
+    while (length >= 255) {
+        *out++ = 255;
+        length -= 255;
+    }
+    *out++ = (unsigned char)length;
+    return out;
+}
+
+size_t Lz_MaxCompressedSize(size_t srcSize) {
+    // One token plus the literal length bytes around the whole input
+    return srcSize + srcSize / 255 + 16;
+}
+
+// Final sequence: everything from `anchor` as literals, no match
+static unsigned char* Lz_WriteLiterals(unsigned char* out, const unsigned char* anchor, size_t count) {
+    unsigned char* token = out++;
+    if (count >= 15) {
+        *token = 15 << 4;
+        out = Lz_WriteLength(out, count);
+    } else {
+        *token = (unsigned char)(count << 4);
+    }
+    memcpy(out, anchor, count);
+    return out + count;
+}
+
+size_t Lz_Compress(const void* src, size_t srcSize, void* dst, size_t dstCapacity) {
+    if (dstCapacity < Lz_MaxCompressedSize(srcSize)) {
+        return 0;
+    }
+
+    const unsigned char* in = (const unsigned char*)src;
+    const unsigned char* end = in + srcSize;
+    unsigned char* out = (unsigned char*)dst;
+
+    // Positions are stored as offsets from `in`; -1 marks an empty slot
+    size_t tableSize = sizeof(int32_t) * LZ_HASH_SIZE;
+    int32_t* table = (int32_t*)Mem_ScratchAlloc(MEM_SUBSYSTEM_SCENE, tableSize);
+    if (!table) {
+        return 0;
+    }
+    memset(table, 0xFF, tableSize);
+
+    const unsigned char* anchor = in;
+    const unsigned char* p = in;
+    // Matches must leave at least LZ_MIN_MATCH bytes to hash
+    const unsigned char* matchLimit = srcSize >= LZ_MIN_MATCH ? end - LZ_MIN_MATCH : in;
+
+    while (p < matchLimit) {
+        uint32_t sequence = Lz_Read32(p);
+        uint32_t h = Lz_Hash(sequence);
+        int32_t candidate = table[h];
+        table[h] = (int32_t)(p - in);
+
+        if (candidate < 0 || (size_t)(p - in) - (size_t)candidate > LZ_WINDOW_SIZE ||
+            Lz_Read32(in + candidate) != sequence) {
+            p++;
+            continue;
+        }
+
+        const unsigned char* match = in + candidate;
+        const unsigned char* q = p + LZ_MIN_MATCH;
+        const unsigned char* m = match + LZ_MIN_MATCH;
+        while (q < end && *q == *m) {
+            q++;
+            m++;
+        }
+
+        size_t literals = (size_t)(p - anchor);
+        size_t matchLength = (size_t)(q - p) - LZ_MIN_MATCH;
+        size_t offset = (size_t)(p - match);
+
+        unsigned char* token = out++;
+        *token = (unsigned char)((literals >= 15 ? 15 : literals) << 4);
+        if (literals >= 15) out = Lz_WriteLength(out, literals);
+        memcpy(out, anchor, literals);
+        out += literals;
+
+        *out++ = (unsigned char)offset;
+        *out++ = (unsigned char)(offset >> 8);
+
+        *token |= (unsigned char)(matchLength >= 15 ? 15 : matchLength);
+        if (matchLength >= 15) out = Lz_WriteLength(out, matchLength);
+
+        // Seed the table near the end of the match so a repeat right after it is found
+        const unsigned char* seed = q - 2;
+        if (seed > p && seed < matchLimit) {
+            table[Lz_Hash(Lz_Read32(seed))] = (int32_t)(seed - in);
+        }
+
+        p = q;
+        anchor = q;
+    }
+
+    out = Lz_WriteLiterals(out, anchor, (size_t)(end - anchor));
+    Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, table, tableSize);
+    return (size_t)(out - (unsigned char*)dst);
+}
+
+// Reads a length continued past its nibble; false if the input runs out
+static bool Lz_ReadLength(const unsigned char** in, const unsigned char* end, size_t* length) {
+    unsigned char byte;
+    do {
+        if (*in >= end) return false;
+        byte = *(*in)++;
+        *length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+size_t Lz_Decompress(const void* src, size_t srcSize, void* dst, size_t dstCapacity) {
+    const unsigned char* in = (const unsigned char*)src;
+    const unsigned char* inEnd = in + srcSize;
+    unsigned char* out = (unsigned char*)dst;
+    unsigned char* outStart = out;
+    unsigned char* outEnd = out + dstCapacity;
+
+    while (in < inEnd) {
+        unsigned char token = *in++;
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !Lz_ReadLength(&in, inEnd, &literals)) return 0;
+        if (literals > (size_t)(inEnd - in) || literals > (size_t)(outEnd - out)) return 0;
+        memcpy(out, in, literals);
+        in += literals;
+        out += literals;
+
+        // The last sequence has literals only
+        if (in == inEnd) break;
+
+        if (inEnd - in < 2) return 0;
+        size_t offset = (size_t)in[0] | ((size_t)in[1] << 8);
+        in += 2;
+        if (offset == 0 || offset > (size_t)(out - outStart)) return 0;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !Lz_ReadLength(&in, inEnd, &matchLength)) return 0;
+        matchLength += LZ_MIN_MATCH;
+        if (matchLength > (size_t)(outEnd - out)) return 0;
+
+        // Overlapping copies repeat the last `offset` bytes, so go forward a byte at a time
+        const unsigned char* match = out - offset;
+        if (offset >= matchLength) {
+            memcpy(out, match, matchLength);
+            out += matchLength;
+        } else {
+            for (size_t i = 0; i < matchLength; i++) *out++ = *match++;
+        }
+    }
+
+    return (size_t)(out - outStart);
+}
@@ -3,11 +3,25 @@
 #include <pspctrl.h>
 #include <pspdebug.h>
 #include <pspkernel.h>
+#include <string.h>
 #include "ecs.h"
 #include "menu.h"
 #include "keybinds.h"
 #include "scene.h"
+#include "stress_scene.h"
 #include "camera.h"
+#include "mem.h"
+#include "render_batch.h"
+#include "render_queue.h"
+#include "mesh_cache.h"
+#include "static_bvh.h"
+#include "scheduler.h"
+#include "timestep.h"
+#include "profiler.h"
+
+// Depth range handed to rlSetClipPlanes; culling uses the same planes
+#define CLIP_NEAR 0.01f
+#define CLIP_FAR 1000.0f
 
 PSP_MODULE_INFO("PSP-ECS", 0, 1, 0);
 PSP_MAIN_THREAD_ATTR(THREAD_ATTR_USER | THREAD_ATTR_VFPU);
@@ -16,6 +30,20 @@ PSP_MAIN_THREAD_ATTR(THREAD_ATTR_USER | THREAD_ATTR_VFPU);
 KeyBindingSystem g_keybinds;
 MenuSystem g_menu;
 ECSWorld g_world;
+StaticBVH g_staticBVH;
+Scheduler g_scheduler;
+FixedTimestep g_timestep;
+
+#if STRESS_SCENE_ENTITIES > 0
+// Procedural load replacing the test scene; also drives the spin system
+StressSceneConfig g_stressScene;
+#endif
+
+// Frame profiler overlay, toggled with SELECT
+bool g_showProfiler = false;
+
+// Play time since the last autosave
+float g_autosaveTimer = 0.0f;
 
 // Exit callback
 int running = 1;
@@ -40,44 +68,97 @@ int SetupGameCallbacks(void) {
     return thid;
 }
 
-void UpdateGameCamera(float deltaTime) {
-    // Find camera entity and update it
-    for (int i = 0; i < MAX_ENTITIES; i++) {
-        if (!g_world.entities[i].active) continue;
-        
-        if (ECS_HasComponent(&g_world, i, COMPONENT_CAMERA) && 
-            ECS_HasComponent(&g_world, i, COMPONENT_INPUT)) {
-            
-            CameraComponent* camera = (CameraComponent*)ECS_GetComponent(&g_world, i, COMPONENT_CAMERA);
-            if (camera) {
-                Camera_UpdateControls(camera, &g_keybinds, deltaTime);
-            }
+#define CAMERA_CONTROL_MASK (COMPONENT_BIT(COMPONENT_CAMERA) | COMPONENT_BIT(COMPONENT_INPUT))
+
+void UpdateGameCamera(ECSWorld* world, float deltaTime, void* user) {
+    // Update every camera entity that also takes input
+    ECSQueryIter iter = ECS_QueryIter(world, ECS_GetQuery(world, CAMERA_CONTROL_MASK));
+
+    PROFILE_BEGIN(PROFILE_CAMERA);
+    while (ECS_QueryNext(&iter)) {
+        CameraComponent* camera = (CameraComponent*)iter.components[COMPONENT_CAMERA];
+        Camera_BeginTick(camera, world);
+        Camera3D before = camera->camera;
+        Camera_UpdateControls(camera, (KeyBindingSystem*)user, deltaTime);
+
+        // Only a camera that moved goes into the next autosave
+        if (memcmp(&before, &camera->camera, sizeof(before)) != 0) {
+            ECS_MarkChanged(world, iter.entity, COMPONENT_CAMERA);
         }
     }
+    PROFILE_END(PROFILE_CAMERA);
+}
+
+void PrepareGameCamera(ECSWorld* world) {
+    ECS_GetQuery(world, CAMERA_CONTROL_MASK);
+}
+
+void UpdateTransforms(ECSWorld* world, float deltaTime, void* user) {
+    System_UpdateTransforms(world);
+}
+
+void RegisterSystems(void) {
+    Scheduler_Init(&g_scheduler, 0);
+
+    // Each system's prepare builds its queries before every run (scheduler.h)
+    SystemDesc camera = {"camera", UpdateGameCamera, &g_keybinds,
+                         COMPONENT_BIT(COMPONENT_INPUT), COMPONENT_BIT(COMPONENT_CAMERA), PrepareGameCamera};
+    SystemDesc transforms = {"transforms", UpdateTransforms, NULL,
+                             COMPONENT_BIT(COMPONENT_TRANSFORM) | COMPONENT_BIT(COMPONENT_HIERARCHY),
+                             COMPONENT_BIT(COMPONENT_TRANSFORM), System_PrepareTransforms};
+    Scheduler_AddSystem(&g_scheduler, &camera);
+#if STRESS_SCENE_ENTITIES > 0
+    SystemDesc stress = {"stress", StressScene_Animate, &g_stressScene,
+                         COMPONENT_BIT(COMPONENT_RENDERABLE) | COMPONENT_BIT(COMPONENT_STATIC),
+                         COMPONENT_BIT(COMPONENT_TRANSFORM), StressScene_PrepareAnimate};
+    Scheduler_AddSystem(&g_scheduler, &stress);
+#endif
+    Scheduler_AddSystem(&g_scheduler, &transforms);
 }
 
 void RenderScene(void) {
-    // Find camera entity
+    // First camera match is the active one
     CameraComponent* activeCamera = NULL;
-    for (int i = 0; i < MAX_ENTITIES; i++) {
-        if (!g_world.entities[i].active) continue;
-        
-        if (ECS_HasComponent(&g_world, i, COMPONENT_CAMERA)) {
-            activeCamera = (CameraComponent*)ECS_GetComponent(&g_world, i, COMPONENT_CAMERA);
-            break;
-        }
+    ECSQueryIter iter = ECS_QueryIter(&g_world, ECS_GetQuery(&g_world, COMPONENT_BIT(COMPONENT_CAMERA)));
+    if (ECS_QueryNext(&iter)) {
+        activeCamera = (CameraComponent*)iter.components[COMPONENT_CAMERA];
     }
     
     if (activeCamera) {
-        BeginMode3D(activeCamera->camera);
+        // Between the last two ticks, like the transforms System_Render draws
+        Camera3D camera = Camera_GetRenderCamera(activeCamera, &g_world);
+        BeginMode3D(camera);
         
-        // Render all entities
-        System_Render(&g_world);
+        // Render every entity inside the camera's view volume
+        float aspect = (float)GetScreenWidth() / (float)GetScreenHeight();
+        Frustum frustum = Culling_FrustumFromCamera(&camera, aspect, CLIP_NEAR, CLIP_FAR);
+        StaticBVH_Sync(&g_staticBVH, &g_world);
+        PROFILE_BEGIN(PROFILE_RENDER);
+        System_Render(&g_world, &frustum, &g_staticBVH);
+        PROFILE_END(PROFILE_RENDER);
         
         EndMode3D();
     }
 }
 
+#if PROFILER_ENABLED
+// min/avg/max/p99 in milliseconds for every scope over the recorded frames
+void DrawProfilerOverlay(int x, int y) {
+    const int lineHeight = 11;
+    DrawRectangle(x - 4, y - 4, 232, lineHeight * (PROFILE_SCOPE_COUNT + 1) + 6, (Color){0, 0, 0, 160});
+    DrawText("ms          min    avg    max    p99", x, y, 10, YELLOW);
+    for (int i = 0; i < PROFILE_SCOPE_COUNT; i++) {
+        ProfileStats stats;
+        Profiler_GetStats((ProfileScope)i, &stats);
+        y += lineHeight;
+        DrawText(Profiler_GetScopeName((ProfileScope)i), x, y, 10, WHITE);
+        DrawText(TextFormat("%6.2f %6.2f %6.2f %6.2f", stats.min * 0.001f, stats.avg * 0.001f, stats.max * 0.001f,
+                            stats.p99 * 0.001f),
+                 x + 64, y, 10, WHITE);
+    }
+}
+#endif
+
 int main(void) {
     SetupGameCallbacks();
     
@@ -91,14 +172,24 @@ int main(void) {
     
     InitWindow(screenWidth, screenHeight, "PSP-ECS Demo");
     SetWindowSize(screenWidth, screenHeight);
-    rlSetClipPlanes(0.01f, 1000.0f);
+    rlSetClipPlanes(CLIP_NEAR, CLIP_FAR);
     SetTargetFPS(60);
     
     // Initialize systems
+    Mem_Init();
     Keybinds_Init(&g_keybinds);
     Menu_Init(&g_menu);
+    StaticBVH_Init(&g_staticBVH);
     Scene_Init(&g_world);
+#if STRESS_SCENE_ENTITIES > 0
+    StressScene_DefaultConfig(&g_stressScene);
+    g_stressScene.entityCount = STRESS_SCENE_ENTITIES;
+    StressScene_Create(&g_world, &g_stressScene);
+#else
     Scene_CreateTestScene(&g_world);
+#endif
+    RegisterSystems();
+    FixedTimestep_Init(&g_timestep, TIMESTEP_DEFAULT_RATE, TIMESTEP_DEFAULT_MAX_STEPS);
     
     // Main game loop
     // Initialize pad states (oldPad starts at zero, meaning no buttons pressed on first frame)
@@ -106,9 +197,12 @@ int main(void) {
     SceCtrlData oldPad = {0};
     
     while (running && !WindowShouldClose()) {
-        float deltaTime = GetFrameTime();
+        // Frame scratch from the previous frame is reclaimed here
+        Mem_BeginFrame();
+        PROFILE_FRAME_BEGIN();
         
         // Input handling
+        PROFILE_BEGIN(PROFILE_INPUT);
         oldPad = pad;
         sceCtrlReadBufferPositive(&pad, 1);
         
@@ -122,14 +216,38 @@ int main(void) {
             }
         }
         
-        // Update
+        unsigned int profilerButton = Keybinds_GetBinding(&g_keybinds, ACTION_TOGGLE_PROFILER);
+        if ((pad.Buttons & profilerButton) && !(oldPad.Buttons & profilerButton)) {
+            g_showProfiler = !g_showProfiler;
+        }
+        PROFILE_END(PROFILE_INPUT);
+        
+        // Update: the simulation advances in fixed ticks, paused while the menu is open
         if (Menu_IsActive(&g_menu)) {
+            PROFILE_BEGIN(PROFILE_MENU);
             Menu_Update(&g_menu);
+            PROFILE_END(PROFILE_MENU);
+            ECS_SetInterpolation(&g_world, 1.0f);
         } else {
-                UpdateGameCamera(deltaTime);
+            int ticks = FixedTimestep_Advance(&g_timestep, GetFrameTime());
+            for (int i = 0; i < ticks; i++) {
+                ECS_BeginTick(&g_world);
+                Scheduler_Run(&g_scheduler, &g_world, g_timestep.step);
+            }
+            ECS_SetInterpolation(&g_world, FixedTimestep_GetAlpha(&g_timestep));
+
+#if SCENE_AUTOSAVE_SECONDS > 0
+            // Only what changed since the last autosave is written
+            g_autosaveTimer += GetFrameTime();
+            if (g_autosaveTimer >= SCENE_AUTOSAVE_SECONDS) {
+                g_autosaveTimer = 0.0f;
+                Scene_Autosave(&g_world);
+            }
+#endif
         }
         
         // Render
+        RenderBatch_ResetStats();
         BeginDrawing();
         
         ClearBackground((Color){100, 100, 100, 255}); // Gray background
@@ -140,6 +258,17 @@ int main(void) {
             // Draw HUD
             DrawText("PSP-ECS Demo", 10, 10, 20, WHITE);
             DrawFPS(screenWidth - 80, 10);
+            const RenderStats* renderStats = RenderBatch_GetStats();
+            DrawText(TextFormat("Draws: %d  States: %d  Verts: %d", renderStats->drawCalls,
+                                renderStats->stateChanges, renderStats->vertices),
+                     10, 35, 15, LIGHTGRAY);
+            DrawText(TextFormat("Visible: %d  Culled: %d", renderStats->visible, renderStats->culled),
+                     10, 52, 15, LIGHTGRAY);
+            DrawText(TextFormat("Sphere LOD: %d/%d/%d/%d  Tris: %d", renderStats->sphereLods[0],
+                                renderStats->sphereLods[1], renderStats->sphereLods[2], renderStats->sphereLods[3],
+                                renderStats->sphereTriangles[0] + renderStats->sphereTriangles[1] +
+                                renderStats->sphereTriangles[2] + renderStats->sphereTriangles[3]),
+                     10, 69, 15, LIGHTGRAY);
             DrawText("Press START for menu", 10, screenHeight - 30, 15, LIGHTGRAY);
         } else {
             // Still render the scene in background but darker
@@ -149,11 +278,25 @@ int main(void) {
         // Render menu on top
         Menu_Render(&g_menu);
         
+#if PROFILER_ENABLED
+        if (g_showProfiler) {
+            DrawProfilerOverlay(14, 92);
+        }
+#endif
+        
+        PROFILE_BEGIN(PROFILE_PRESENT);
         EndDrawing();
+        PROFILE_END(PROFILE_PRESENT);
     }
     
     // Cleanup
+    Scheduler_Shutdown(&g_scheduler);
     ECS_Cleanup(&g_world);
+    StaticBVH_Release(&g_staticBVH);
+    MeshCache_Shutdown();
+    RenderQueue_Shutdown();
+    RenderBatch_Shutdown();
+    Mem_Shutdown();
     CloseWindow();
     
     sceKernelExitGame();
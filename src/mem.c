@@ -0,0 +1,223 @@
+#include "mem.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MEM_ALIGN_UP(size) (((size) + (MEM_ALIGN - 1)) & ~(size_t)(MEM_ALIGN - 1))
+
+// Slab header; keeps the first block MEM_ALIGN-aligned
+#define MEM_SLAB_HEADER MEM_ALIGN_UP(sizeof(void*))
+
+static MemStats g_memStats[MEM_SUBSYSTEM_COUNT];
+static MemArena g_frameArena;
+
+static const char* g_subsystemNames[MEM_SUBSYSTEM_COUNT] = {
+    "ECS",
+    "Scene",
+    "Menu",
+    "Render",
+    "Spatial"
+};
+
+static void Mem_Track(MemSubsystem subsystem, size_t size) {
+    MemStats* stats = &g_memStats[subsystem];
+    stats->currentBytes += size;
+    stats->allocCount++;
+    stats->allocBytes += size;
+    if (stats->currentBytes > stats->peakBytes) {
+        stats->peakBytes = stats->currentBytes;
+    }
+}
+
+static void Mem_Untrack(MemSubsystem subsystem, size_t size) {
+    g_memStats[subsystem].currentBytes -= size;
+}
+
+static void Mem_Fail(MemSubsystem subsystem, size_t size) {
+    g_memStats[subsystem].failedCount++;
+    g_memStats[subsystem].lastFailedBytes = size;
+}
+
+void* Mem_Alloc(MemSubsystem subsystem, size_t size) {
+    void* ptr = malloc(size);
+    if (!ptr) {
+        // Memory allocation failed - critical on PSP with limited RAM
+        Mem_Fail(subsystem, size);
+        return NULL;
+    }
+    Mem_Track(subsystem, size);
+    return ptr;
+}
+
+void* Mem_Realloc(MemSubsystem subsystem, void* ptr, size_t oldSize, size_t newSize) {
+    void* grown = realloc(ptr, newSize);
+    if (!grown) {
+        // The original block is untouched and still charged
+        Mem_Fail(subsystem, newSize);
+        return NULL;
+    }
+    Mem_Untrack(subsystem, ptr ? oldSize : 0);
+    Mem_Track(subsystem, newSize);
+    return grown;
+}
+
+void Mem_Free(MemSubsystem subsystem, void* ptr, size_t size) {
+    if (!ptr) return;
+    Mem_Untrack(subsystem, size);
+    free(ptr);
+}
+
+void MemPool_Init(MemPool* pool, MemSubsystem subsystem, size_t blockSize, int blocksPerSlab) {
+    memset(pool, 0, sizeof(MemPool));
+    pool->subsystem = subsystem;
+    pool->blockSize = MEM_ALIGN_UP(blockSize < sizeof(void*) ? sizeof(void*) : blockSize);
+    pool->blocksPerSlab = blocksPerSlab > 0 ? blocksPerSlab : 1;
+}
+
+static bool MemPool_AddSlab(MemPool* pool) {
+    unsigned char* slab = (unsigned char*)malloc(MEM_SLAB_HEADER + pool->blockSize * (size_t)pool->blocksPerSlab);
+    if (!slab) {
+        return false;
+    }
+
+    *(void**)slab = pool->slabs;
+    pool->slabs = slab;
+
+    // Thread the new blocks onto the free list, lowest address first out
+    unsigned char* blocks = slab + MEM_SLAB_HEADER;
+    for (int i = pool->blocksPerSlab - 1; i >= 0; i--) {
+        void* block = blocks + (size_t)i * pool->blockSize;
+        *(void**)block = pool->freeList;
+        pool->freeList = block;
+    }
+
+    pool->totalBlocks += pool->blocksPerSlab;
+    return true;
+}
+
+void* MemPool_Alloc(MemPool* pool) {
+    if (!pool->freeList && !MemPool_AddSlab(pool)) {
+        // Memory allocation failed - critical on PSP with limited RAM
+        Mem_Fail(pool->subsystem, pool->blockSize);
+        return NULL;
+    }
+
+    void* block = pool->freeList;
+    pool->freeList = *(void**)block;
+    pool->usedBlocks++;
+    Mem_Track(pool->subsystem, pool->blockSize);
+    return block;
+}
+
+void MemPool_Free(MemPool* pool, void* block) {
+    if (!block) return;
+    *(void**)block = pool->freeList;
+    pool->freeList = block;
+    pool->usedBlocks--;
+    Mem_Untrack(pool->subsystem, pool->blockSize);
+}
+
+void MemPool_Release(MemPool* pool) {
+    Mem_Untrack(pool->subsystem, pool->blockSize * (size_t)pool->usedBlocks);
+
+    void* slab = pool->slabs;
+    while (slab) {
+        void* next = *(void**)slab;
+        free(slab);
+        slab = next;
+    }
+
+    pool->slabs = NULL;
+    pool->freeList = NULL;
+    pool->usedBlocks = 0;
+    pool->totalBlocks = 0;
+}
+
+bool MemArena_Init(MemArena* arena, size_t size) {
+    memset(arena, 0, sizeof(MemArena));
+    arena->base = (unsigned char*)malloc(size);
+    if (!arena->base) {
+        return false;
+    }
+    arena->size = size;
+    return true;
+}
+
+void* MemArena_Alloc(MemArena* arena, MemSubsystem subsystem, size_t size) {
+    size_t offset = MEM_ALIGN_UP(arena->offset);
+    if (!arena->base || size > arena->size || offset > arena->size - size) {
+        Mem_Fail(subsystem, size);
+        return NULL;
+    }
+
+    arena->offset = offset + size;
+    if (arena->offset > arena->peak) {
+        arena->peak = arena->offset;
+    }
+    arena->used[subsystem] += size;
+    Mem_Track(subsystem, size);
+    return arena->base + offset;
+}
+
+void MemArena_Reset(MemArena* arena) {
+    for (int i = 0; i < MEM_SUBSYSTEM_COUNT; i++) {
+        Mem_Untrack((MemSubsystem)i, arena->used[i]);
+        arena->used[i] = 0;
+    }
+    arena->offset = 0;
+}
+
+void MemArena_Release(MemArena* arena) {
+    MemArena_Reset(arena);
+    free(arena->base);
+    arena->base = NULL;
+    arena->size = 0;
+}
+
+bool Mem_Init(void) {
+    return MemArena_Init(&g_frameArena, MEM_FRAME_ARENA_SIZE);
+}
+
+void Mem_Shutdown(void) {
+    MemArena_Release(&g_frameArena);
+}
+
+void Mem_BeginFrame(void) {
+    MemArena_Reset(&g_frameArena);
+}
+
+MemArena* Mem_GetFrameArena(void) {
+    return &g_frameArena;
+}
+
+static bool Mem_InFrameArena(const void* ptr) {
+    const unsigned char* p = (const unsigned char*)ptr;
+    return g_frameArena.base && p >= g_frameArena.base && p < g_frameArena.base + g_frameArena.size;
+}
+
+void* Mem_ScratchAlloc(MemSubsystem subsystem, size_t size) {
+    // Probe for room first so a full arena is not counted as a failure
+    size_t offset = MEM_ALIGN_UP(g_frameArena.offset);
+    if (g_frameArena.base && size <= g_frameArena.size && offset <= g_frameArena.size - size) {
+        return MemArena_Alloc(&g_frameArena, subsystem, size);
+    }
+    return Mem_Alloc(subsystem, size);
+}
+
+void Mem_ScratchFree(MemSubsystem subsystem, void* ptr, size_t size) {
+    if (!ptr || Mem_InFrameArena(ptr)) return;
+    Mem_Free(subsystem, ptr, size);
+}
+
+const MemStats* Mem_GetStats(MemSubsystem subsystem) {
+    if (subsystem < 0 || subsystem >= MEM_SUBSYSTEM_COUNT) {
+        return NULL;
+    }
+    return &g_memStats[subsystem];
+}
+
+const char* Mem_GetSubsystemName(MemSubsystem subsystem) {
+    if (subsystem < 0 || subsystem >= MEM_SUBSYSTEM_COUNT) {
+        return "Unknown";
+    }
+    return g_subsystemNames[subsystem];
+}
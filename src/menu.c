@@ -13,12 +13,14 @@ static void Menu_Action_Options(void);
 static void Menu_Action_Back(void);
 static void Menu_Action_Save(void);
 static void Menu_Action_Load(void);
+static void Menu_Action_LoadAutosave(void);
 static void Menu_Action_Keybindings(void);
 
 static MenuItem mainMenuItems[] = {
     {"Start Game", Menu_Action_Start},
     {"Save Game", Menu_Action_Save},
     {"Load Game", Menu_Action_Load},
+    {"Load Autosave", Menu_Action_LoadAutosave},
     {"Options", Menu_Action_Options}
 };
 
@@ -90,6 +92,17 @@ static void Menu_Action_Load(void) {
     }
 }
 
+static void Menu_Action_LoadAutosave(void) {
+    if (!Scene_HasAutosave()) {
+        Menu_ShowStatus("No autosave found!", 180);
+        return;
+    }
+
+    if (!Scene_LoadAutosave(&g_world)) {
+        Menu_ShowStatus("Load failed", 180);
+    }
+}
+
 void Menu_Update(MenuSystem* menu) {
     if (!menu->isActive) return;
 
@@ -191,7 +204,7 @@ void Menu_Render(MenuSystem* menu) {
     if (menu->currentMenu == MENU_KEYBINDINGS) {
         // Display in-game keybindings (excluding menu actions)
         int startY = 55;
-        int lineSpacing = 22;
+        int lineSpacing = 20;
         int currentY = startY;
         
         // Helper function to get button name
@@ -221,31 +234,17 @@ void Menu_Render(MenuSystem* menu) {
             ACTION_MOVE_RIGHT,
             ACTION_MOVE_UP,
             ACTION_MOVE_DOWN,
-            ACTION_TOGGLE_MENU
+            ACTION_TOGGLE_MENU,
+            ACTION_TOGGLE_PROFILER
         };
         
-        // First pass: calculate max width for centering
-        int maxWidth = 0;
-        for (int i = 0; i < 7; i++) {
-            ActionID action = inGameActions[i];
-            unsigned int button = Keybinds_GetBinding(&g_keybinds, action);
-            const char* actionName = Keybinds_GetActionName(action);
-            const char* buttonName = GetButtonName(button);
-            
-            char line[128];
-            snprintf(line, sizeof(line), "%s: %s", actionName, buttonName);
-            int lineWidth = MeasureText(line, 16);
-            if (lineWidth > maxWidth) maxWidth = lineWidth;
-        }
-        
-        // Second pass: draw centered
-        currentY = startY;
-        for (int i = 0; i < 7; i++) {
+        // Draw each line centered on its own width
+        for (int i = 0; i < 8; i++) {
             ActionID action = inGameActions[i];
             unsigned int button = Keybinds_GetBinding(&g_keybinds, action);
             const char* actionName = Keybinds_GetActionName(action);
             const char* buttonName = GetButtonName(button);
-            
+
             char line[128];
             snprintf(line, sizeof(line), "%s: %s", actionName, buttonName);
             int lineWidth = MeasureText(line, 16);
@@ -255,9 +254,13 @@ void Menu_Render(MenuSystem* menu) {
         }
     } else {
         // Draw menu items
+        // Spread the items over the space above the status line, at most 40 apart
         int startY = 55;
         int itemSpacing = 40;
-        
+        if (itemCount > 0 && startY + itemCount * itemSpacing > screenHeight - 60) {
+            itemSpacing = (screenHeight - 60 - startY) / itemCount;
+        }
+
         for (int i = 0; i < itemCount; i++) {
             Color color = (i == menu->selectedItem) ? YELLOW : WHITE;
             const char* prefix = (i == menu->selectedItem) ? "> " : "  ";
@@ -0,0 +1,225 @@
+#include "mesh_cache.h"
+#include "mem.h"
+#include <rlgl.h>
+#include <string.h>
+
+// DrawGrid's line colors: the center lines are darker
+#define MESH_GRID_CENTER_COLOR (Color){128, 128, 128, 255}
+#define MESH_GRID_LINE_COLOR (Color){191, 191, 191, 255}
+
+// Direct-mapped hints from key hash to slot + 1, so a repeated key is found
+// without scanning; a stale hint just falls through to the scan
+#define MESH_CACHE_HINTS 64
+
+static CachedMesh g_meshes[MESH_CACHE_CAPACITY];
+static unsigned char g_meshHints[MESH_CACHE_HINTS];
+static unsigned int g_meshFrame = 0;
+static MeshCacheStats g_meshStats;
+
+static bool MeshCache_SameColor(Color a, Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+static void MeshCache_Free(CachedMesh* mesh) {
+    if (!mesh->used) return;
+    Mem_Free(MEM_SUBSYSTEM_RENDER, mesh->vertices, sizeof(Vector3) * (size_t)mesh->vertexCount);
+    Mem_Free(MEM_SUBSYSTEM_RENDER, mesh->colors, sizeof(Color) * (size_t)mesh->vertexCount);
+    g_meshStats.meshes--;
+    g_meshStats.vertices -= mesh->vertexCount;
+    memset(mesh, 0, sizeof(CachedMesh));
+}
+
+static bool MeshCache_Matches(const CachedMesh* mesh, MeshKind kind, Vector3 size, Color color) {
+    return mesh->used && mesh->kind == kind && MeshCache_SameColor(mesh->color, color) &&
+           mesh->size.x == size.x && mesh->size.y == size.y && mesh->size.z == size.z;
+}
+
+static unsigned int MeshCache_Hash(MeshKind kind, Vector3 size, Color color) {
+    unsigned int bits[3];
+    memcpy(bits, &size, sizeof(bits));
+    unsigned int hash = (unsigned int)kind * 0x9E3779B1u;
+    hash = (hash ^ bits[0]) * 0x85EBCA77u;
+    hash = (hash ^ bits[1]) * 0xC2B2AE3Du;
+    hash = (hash ^ bits[2]) * 0x85EBCA77u;
+    hash = (hash ^ ((unsigned int)color.r << 24 | (unsigned int)color.g << 16 | (unsigned int)color.b << 8 | color.a)) * 0xC2B2AE3Du;
+    return (hash ^ (hash >> 16)) & (MESH_CACHE_HINTS - 1);
+}
+
+// Finds the mesh for a key, or claims a free / least recently used slot for
+// it. Returns NULL without evicting when every slot was already drawn this
+// frame: more distinct keys than slots would otherwise rebuild every mesh
+// every frame, which costs more than drawing them directly.
+static CachedMesh* MeshCache_Lookup(MeshKind kind, Vector3 size, Color color, bool* found) {
+    unsigned int hint = MeshCache_Hash(kind, size, color);
+    CachedMesh* mesh = g_meshHints[hint] ? &g_meshes[g_meshHints[hint] - 1] : NULL;
+    if (mesh && MeshCache_Matches(mesh, kind, size, color)) {
+        mesh->lastUsed = g_meshFrame;
+        g_meshStats.hits++;
+        *found = true;
+        return mesh;
+    }
+
+    CachedMesh* slot = NULL;
+    for (int i = 0; i < MESH_CACHE_CAPACITY; i++) {
+        mesh = &g_meshes[i];
+        if (MeshCache_Matches(mesh, kind, size, color)) {
+            mesh->lastUsed = g_meshFrame;
+            g_meshHints[hint] = (unsigned char)(i + 1);
+            g_meshStats.hits++;
+            *found = true;
+            return mesh;
+        }
+        if (!slot || (slot->used && (!mesh->used || mesh->lastUsed < slot->lastUsed))) {
+            slot = mesh;
+        }
+    }
+
+    *found = false;
+    if (slot->used) {
+        if (slot->lastUsed == g_meshFrame) return NULL;
+        MeshCache_Free(slot);
+        g_meshStats.evictions++;
+    }
+    g_meshHints[hint] = (unsigned char)(slot - g_meshes + 1);
+    return slot;
+}
+
+static bool MeshCache_Allocate(CachedMesh* mesh, MeshKind kind, Vector3 size, Color color,
+                               int mode, int vertexCount, bool perVertexColors) {
+    mesh->vertices = (Vector3*)Mem_Alloc(MEM_SUBSYSTEM_RENDER, sizeof(Vector3) * (size_t)vertexCount);
+    mesh->colors = perVertexColors ? (Color*)Mem_Alloc(MEM_SUBSYSTEM_RENDER, sizeof(Color) * (size_t)vertexCount) : NULL;
+    if (!mesh->vertices || (perVertexColors && !mesh->colors)) {
+        Mem_Free(MEM_SUBSYSTEM_RENDER, mesh->vertices, sizeof(Vector3) * (size_t)vertexCount);
+        Mem_Free(MEM_SUBSYSTEM_RENDER, mesh->colors, sizeof(Color) * (size_t)vertexCount);
+        memset(mesh, 0, sizeof(CachedMesh));
+        return false;
+    }
+
+    mesh->kind = kind;
+    mesh->size = size;
+    mesh->color = color;
+    mesh->mode = mode;
+    mesh->vertexCount = vertexCount;
+    mesh->lastUsed = g_meshFrame;
+    mesh->used = true;
+    g_meshStats.builds++;
+    g_meshStats.meshes++;
+    g_meshStats.vertices += vertexCount;
+    return true;
+}
+
+const CachedMesh* MeshCache_GetPlane(Vector2 size, Color color) {
+    Vector3 key = {size.x, 0.0f, size.y};
+    bool found;
+    CachedMesh* mesh = MeshCache_Lookup(MESH_KIND_PLANE, key, color, &found);
+    if (!mesh || found) return mesh;
+    if (!MeshCache_Allocate(mesh, MESH_KIND_PLANE, key, color, RL_QUADS, 4, false)) return NULL;
+
+    // Same winding as DrawPlane
+    float hx = size.x * 0.5f;
+    float hz = size.y * 0.5f;
+    mesh->vertices[0] = (Vector3){-hx, 0.0f, -hz};
+    mesh->vertices[1] = (Vector3){-hx, 0.0f, hz};
+    mesh->vertices[2] = (Vector3){hx, 0.0f, hz};
+    mesh->vertices[3] = (Vector3){hx, 0.0f, -hz};
+    return mesh;
+}
+
+const CachedMesh* MeshCache_GetPlaneWire(Vector2 size, Color color) {
+    Vector3 key = {size.x, 0.0f, size.y};
+    bool found;
+    CachedMesh* mesh = MeshCache_Lookup(MESH_KIND_PLANE_WIRE, key, color, &found);
+    if (!mesh || found) return mesh;
+    if (!MeshCache_Allocate(mesh, MESH_KIND_PLANE_WIRE, key, color, RL_LINES, 8, false)) return NULL;
+
+    float hx = size.x * 0.5f;
+    float hz = size.y * 0.5f;
+    Vector3 corners[4] = {{-hx, 0.0f, -hz}, {hx, 0.0f, -hz}, {hx, 0.0f, hz}, {-hx, 0.0f, hz}};
+    for (int i = 0; i < 4; i++) {
+        mesh->vertices[i * 2] = corners[i];
+        mesh->vertices[i * 2 + 1] = corners[(i + 1) % 4];
+    }
+    return mesh;
+}
+
+const CachedMesh* MeshCache_GetGrid(int slices, float spacing) {
+    Vector3 key = {(float)slices, 0.0f, spacing};
+    bool found;
+    CachedMesh* mesh = MeshCache_Lookup(MESH_KIND_GRID, key, MESH_GRID_LINE_COLOR, &found);
+    if (!mesh || found) return mesh;
+
+    // The lines DrawGrid emits, in the same order
+    int halfSlices = slices / 2;
+    if (!MeshCache_Allocate(mesh, MESH_KIND_GRID, key, MESH_GRID_LINE_COLOR, RL_LINES, (halfSlices * 2 + 1) * 4, true)) {
+        return NULL;
+    }
+
+    float extent = (float)halfSlices * spacing;
+    int v = 0;
+    for (int i = -halfSlices; i <= halfSlices; i++) {
+        Color color = (i == 0) ? MESH_GRID_CENTER_COLOR : MESH_GRID_LINE_COLOR;
+        float offset = (float)i * spacing;
+        mesh->vertices[v] = (Vector3){offset, 0.0f, -extent};
+        mesh->vertices[v + 1] = (Vector3){offset, 0.0f, extent};
+        mesh->vertices[v + 2] = (Vector3){-extent, 0.0f, offset};
+        mesh->vertices[v + 3] = (Vector3){extent, 0.0f, offset};
+        for (int c = 0; c < 4; c++) mesh->colors[v + c] = color;
+        v += 4;
+    }
+    return mesh;
+}
+
+// Emits one vertex, transformed when a matrix is given
+static void MeshCache_Vertex(const Vector3* v, const Matrix* world) {
+    if (!world) {
+        rlVertex3f(v->x, v->y, v->z);
+        return;
+    }
+    rlVertex3f(world->m0 * v->x + world->m4 * v->y + world->m8 * v->z + world->m12,
+               world->m1 * v->x + world->m5 * v->y + world->m9 * v->z + world->m13,
+               world->m2 * v->x + world->m6 * v->y + world->m10 * v->z + world->m14);
+}
+
+void MeshCache_Draw(const CachedMesh* mesh, const Matrix* world) {
+    rlCheckRenderBatchLimit(mesh->vertexCount);
+    rlBegin(mesh->mode);
+
+    if (!mesh->colors) {
+        rlColor4ub(mesh->color.r, mesh->color.g, mesh->color.b, mesh->color.a);
+        for (int i = 0; i < mesh->vertexCount; i++) {
+            MeshCache_Vertex(&mesh->vertices[i], world);
+        }
+    } else {
+        Color color = mesh->colors[0];
+        rlColor4ub(color.r, color.g, color.b, color.a);
+        for (int i = 0; i < mesh->vertexCount; i++) {
+            if (!MeshCache_SameColor(mesh->colors[i], color)) {
+                color = mesh->colors[i];
+                rlColor4ub(color.r, color.g, color.b, color.a);
+            }
+            MeshCache_Vertex(&mesh->vertices[i], world);
+        }
+    }
+
+    rlEnd();
+}
+
+void MeshCache_BeginFrame(void) {
+    g_meshFrame++;
+}
+
+void MeshCache_Clear(void) {
+    for (int i = 0; i < MESH_CACHE_CAPACITY; i++) {
+        MeshCache_Free(&g_meshes[i]);
+    }
+    memset(g_meshHints, 0, sizeof(g_meshHints));
+}
+
+void MeshCache_Shutdown(void) {
+    MeshCache_Clear();
+    memset(&g_meshStats, 0, sizeof(g_meshStats));
+}
+
+const MeshCacheStats* MeshCache_GetStats(void) {
+    return &g_meshStats;
+}
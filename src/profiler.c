@@ -0,0 +1,118 @@
+#include "profiler.h"
+#include <string.h>
+
+#if defined(__PSP__)
+#include <pspkernel.h>
+#else
+#include <time.h>
+#endif
+
+typedef struct {
+    uint64_t start;             // Clock at PROFILE_BEGIN, 0 outside the scope
+    uint64_t total;             // Time spent in the scope this frame
+} ProfileCounter;
+
+static ProfileCounter g_counters[PROFILE_SCOPE_COUNT];
+static float g_history[PROFILE_SCOPE_COUNT][PROFILER_HISTORY];   // Microseconds per frame
+static int g_historyHead;       // Next slot written
+static int g_historyCount;
+static uint64_t g_frameStart;
+
+static const char* g_scopeNames[PROFILE_SCOPE_COUNT] = {
+    "Frame",
+    "Input",
+    "Menu",
+    "Camera",
+    "Culling",
+    "Render",
+    "Present"
+};
+
+uint64_t Profiler_Now(void) {
+#if defined(__PSP__)
+    return (uint64_t)sceKernelGetSystemTimeWide();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+uint64_t Profiler_TicksPerSecond(void) {
+#if defined(__PSP__)
+    return 1000000u;
+#else
+    return 1000000000u;
+#endif
+}
+
+void Profiler_Begin(ProfileScope scope) {
+    g_counters[scope].start = Profiler_Now();
+}
+
+void Profiler_End(ProfileScope scope) {
+    ProfileCounter* counter = &g_counters[scope];
+    if (counter->start) {
+        counter->total += Profiler_Now() - counter->start;
+        counter->start = 0;
+    }
+}
+
+void Profiler_BeginFrame(void) {
+    uint64_t now = Profiler_Now();
+    if (g_frameStart) {
+        g_counters[PROFILE_FRAME].total = now - g_frameStart;
+
+        float usPerTick = 1000000.0f / (float)Profiler_TicksPerSecond();
+        for (int i = 0; i < PROFILE_SCOPE_COUNT; i++) {
+            g_history[i][g_historyHead] = (float)g_counters[i].total * usPerTick;
+            g_counters[i].total = 0;
+        }
+        g_historyHead = (g_historyHead + 1) % PROFILER_HISTORY;
+        if (g_historyCount < PROFILER_HISTORY) g_historyCount++;
+    }
+    g_frameStart = now;
+}
+
+void Profiler_Reset(void) {
+    memset(g_counters, 0, sizeof(g_counters));
+    g_historyHead = 0;
+    g_historyCount = 0;
+    g_frameStart = 0;
+}
+
+void Profiler_GetStats(ProfileScope scope, ProfileStats* stats) {
+    memset(stats, 0, sizeof(ProfileStats));
+    int count = g_historyCount;
+    if (count == 0) {
+        return;
+    }
+
+    // Insertion sort of a copy: at PROFILER_HISTORY samples it is cheap
+    // enough to run every frame the overlay is shown
+    float sorted[PROFILER_HISTORY];
+    float sum = 0.0f;
+    for (int i = 0; i < count; i++) {
+        float value = g_history[scope][i];
+        int j = i;
+        while (j > 0 && sorted[j - 1] > value) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+        sum += value;
+    }
+
+    // Nearest rank: the smallest sample at or above 99% of the frames
+    int rank = (count * 99 + 99) / 100;
+    stats->min = sorted[0];
+    stats->max = sorted[count - 1];
+    stats->avg = sum / (float)count;
+    stats->p99 = sorted[rank - 1];
+    stats->frames = count;
+}
+
+const char* Profiler_GetScopeName(ProfileScope scope) {
+    if (scope < 0 || scope >= PROFILE_SCOPE_COUNT) return "";
+    return g_scopeNames[scope];
+}
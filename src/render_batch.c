@@ -0,0 +1,378 @@
+#include "render_batch.h"
+#include "mem.h"
+#include <rlgl.h>
+#include <math.h>
+
+#define CUBE_SOLID_VERTICES 36
+#define CUBE_WIRE_VERTICES 24
+
+// Corner indices below: bit 0 = +x, bit 1 = +y, bit 2 = +z
+// Two counter-clockwise triangles per face, front, back, right, left, top, bottom
+static const unsigned char g_cubeTriangles[CUBE_SOLID_VERTICES] = {
+    4, 5, 7,  4, 7, 6,
+    1, 0, 2,  1, 2, 3,
+    5, 1, 3,  5, 3, 7,
+    0, 4, 6,  0, 6, 2,
+    6, 7, 3,  6, 3, 2,
+    0, 1, 5,  0, 5, 4
+};
+
+static const unsigned char g_cubeEdges[CUBE_WIRE_VERTICES] = {
+    0, 1,  2, 3,  4, 5,  6, 7,
+    0, 2,  1, 3,  4, 6,  5, 7,
+    0, 4,  1, 5,  2, 6,  3, 7
+};
+
+// Sphere tessellation per level: latitude bands and longitude slices.
+// Level 0 matches DrawSphere's 16 x 16.
+static const int g_sphereBands[RENDER_SPHERE_LOD_COUNT] = {16, 10, 7, 4};
+static const int g_sphereSlices[RENDER_SPHERE_LOD_COUNT] = {16, 12, 8, 6};
+
+// Smallest screen size (fraction of viewport height) drawn at each level
+// but the last
+static const float g_sphereLodSizes[RENDER_SPHERE_LOD_COUNT - 1] = {0.20f, 0.08f, 0.03f};
+
+// Ring vertices plus the two poles, and two triangles per quad minus the
+// pole caps' halves, for the finest level
+#define SPHERE_MAX_VERTICES (15 * 16 + 2)
+#define SPHERE_MAX_INDICES (2 * 16 * 15 * 3)
+
+typedef struct {
+    int vertexCount;
+    int indexCount;
+    Vector3 vertices[SPHERE_MAX_VERTICES];          // Unit diameter, centered
+    unsigned char indices[SPHERE_MAX_INDICES];      // Counter-clockwise triangles
+} SphereMesh;
+
+static SphereMesh g_sphereMeshes[RENDER_SPHERE_LOD_COUNT];
+static bool g_sphereMeshesBuilt = false;
+
+static CubeInstance* g_instances = NULL;
+static int g_instanceCount = 0;
+static int g_instanceCapacity = 0;
+static SphereInstance* g_spheres = NULL;
+static int g_sphereCount = 0;
+static int g_sphereCapacity = 0;
+static Color g_wireColor;
+static RenderStats g_renderStats;
+
+// Last primitive mode and color submitted, -1 before the first draw
+static int g_stateMode = -1;
+static Color g_stateColor;
+
+static bool RenderBatch_SameColor(Color a, Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+static void RenderBatch_SetState(int mode, Color color) {
+    if (mode != g_stateMode) {
+        // rlgl starts a new draw whenever the primitive mode changes
+        g_renderStats.drawCalls++;
+        g_renderStats.stateChanges++;
+    } else if (!RenderBatch_SameColor(color, g_stateColor)) {
+        g_renderStats.stateChanges++;
+    }
+    g_stateMode = mode;
+    g_stateColor = color;
+}
+
+// Emits one primitive pass over every collected cube
+static void RenderBatch_Pass(int mode, const unsigned char* indices, int vertexCount, bool solid) {
+    if (g_instanceCount == 0) return;
+
+    g_renderStats.vertices += g_instanceCount * vertexCount;
+
+    for (int first = 0; first < g_instanceCount; first += RENDER_BATCH_CUBES_PER_BLOCK) {
+        int last = first + RENDER_BATCH_CUBES_PER_BLOCK;
+        if (last > g_instanceCount) last = g_instanceCount;
+
+        // A flush ends the current draw and starts another
+        if (rlCheckRenderBatchLimit((last - first) * vertexCount)) {
+            g_renderStats.drawCalls++;
+        }
+
+        rlBegin(mode);
+        Color color = solid ? g_instances[first].color : g_wireColor;
+        rlColor4ub(color.r, color.g, color.b, color.a);
+        RenderBatch_SetState(mode, color);
+
+        for (int i = first; i < last; i++) {
+            const CubeInstance* cube = &g_instances[i];
+
+            // Cubes arrive sorted by color, so most runs share one
+            if (solid && !RenderBatch_SameColor(cube->color, color)) {
+                color = cube->color;
+                rlColor4ub(color.r, color.g, color.b, color.a);
+                RenderBatch_SetState(mode, color);
+            }
+
+            // Build the 8 corners once from the -x-y-z corner and the edge
+            // vectors, then emit by index
+            const Vector3* ax = &cube->axes[0];
+            const Vector3* ay = &cube->axes[1];
+            const Vector3* az = &cube->axes[2];
+            Vector3 corners[8];
+            corners[0].x = cube->position.x - 0.5f * (ax->x + ay->x + az->x);
+            corners[0].y = cube->position.y - 0.5f * (ax->y + ay->y + az->y);
+            corners[0].z = cube->position.z - 0.5f * (ax->z + ay->z + az->z);
+            for (int bit = 0; bit < 3; bit++) {
+                const Vector3* axis = &cube->axes[bit];
+                int half = 1 << bit;
+                for (int c = 0; c < half; c++) {
+                    corners[half + c].x = corners[c].x + axis->x;
+                    corners[half + c].y = corners[c].y + axis->y;
+                    corners[half + c].z = corners[c].z + axis->z;
+                }
+            }
+
+            for (int v = 0; v < vertexCount; v++) {
+                const Vector3* corner = &corners[indices[v]];
+                rlVertex3f(corner->x, corner->y, corner->z);
+            }
+        }
+
+        rlEnd();
+    }
+}
+
+// Vertex 0 is the top pole, then bands - 1 rings of `slices` vertices from
+// the top down, then the bottom pole
+static void RenderBatch_BuildSphereMesh(SphereMesh* mesh, int bands, int slices) {
+    int ringCount = bands - 1;
+    int bottom = ringCount * slices + 1;
+
+    mesh->vertices[0] = (Vector3){0.0f, 0.5f, 0.0f};
+    for (int ring = 0; ring < ringCount; ring++) {
+        float phi = PI * (float)(ring + 1) / (float)bands;
+        float y = 0.5f * cosf(phi);
+        float radius = 0.5f * sinf(phi);
+        for (int slice = 0; slice < slices; slice++) {
+            float theta = 2.0f * PI * (float)slice / (float)slices;
+            mesh->vertices[1 + ring * slices + slice] = (Vector3){radius * sinf(theta), y, radius * cosf(theta)};
+        }
+    }
+    mesh->vertices[bottom] = (Vector3){0.0f, -0.5f, 0.0f};
+    mesh->vertexCount = bottom + 1;
+
+    int count = 0;
+    for (int slice = 0; slice < slices; slice++) {
+        int next = (slice + 1) % slices;
+
+        // Top cap
+        mesh->indices[count++] = 0;
+        mesh->indices[count++] = (unsigned char)(1 + slice);
+        mesh->indices[count++] = (unsigned char)(1 + next);
+
+        for (int ring = 0; ring < ringCount - 1; ring++) {
+            unsigned char a = (unsigned char)(1 + ring * slices + slice);
+            unsigned char b = (unsigned char)(1 + ring * slices + next);
+            unsigned char c = (unsigned char)(a + slices);
+            unsigned char d = (unsigned char)(b + slices);
+            mesh->indices[count++] = a;
+            mesh->indices[count++] = c;
+            mesh->indices[count++] = d;
+            mesh->indices[count++] = a;
+            mesh->indices[count++] = d;
+            mesh->indices[count++] = b;
+        }
+
+        // Bottom cap
+        mesh->indices[count++] = (unsigned char)(1 + (ringCount - 1) * slices + slice);
+        mesh->indices[count++] = (unsigned char)bottom;
+        mesh->indices[count++] = (unsigned char)(1 + (ringCount - 1) * slices + next);
+    }
+    mesh->indexCount = count;
+}
+
+static void RenderBatch_BuildSphereMeshes(void) {
+    for (int lod = 0; lod < RENDER_SPHERE_LOD_COUNT; lod++) {
+        RenderBatch_BuildSphereMesh(&g_sphereMeshes[lod], g_sphereBands[lod], g_sphereSlices[lod]);
+    }
+    g_sphereMeshesBuilt = true;
+}
+
+// Spheres follow the cubes in the solid pass, one rlBegin per sphere so a
+// batch flush can fall between any two
+static void RenderBatch_SpherePass(void) {
+    if (g_sphereCount == 0) return;
+    if (!g_sphereMeshesBuilt) RenderBatch_BuildSphereMeshes();
+
+    for (int i = 0; i < g_sphereCount; i++) {
+        const SphereInstance* sphere = &g_spheres[i];
+        const SphereMesh* mesh = &g_sphereMeshes[sphere->lod];
+
+        if (rlCheckRenderBatchLimit(mesh->indexCount)) {
+            g_renderStats.drawCalls++;
+        }
+
+        rlBegin(RL_TRIANGLES);
+        rlColor4ub(sphere->color.r, sphere->color.g, sphere->color.b, sphere->color.a);
+        RenderBatch_SetState(RL_TRIANGLES, sphere->color);
+
+        const Vector3* ax = &sphere->axes[0];
+        const Vector3* ay = &sphere->axes[1];
+        const Vector3* az = &sphere->axes[2];
+        Vector3 points[SPHERE_MAX_VERTICES];
+        for (int v = 0; v < mesh->vertexCount; v++) {
+            const Vector3* unit = &mesh->vertices[v];
+            points[v].x = sphere->position.x + unit->x * ax->x + unit->y * ay->x + unit->z * az->x;
+            points[v].y = sphere->position.y + unit->x * ax->y + unit->y * ay->y + unit->z * az->y;
+            points[v].z = sphere->position.z + unit->x * ax->z + unit->y * ay->z + unit->z * az->z;
+        }
+        for (int v = 0; v < mesh->indexCount; v++) {
+            const Vector3* point = &points[mesh->indices[v]];
+            rlVertex3f(point->x, point->y, point->z);
+        }
+
+        rlEnd();
+
+        g_renderStats.vertices += mesh->indexCount;
+        g_renderStats.sphereLods[sphere->lod]++;
+        g_renderStats.sphereTriangles[sphere->lod] += mesh->indexCount / 3;
+    }
+}
+
+// Center and size-scaled axes of a unit shape placed by `world`
+static void RenderBatch_Placement(const Matrix* world, Vector3 size, Vector3* position, Vector3* axes) {
+    *position = (Vector3){world->m12, world->m13, world->m14};
+    axes[0] = (Vector3){world->m0 * size.x, world->m1 * size.x, world->m2 * size.x};
+    axes[1] = (Vector3){world->m4 * size.y, world->m5 * size.y, world->m6 * size.y};
+    axes[2] = (Vector3){world->m8 * size.z, world->m9 * size.z, world->m10 * size.z};
+}
+
+void RenderBatch_Begin(Color wireColor) {
+    g_instanceCount = 0;
+    g_sphereCount = 0;
+    g_wireColor = wireColor;
+    g_stateMode = -1;
+}
+
+void RenderBatch_AddCube(const Matrix* world, Vector3 size, Color color) {
+    if (g_instanceCount == g_instanceCapacity) {
+        int capacity = g_instanceCapacity > 0 ? g_instanceCapacity * 2 : 256;
+        CubeInstance* instances = (CubeInstance*)Mem_Realloc(MEM_SUBSYSTEM_RENDER, g_instances,
+                                                             sizeof(CubeInstance) * (size_t)g_instanceCapacity,
+                                                             sizeof(CubeInstance) * (size_t)capacity);
+        if (instances) {
+            g_instances = instances;
+            g_instanceCapacity = capacity;
+        } else if (g_instanceCount > 0) {
+            // Out of memory: draw what has been collected and reuse the buffer
+            RenderBatch_End();
+        } else {
+            // No buffer at all, fall back to immediate mode (unrotated)
+            Vector3 position = {world->m12, world->m13, world->m14};
+            DrawCube(position, size.x, size.y, size.z, color);
+            DrawCubeWires(position, size.x, size.y, size.z, g_wireColor);
+            RenderBatch_CountDraw(RL_TRIANGLES, color, CUBE_SOLID_VERTICES);
+            RenderBatch_CountDraw(RL_LINES, g_wireColor, CUBE_WIRE_VERTICES);
+            g_renderStats.cubes++;
+            return;
+        }
+    }
+
+    CubeInstance* cube = &g_instances[g_instanceCount++];
+    RenderBatch_Placement(world, size, &cube->position, cube->axes);
+    cube->color = color;
+}
+
+void RenderBatch_AddSphere(const Matrix* world, Vector3 size, Color color, int lod) {
+    if (lod < 0) lod = 0;
+    if (lod >= RENDER_SPHERE_LOD_COUNT) lod = RENDER_SPHERE_LOD_COUNT - 1;
+
+    if (g_sphereCount == g_sphereCapacity) {
+        int capacity = g_sphereCapacity > 0 ? g_sphereCapacity * 2 : 64;
+        SphereInstance* spheres = (SphereInstance*)Mem_Realloc(MEM_SUBSYSTEM_RENDER, g_spheres,
+                                                               sizeof(SphereInstance) * (size_t)g_sphereCapacity,
+                                                               sizeof(SphereInstance) * (size_t)capacity);
+        if (spheres) {
+            g_spheres = spheres;
+            g_sphereCapacity = capacity;
+        } else if (g_sphereCount > 0) {
+            RenderBatch_SpherePass();
+            g_sphereCount = 0;
+        } else {
+            int triangles = RenderBatch_GetSphereTriangles(lod);
+            Vector3 position = {world->m12, world->m13, world->m14};
+            DrawSphereEx(position, size.x * 0.5f, g_sphereBands[lod] - 2, g_sphereSlices[lod], color);
+            RenderBatch_CountDraw(RL_TRIANGLES, color, triangles * 3);
+            g_renderStats.sphereLods[lod]++;
+            g_renderStats.sphereTriangles[lod] += triangles;
+            return;
+        }
+    }
+
+    SphereInstance* sphere = &g_spheres[g_sphereCount++];
+    RenderBatch_Placement(world, size, &sphere->position, sphere->axes);
+    sphere->color = color;
+    sphere->lod = lod;
+}
+
+int RenderBatch_SelectSphereLod(float screenSize, int currentLod) {
+    int lod = 0;
+    while (lod < RENDER_SPHERE_LOD_COUNT - 1 && screenSize < g_sphereLodSizes[lod]) {
+        lod++;
+    }
+    if (currentLod < 0 || currentLod >= RENDER_SPHERE_LOD_COUNT || lod == currentLod) {
+        return lod;
+    }
+
+    // Stay at the current level inside a band around the threshold crossed
+    if (lod > currentLod) {
+        if (screenSize >= g_sphereLodSizes[currentLod] * (1.0f - RENDER_SPHERE_LOD_HYSTERESIS)) return currentLod;
+    } else {
+        if (screenSize < g_sphereLodSizes[currentLod - 1] * (1.0f + RENDER_SPHERE_LOD_HYSTERESIS)) return currentLod;
+    }
+    return lod;
+}
+
+int RenderBatch_GetSphereTriangles(int lod) {
+    return 2 * g_sphereSlices[lod] * (g_sphereBands[lod] - 1);
+}
+
+void RenderBatch_End(void) {
+    RenderBatch_Pass(RL_TRIANGLES, g_cubeTriangles, CUBE_SOLID_VERTICES, true);
+    RenderBatch_SpherePass();
+    RenderBatch_Pass(RL_LINES, g_cubeEdges, CUBE_WIRE_VERTICES, false);
+    g_renderStats.cubes += g_instanceCount;
+    g_instanceCount = 0;
+    g_sphereCount = 0;
+}
+
+void RenderBatch_Shutdown(void) {
+    Mem_Free(MEM_SUBSYSTEM_RENDER, g_instances, sizeof(CubeInstance) * (size_t)g_instanceCapacity);
+    Mem_Free(MEM_SUBSYSTEM_RENDER, g_spheres, sizeof(SphereInstance) * (size_t)g_sphereCapacity);
+    g_instances = NULL;
+    g_instanceCount = 0;
+    g_instanceCapacity = 0;
+    g_spheres = NULL;
+    g_sphereCount = 0;
+    g_sphereCapacity = 0;
+}
+
+void RenderBatch_CountDraw(int mode, Color color, int vertices) {
+    RenderBatch_SetState(mode, color);
+    g_renderStats.vertices += vertices;
+}
+
+void RenderBatch_CountCulling(int visible, int culled) {
+    g_renderStats.visible += visible;
+    g_renderStats.culled += culled;
+}
+
+void RenderBatch_ResetStats(void) {
+    g_renderStats.drawCalls = 0;
+    g_renderStats.stateChanges = 0;
+    g_renderStats.vertices = 0;
+    g_renderStats.cubes = 0;
+    for (int lod = 0; lod < RENDER_SPHERE_LOD_COUNT; lod++) {
+        g_renderStats.sphereLods[lod] = 0;
+        g_renderStats.sphereTriangles[lod] = 0;
+    }
+    g_renderStats.visible = 0;
+    g_renderStats.culled = 0;
+}
+
+const RenderStats* RenderBatch_GetStats(void) {
+    return &g_renderStats;
+}
@@ -0,0 +1,126 @@
+#include "render_queue.h"
+#include "mem.h"
+#include <string.h>
+
+#define RENDER_QUEUE_RADIX_BITS 8
+#define RENDER_QUEUE_RADIX_SIZE (1 << RENDER_QUEUE_RADIX_BITS)
+
+static RenderCommand* g_commands = NULL;
+static RenderCommand* g_sortBuffer = NULL;     // Radix sort ping-pong target
+static int g_commandCount = 0;
+static int g_commandCapacity = 0;
+static bool g_sortEnabled = true;
+
+uint64_t RenderQueue_MakeKey(RenderPass pass, RenderableType type, Color color, float depth) {
+    if (depth < 0.0f) depth = 0.0f;
+    if (depth > RENDER_QUEUE_DEPTH_RANGE) depth = RENDER_QUEUE_DEPTH_RANGE;
+    uint64_t depthBits = (uint64_t)(depth * ((float)0xFFFFFF / RENDER_QUEUE_DEPTH_RANGE));
+    uint64_t colorBits = ((uint64_t)color.r << 24) | ((uint64_t)color.g << 16) | ((uint64_t)color.b << 8) | color.a;
+
+    return ((uint64_t)pass << 62) | (((uint64_t)type & 0x3F) << 56) | (colorBits << 24) | depthBits;
+}
+
+void RenderQueue_Begin(void) {
+    g_commandCount = 0;
+}
+
+static bool RenderQueue_Grow(void) {
+    int capacity = g_commandCapacity > 0 ? g_commandCapacity * 2 : 256;
+    size_t oldBytes = sizeof(RenderCommand) * (size_t)g_commandCapacity;
+    size_t newBytes = sizeof(RenderCommand) * (size_t)capacity;
+
+    RenderCommand* commands = (RenderCommand*)Mem_Realloc(MEM_SUBSYSTEM_RENDER, g_commands, oldBytes, newBytes);
+    if (!commands) {
+        return false;
+    }
+    g_commands = commands;
+
+    // The sort buffer holds nothing between frames, so it need not be copied
+    Mem_Free(MEM_SUBSYSTEM_RENDER, g_sortBuffer, oldBytes);
+    g_sortBuffer = (RenderCommand*)Mem_Alloc(MEM_SUBSYSTEM_RENDER, newBytes);
+    g_commandCapacity = capacity;
+    return true;
+}
+
+bool RenderQueue_Push(uint64_t key, const Matrix* world, const RenderableComponent* renderable) {
+    if (g_commandCount == g_commandCapacity && !RenderQueue_Grow()) {
+        return false;
+    }
+
+    RenderCommand* command = &g_commands[g_commandCount++];
+    command->key = key;
+    command->world = world;
+    command->renderable = renderable;
+    return true;
+}
+
+// LSD radix sort, one byte per pass. All byte histograms are gathered in a
+// single read, and bytes every key shares (pass and type in most frames,
+// depth without a frustum) skip their scatter pass entirely.
+static void RenderQueue_RadixSort(void) {
+    static int counts[8][RENDER_QUEUE_RADIX_SIZE];
+    RenderCommand* src = g_commands;
+    RenderCommand* dst = g_sortBuffer;
+
+    memset(counts, 0, sizeof(counts));
+    for (int i = 0; i < g_commandCount; i++) {
+        uint64_t key = g_commands[i].key;
+        for (int digit = 0; digit < 8; digit++) {
+            counts[digit][(key >> (digit * RENDER_QUEUE_RADIX_BITS)) & (RENDER_QUEUE_RADIX_SIZE - 1)]++;
+        }
+    }
+
+    for (int digit = 0; digit < 8; digit++) {
+        int shift = digit * RENDER_QUEUE_RADIX_BITS;
+        int* digitCounts = counts[digit];
+        if (digitCounts[(src[0].key >> shift) & (RENDER_QUEUE_RADIX_SIZE - 1)] == g_commandCount) {
+            continue;
+        }
+
+        int offset = 0;
+        for (int b = 0; b < RENDER_QUEUE_RADIX_SIZE; b++) {
+            int count = digitCounts[b];
+            digitCounts[b] = offset;
+            offset += count;
+        }
+        for (int i = 0; i < g_commandCount; i++) {
+            dst[digitCounts[(src[i].key >> shift) & (RENDER_QUEUE_RADIX_SIZE - 1)]++] = src[i];
+        }
+
+        RenderCommand* swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != g_commands) {
+        memcpy(g_commands, src, sizeof(RenderCommand) * (size_t)g_commandCount);
+    }
+}
+
+void RenderQueue_Sort(void) {
+    if (!g_sortEnabled || g_commandCount < 2 || !g_sortBuffer) {
+        return;
+    }
+    RenderQueue_RadixSort();
+}
+
+int RenderQueue_GetCount(void) {
+    return g_commandCount;
+}
+
+const RenderCommand* RenderQueue_GetCommands(void) {
+    return g_commands;
+}
+
+void RenderQueue_Shutdown(void) {
+    Mem_Free(MEM_SUBSYSTEM_RENDER, g_commands, sizeof(RenderCommand) * (size_t)g_commandCapacity);
+    Mem_Free(MEM_SUBSYSTEM_RENDER, g_sortBuffer, sizeof(RenderCommand) * (size_t)g_commandCapacity);
+    g_commands = NULL;
+    g_sortBuffer = NULL;
+    g_commandCount = 0;
+    g_commandCapacity = 0;
+}
+
+void RenderQueue_SetSortEnabled(bool enabled) {
+    g_sortEnabled = enabled;
+}
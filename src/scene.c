@@ -1,10 +1,12 @@
 #include "scene.h"
+#include "scene_format.h"
+#include "scene_journal.h"
+#include "mem.h"
 #include <pspdisplay.h>
 #include <pspiofilemgr.h>
 #include <pspkernel.h>
 #include <psputility.h>
 #include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -14,8 +16,16 @@
 #define SAVE_TITLE "PSP-ECS Demo"
 #define SAVE_DETAIL "ECS scene state"
 #define LOG_FILE_NAME "psp-ecs-log.txt"
+#define AUTOSAVE_FILE_NAME "AUTOSAVE.JNL"
+#define AUTOSAVE_TEMP_NAME "AUTOSAVE.TMP"
 #define SAVE_SLOT_COUNT 10
 
+// LZ-compress the scene before it goes to the memory stick. Loading handles
+// compressed and uncompressed saves either way.
+#ifndef SCENE_SAVE_COMPRESSION
+#define SCENE_SAVE_COMPRESSION 1
+#endif
+
 static char g_saveSlotList[SAVE_SLOT_COUNT + 1][20] = {
     "DATA00",
     "DATA01",
@@ -59,6 +69,14 @@ static void Scene_BuildLogPath(char* outPath, size_t outSize) {
     snprintf(outPath, outSize, "%s/PSP-ECS/%s", root, LOG_FILE_NAME);
 }
 
+// The autosave journal sits next to the log, outside the savedata dialogs,
+// so deltas can be appended to it
+static void Scene_BuildAutosavePath(char* outPath, size_t outSize, const char* name) {
+    char root[64];
+    Scene_BuildSaveRoot(root, sizeof(root));
+    snprintf(outPath, outSize, "%s/PSP-ECS/%s", root, name);
+}
+
 static void Scene_EnsureLogDir(void) {
     char root[64];
     Scene_BuildSaveRoot(root, sizeof(root));
@@ -104,19 +122,6 @@ static void Scene_Log(const char* message) {
     sceIoClose(fd);
 }
 
-typedef struct {
-    unsigned int componentMask;
-    TransformComponent transform;
-    RenderableComponent renderable;
-    CameraComponent camera;
-    InputComponent input;
-} SceneEntitySave;
-
-typedef struct {
-    int activeCount;
-    SceneEntitySave entities[MAX_ENTITIES];
-} SceneSaveData;
-
 static void Scene_InitSavedataParams(SceUtilitySavedataParam* params) {
     memset(params, 0, sizeof(*params));
     params->base.size = sizeof(*params);
@@ -174,8 +179,11 @@ static bool Scene_RunSavedata(SceUtilitySavedataParam* params) {
     return true;
 }
 
+static SceneJournal g_journal;
+
 void Scene_Init(ECSWorld* world) {
     ECS_Init(world);
+    SceneJournal_Init(&g_journal, SCENE_SAVE_COMPRESSION != 0);
 }
 
 void Scene_CreateTestScene(ECSWorld* world) {
@@ -227,12 +235,34 @@ void Scene_CreateTestScene(ECSWorld* world) {
         groundRenderable->color = (Color){50, 50, 50, 255};
         groundRenderable->size = (Vector3){50.0f, 1.0f, 50.0f};
     }
+
+    // The ground never moves: cull it through the static BVH
+    ECS_AddComponent(world, groundEntity, COMPONENT_STATIC);
+
+    // A row of spheres running away from the camera, so each sphere
+    // level of detail is on screen at once
+    for (int i = 0; i < 6; i++) {
+        EntityID sphereEntity = ECS_CreateEntity(world);
+        TransformComponent* sphereTransform = (TransformComponent*)ECS_AddComponent(world, sphereEntity, COMPONENT_TRANSFORM);
+        RenderableComponent* sphereRenderable = (RenderableComponent*)ECS_AddComponent(world, sphereEntity, COMPONENT_RENDERABLE);
+
+        if (sphereTransform) {
+            sphereTransform->position = (Vector3){-4.0f, 1.0f, 4.0f - 4.0f * (float)i};
+        }
+
+        if (sphereRenderable) {
+            sphereRenderable->type = RENDERABLE_SPHERE;
+            sphereRenderable->color = SKYBLUE;
+            sphereRenderable->size = (Vector3){2.0f, 2.0f, 2.0f};
+        }
+    }
 }
 
 void Scene_ResetToDefault(ECSWorld* world) {
     if (!world) return;
+    int capacity = ECS_GetCapacity(world);
     ECS_Cleanup(world);
-    ECS_Init(world);
+    ECS_InitWithCapacity(world, capacity);
     Scene_CreateTestScene(world);
 }
 
@@ -246,36 +276,30 @@ bool Scene_Save(ECSWorld* world) {
 
     Scene_Log("Scene_Save: start");
 
-    SceneSaveData* saveData = (SceneSaveData*)malloc(sizeof(SceneSaveData));
+    // Compact chunked encoding; only the bytes actually used are written
+    size_t bufferSize = SceneFormat_MaxEncodedSize(world->entityCount);
+    void* saveData = Mem_ScratchAlloc(MEM_SUBSYSTEM_SCENE, bufferSize);
     if (!saveData) return false;
-    memset(saveData, 0, sizeof(SceneSaveData));
-
-    for (int i = 0; i < MAX_ENTITIES; i++) {
-        if (!world->entities[i].active) continue;
-
-        SceneEntitySave* entry = &saveData->entities[saveData->activeCount++];
-        entry->componentMask = world->entities[i].componentMask;
-
-        if (entry->componentMask & (1 << COMPONENT_TRANSFORM)) {
-            TransformComponent* transform = (TransformComponent*)ECS_GetComponent(world, i, COMPONENT_TRANSFORM);
-            if (transform) entry->transform = *transform;
-        }
-
-        if (entry->componentMask & (1 << COMPONENT_RENDERABLE)) {
-            RenderableComponent* renderable = (RenderableComponent*)ECS_GetComponent(world, i, COMPONENT_RENDERABLE);
-            if (renderable) entry->renderable = *renderable;
-        }
-
-        if (entry->componentMask & (1 << COMPONENT_CAMERA)) {
-            CameraComponent* camera = (CameraComponent*)ECS_GetComponent(world, i, COMPONENT_CAMERA);
-            if (camera) entry->camera = *camera;
-        }
+    size_t saveSize = SceneFormat_Encode(world, saveData, bufferSize);
+    if (saveSize == 0) {
+        Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, saveData, bufferSize);
+        return false;
+    }
 
-        if (entry->componentMask & (1 << COMPONENT_INPUT)) {
-            InputComponent* input = (InputComponent*)ECS_GetComponent(world, i, COMPONENT_INPUT);
-            if (input) entry->input = *input;
+    // Fewer bytes to write; kept uncompressed when packing does not shrink it
+    void* writeData = saveData;
+    size_t writeSize = saveSize;
+#if SCENE_SAVE_COMPRESSION
+    size_t packedBufferSize = SceneFormat_MaxPackedSize(saveSize);
+    void* packedData = Mem_ScratchAlloc(MEM_SUBSYSTEM_SCENE, packedBufferSize);
+    if (packedData) {
+        size_t packedSize = SceneFormat_Pack(saveData, saveSize, packedData, packedBufferSize);
+        if (packedSize > 0) {
+            writeData = packedData;
+            writeSize = packedSize;
         }
     }
+#endif
 
     SceUtilitySavedataParam params;
     Scene_InitSavedataParams(&params);
@@ -290,13 +314,16 @@ bool Scene_Save(ECSWorld* world) {
     strncpy(params.sfoParam.title, SAVE_TITLE, sizeof(params.sfoParam.title) - 1);
     strncpy(params.sfoParam.savedataTitle, SAVE_TITLE, sizeof(params.sfoParam.savedataTitle) - 1);
     strncpy(params.sfoParam.detail, SAVE_DETAIL, sizeof(params.sfoParam.detail) - 1);
-    params.dataBuf = (void*)saveData;
-    params.dataSize = sizeof(SceneSaveData);
-    params.dataBufSize = sizeof(SceneSaveData);
+    params.dataBuf = writeData;
+    params.dataSize = writeSize;
+    params.dataBufSize = writeSize;
 
     bool result = Scene_RunSavedata(&params);
     Scene_Log(result ? "Scene_Save: success" : "Scene_Save: failed");
-    free(saveData);
+#if SCENE_SAVE_COMPRESSION
+    Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, packedData, packedBufferSize);
+#endif
+    Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, saveData, bufferSize);
     return result;
 }
 
@@ -312,9 +339,17 @@ bool Scene_Load(ECSWorld* world) {
         return false;
     }
 
-    SceneSaveData* saveData = (SceneSaveData*)malloc(sizeof(SceneSaveData));
+    // A save can never hold more entities than the world can take back.
+    // Saves from before the compact format are fixed-record dumps, which
+    // need the larger buffer.
+    int capacity = ECS_GetCapacity(world);
+    size_t loadSize = SceneFormat_MaxEncodedSize(capacity);
+    if (SceneFormat_LegacySize(capacity) > loadSize) {
+        loadSize = SceneFormat_LegacySize(capacity);
+    }
+    void* saveData = Mem_ScratchAlloc(MEM_SUBSYSTEM_SCENE, loadSize);
     if (!saveData) return false;
-    memset(saveData, 0, sizeof(SceneSaveData));
+    memset(saveData, 0, loadSize);
 
     SceUtilitySavedataParam params;
     Scene_InitSavedataParams(&params);
@@ -324,50 +359,139 @@ bool Scene_Load(ECSWorld* world) {
     strncpy(params.fileName, SAVE_FILE_NAME, sizeof(params.fileName) - 1);
     params.focus = PSP_UTILITY_SAVEDATA_FOCUS_LATEST;
     params.saveNameList = populatedList;
-    params.dataBuf = (void*)saveData;
-    params.dataSize = sizeof(SceneSaveData);
-    params.dataBufSize = sizeof(SceneSaveData);
+    params.dataBuf = saveData;
+    params.dataSize = loadSize;
+    params.dataBufSize = loadSize;
 
     bool result = Scene_RunSavedata(&params);
     if (!result) {
         Scene_Log("Scene_Load: savedata failed");
-        free(saveData);
+        Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, saveData, loadSize);
         return false;
     }
 
-    ECS_Cleanup(world);
-    ECS_Init(world);
-
-    for (int i = 0; i < saveData->activeCount; i++) {
-        SceneEntitySave* entry = &saveData->entities[i];
-        EntityID id = ECS_CreateEntity(world);
-        if (id < 0) {
-            free(saveData);
+    // Compressed saves expand into a second buffer of at most the same size
+    size_t rawSize = SceneFormat_PackedRawSize(saveData, loadSize);
+    if (rawSize > 0) {
+        void* rawData = rawSize <= loadSize ? Mem_ScratchAlloc(MEM_SUBSYSTEM_SCENE, rawSize) : NULL;
+        if (!rawData || SceneFormat_Unpack(saveData, loadSize, rawData, rawSize) != rawSize) {
+            Scene_Log("Scene_Load: invalid compressed save");
+            if (rawData) Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, rawData, rawSize);
+            Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, saveData, loadSize);
             return false;
         }
+        Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, saveData, loadSize);
+        saveData = rawData;
+        loadSize = rawSize;
+    }
 
-        if (entry->componentMask & (1 << COMPONENT_TRANSFORM)) {
-            TransformComponent* transform = (TransformComponent*)ECS_AddComponent(world, id, COMPONENT_TRANSFORM);
-            if (transform) *transform = entry->transform;
-        }
+    bool compact = SceneFormat_IsCompact(saveData, loadSize);
+    if (compact) {
+        result = SceneFormat_Decode(world, saveData, loadSize);
+    } else {
+        result = SceneFormat_DecodeLegacy(world, saveData, loadSize);
+    }
+    if (!result) {
+        Scene_Log(compact ? "Scene_Load: invalid save" : "Scene_Load: invalid legacy save");
+        Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, saveData, loadSize);
+        return false;
+    }
 
-        if (entry->componentMask & (1 << COMPONENT_RENDERABLE)) {
-            RenderableComponent* renderable = (RenderableComponent*)ECS_AddComponent(world, id, COMPONENT_RENDERABLE);
-            if (renderable) *renderable = entry->renderable;
-        }
+    Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, saveData, loadSize);
+    Scene_Log("Scene_Load: success");
+    return true;
+}
 
-        if (entry->componentMask & (1 << COMPONENT_CAMERA)) {
-            CameraComponent* camera = (CameraComponent*)ECS_AddComponent(world, id, COMPONENT_CAMERA);
-            if (camera) *camera = entry->camera;
-        }
+static bool Scene_WriteFile(const char* path, const void* data, size_t size, int flags) {
+    SceUID fd = sceIoOpen(path, PSP_O_WRONLY | PSP_O_CREAT | flags, 0777);
+    if (fd < 0) return false;
+    int written = sceIoWrite(fd, data, size);
+    sceIoClose(fd);
+    return written == (int)size;
+}
+
+bool Scene_Autosave(ECSWorld* world) {
+    if (!world) return false;
+    if (!SceneJournal_HasChanges(&g_journal, world)) return true;
 
-        if (entry->componentMask & (1 << COMPONENT_INPUT)) {
-            InputComponent* input = (InputComponent*)ECS_AddComponent(world, id, COMPONENT_INPUT);
-            if (input) *input = entry->input;
+    SceneJournalRecord record;
+    if (!SceneJournal_BeginRecord(&g_journal, world, &record)) {
+        Scene_Log("Scene_Autosave: out of memory");
+        return false;
+    }
+
+    Scene_EnsureLogDir();
+    char path[128];
+    Scene_BuildAutosavePath(path, sizeof(path), AUTOSAVE_FILE_NAME);
+    bool stored;
+    if (record.snapshot) {
+        // Written aside first, so a failed write leaves the old journal whole
+        char tempPath[128];
+        Scene_BuildAutosavePath(tempPath, sizeof(tempPath), AUTOSAVE_TEMP_NAME);
+        stored = Scene_WriteFile(tempPath, record.data, record.size, PSP_O_TRUNC);
+        if (stored) {
+            sceIoRemove(path);
+            stored = sceIoRename(tempPath, path) >= 0;
         }
+    } else {
+        stored = Scene_WriteFile(path, record.data, record.size, PSP_O_APPEND);
     }
 
-    free(saveData);
-    Scene_Log("Scene_Load: success");
-    return true;
+    if (!stored) {
+        Scene_Log(record.snapshot ? "Scene_Autosave: snapshot failed" : "Scene_Autosave: append failed");
+    }
+    SceneJournal_EndRecord(&g_journal, world, &record, stored);
+    return stored;
+}
+
+// The journal, or the snapshot a compaction was about to rename over it
+static bool Scene_FindAutosave(char* path, size_t pathSize, SceIoStat* stat) {
+    Scene_BuildAutosavePath(path, pathSize, AUTOSAVE_FILE_NAME);
+    if (sceIoGetstat(path, stat) >= 0) return true;
+    Scene_BuildAutosavePath(path, pathSize, AUTOSAVE_TEMP_NAME);
+    return sceIoGetstat(path, stat) >= 0;
+}
+
+bool Scene_HasAutosave(void) {
+    char path[128];
+    SceIoStat stat;
+    return Scene_FindAutosave(path, sizeof(path), &stat);
+}
+
+bool Scene_LoadAutosave(ECSWorld* world) {
+    if (!world) return false;
+
+    Scene_Log("Scene_LoadAutosave: start");
+
+    char path[128];
+    SceIoStat stat;
+    if (!Scene_FindAutosave(path, sizeof(path), &stat)) {
+        Scene_Log("Scene_LoadAutosave: no autosave found");
+        return false;
+    }
+
+    // Anything past what this world could have written is not ours
+    size_t size = (size_t)stat.st_size;
+    if (stat.st_size <= 0 || size > SceneJournal_MaxSize(ECS_GetCapacity(world))) {
+        Scene_Log("Scene_LoadAutosave: invalid size");
+        return false;
+    }
+    void* data = Mem_ScratchAlloc(MEM_SUBSYSTEM_SCENE, size);
+    if (!data) return false;
+
+    SceUID fd = sceIoOpen(path, PSP_O_RDONLY, 0);
+    int bytesRead = fd >= 0 ? sceIoRead(fd, data, size) : -1;
+    if (fd >= 0) sceIoClose(fd);
+
+    // A record cut short at the end is dropped; everything before it loads
+    int records = bytesRead > 0 ? SceneJournal_Replay(world, data, (size_t)bytesRead, NULL) : 0;
+    Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, data, size);
+
+    // Slots differ in the rebuilt world, so the next autosave starts a new journal
+    SceneJournal_Reset(&g_journal);
+
+    char logLine[128];
+    snprintf(logLine, sizeof(logLine), "Scene_LoadAutosave: %d records", records);
+    Scene_Log(logLine);
+    return records > 0;
 }
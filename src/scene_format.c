@@ -0,0 +1,942 @@
+#include "scene_format.h"
+#include "hierarchy.h"
+#include "lz.h"
+#include "mem.h"
+#include <string.h>
+
+#define SCENE_NO_PARENT 0xFFFFFFFFu
+
+// Packed record sizes written by this version
+#define SCENE_RECORD_TRANSFORM 36       // position, rotation, scale
+#define SCENE_RECORD_RENDERABLE 17      // type, RGBA, size
+#define SCENE_RECORD_CAMERA 53          // position, target, up, fovy, projection, move/look speed, pitch
+#define SCENE_RECORD_INPUT 1
+#define SCENE_RECORD_STATIC 0
+#define SCENE_RECORD_HIERARCHY 4        // Parent's save index, SCENE_NO_PARENT for roots
+#define SCENE_RECORD_SLOT 4             // Entity slot in the saving world
+
+// Per-entity part of a delta record: slot, flags, componentMask, changedMask
+#define SCENE_DELTA_ENTITY_SIZE 9
+// Bits of the u16 type masks in a delta
+#define SCENE_DELTA_TYPE_BITS 16
+
+// Component types saved, in chunk order
+static const ComponentType g_chunkTypes[] = {
+    COMPONENT_TRANSFORM, COMPONENT_RENDERABLE, COMPONENT_CAMERA, COMPONENT_INPUT, COMPONENT_STATIC, COMPONENT_HIERARCHY
+};
+#define SCENE_CHUNK_TYPE_COUNT ((int)(sizeof(g_chunkTypes) / sizeof(g_chunkTypes[0])))
+
+static size_t SceneFormat_RecordSize(ComponentType type) {
+    switch (type) {
+        case COMPONENT_TRANSFORM: return SCENE_RECORD_TRANSFORM;
+        case COMPONENT_RENDERABLE: return SCENE_RECORD_RENDERABLE;
+        case COMPONENT_CAMERA: return SCENE_RECORD_CAMERA;
+        case COMPONENT_INPUT: return SCENE_RECORD_INPUT;
+        case COMPONENT_STATIC: return SCENE_RECORD_STATIC;
+        case COMPONENT_HIERARCHY: return SCENE_RECORD_HIERARCHY;
+        default: return 0;
+    }
+}
+
+// A renderable record starts with its RenderableType as a byte; a value
+// past the last type would reach the renderer's switches unhandled
+static bool SceneFormat_IsRenderableType(unsigned int type) {
+    return type <= RENDERABLE_GRID;
+}
+
+// False for record contents the loader cannot take as they are
+static bool SceneFormat_RecordValid(const unsigned char* record, ComponentType type) {
+    return type != COMPONENT_RENDERABLE || SceneFormat_IsRenderableType(record[0]);
+}
+
+// Tags this version reads; anything else is skipped
+static bool SceneFormat_IsKnownType(unsigned int tag) {
+    for (int i = 0; i < SCENE_CHUNK_TYPE_COUNT; i++) {
+        if ((unsigned int)g_chunkTypes[i] == tag) return true;
+    }
+    return false;
+}
+
+static unsigned int SceneFormat_SavedMask(void) {
+    unsigned int mask = 0;
+    for (int i = 0; i < SCENE_CHUNK_TYPE_COUNT; i++) mask |= COMPONENT_BIT(g_chunkTypes[i]);
+    return mask;
+}
+
+static size_t SceneFormat_BitsetSize(int entityCount) {
+    return ((size_t)entityCount + 7) / 8;
+}
+
+// Byte cursor over a caller's buffer. Writes past the end set `overflow`
+// instead of storing; reads past the end return zeros and set it too.
+typedef struct {
+    unsigned char* data;
+    size_t size;
+    size_t offset;
+    bool overflow;
+} SceneCursor;
+
+static unsigned char* SceneCursor_Take(SceneCursor* cursor, size_t size) {
+    if (cursor->overflow || size > cursor->size - cursor->offset) {
+        cursor->overflow = true;
+        return NULL;
+    }
+    unsigned char* p = cursor->data + cursor->offset;
+    cursor->offset += size;
+    return p;
+}
+
+static void SceneCursor_PutU8(SceneCursor* cursor, unsigned int value) {
+    unsigned char* p = SceneCursor_Take(cursor, 1);
+    if (p) p[0] = (unsigned char)value;
+}
+
+static void SceneCursor_PutU16(SceneCursor* cursor, unsigned int value) {
+    unsigned char* p = SceneCursor_Take(cursor, 2);
+    if (p) {
+        p[0] = (unsigned char)value;
+        p[1] = (unsigned char)(value >> 8);
+    }
+}
+
+// Little-endian targets (the PSP included) copy words as they are
+static void SceneCursor_PutU32(SceneCursor* cursor, unsigned int value) {
+    unsigned char* p = SceneCursor_Take(cursor, 4);
+    if (p) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        memcpy(p, &value, 4);
+#else
+        p[0] = (unsigned char)value;
+        p[1] = (unsigned char)(value >> 8);
+        p[2] = (unsigned char)(value >> 16);
+        p[3] = (unsigned char)(value >> 24);
+#endif
+    }
+}
+
+static void SceneCursor_PutFloat(SceneCursor* cursor, float value) {
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    SceneCursor_PutU32(cursor, bits);
+}
+
+static void SceneCursor_PutVector3(SceneCursor* cursor, Vector3 v) {
+    SceneCursor_PutFloat(cursor, v.x);
+    SceneCursor_PutFloat(cursor, v.y);
+    SceneCursor_PutFloat(cursor, v.z);
+}
+
+static unsigned int SceneCursor_GetU8(SceneCursor* cursor) {
+    const unsigned char* p = SceneCursor_Take(cursor, 1);
+    return p ? p[0] : 0;
+}
+
+static unsigned int SceneCursor_GetU16(SceneCursor* cursor) {
+    const unsigned char* p = SceneCursor_Take(cursor, 2);
+    return p ? (unsigned int)p[0] | ((unsigned int)p[1] << 8) : 0;
+}
+
+static unsigned int SceneCursor_GetU32(SceneCursor* cursor) {
+    const unsigned char* p = SceneCursor_Take(cursor, 4);
+    if (!p) return 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    unsigned int value;
+    memcpy(&value, p, 4);
+    return value;
+#else
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+#endif
+}
+
+static float SceneCursor_GetFloat(SceneCursor* cursor) {
+    unsigned int bits = SceneCursor_GetU32(cursor);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static Vector3 SceneCursor_GetVector3(SceneCursor* cursor) {
+    Vector3 v;
+    v.x = SceneCursor_GetFloat(cursor);
+    v.y = SceneCursor_GetFloat(cursor);
+    v.z = SceneCursor_GetFloat(cursor);
+    return v;
+}
+
+size_t SceneFormat_MaxEncodedSize(int entityCount) {
+    // Every component chunk, plus the slot chunk of a snapshot
+    size_t size = SCENE_FORMAT_HEADER_SIZE + SCENE_FORMAT_CHUNK_HEADER_SIZE + SceneFormat_BitsetSize(entityCount) +
+                  SCENE_RECORD_SLOT * (size_t)entityCount;
+    for (int i = 0; i < SCENE_CHUNK_TYPE_COUNT; i++) {
+        size += SCENE_FORMAT_CHUNK_HEADER_SIZE + SceneFormat_BitsetSize(entityCount) +
+                SceneFormat_RecordSize(g_chunkTypes[i]) * (size_t)entityCount;
+    }
+    return size;
+}
+
+// Hierarchy parents are written as save indices, or as slots when saveIndex is NULL (deltas)
+static void SceneFormat_WriteRecord(SceneCursor* cursor, ECSWorld* world, EntityID id, ComponentType type,
+                                    const int* saveIndex) {
+    void* component = ECS_GetComponent(world, id, type);
+    switch (type) {
+        case COMPONENT_TRANSFORM: {
+            const TransformComponent* transform = (const TransformComponent*)component;
+            SceneCursor_PutVector3(cursor, transform->position);
+            SceneCursor_PutVector3(cursor, transform->rotation);
+            SceneCursor_PutVector3(cursor, transform->scale);
+            break;
+        }
+        case COMPONENT_RENDERABLE: {
+            const RenderableComponent* renderable = (const RenderableComponent*)component;
+            SceneCursor_PutU8(cursor, (unsigned int)renderable->type);
+            SceneCursor_PutU8(cursor, renderable->color.r);
+            SceneCursor_PutU8(cursor, renderable->color.g);
+            SceneCursor_PutU8(cursor, renderable->color.b);
+            SceneCursor_PutU8(cursor, renderable->color.a);
+            SceneCursor_PutVector3(cursor, renderable->size);
+            break;
+        }
+        case COMPONENT_CAMERA: {
+            const CameraComponent* camera = (const CameraComponent*)component;
+            SceneCursor_PutVector3(cursor, camera->camera.position);
+            SceneCursor_PutVector3(cursor, camera->camera.target);
+            SceneCursor_PutVector3(cursor, camera->camera.up);
+            SceneCursor_PutFloat(cursor, camera->camera.fovy);
+            SceneCursor_PutU8(cursor, (unsigned int)camera->camera.projection);
+            SceneCursor_PutFloat(cursor, camera->moveSpeed);
+            SceneCursor_PutFloat(cursor, camera->lookSpeed);
+            SceneCursor_PutFloat(cursor, camera->pitch);
+            break;
+        }
+        case COMPONENT_INPUT:
+            SceneCursor_PutU8(cursor, ((const InputComponent*)component)->active ? 1 : 0);
+            break;
+        case COMPONENT_HIERARCHY: {
+            EntityID parent = ((const HierarchyComponent*)component)->parent;
+            int slot = ECS_ENTITY_INDEX(parent);
+            bool linked = parent != ECS_INVALID_ENTITY && ECS_IsEntityValid(world, parent);
+            SceneCursor_PutU32(cursor, linked ? (unsigned int)(saveIndex ? saveIndex[slot] : slot) : SCENE_NO_PARENT);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static size_t SceneFormat_EncodeWorld(ECSWorld* world, void* buffer, size_t bufferSize, bool slots) {
+    int entityCount = world->entityCount;
+    int capacity = ECS_GetCapacity(world);
+
+    // Save order, and each entity slot's position in it for hierarchy links
+    size_t idsSize = sizeof(EntityID) * (size_t)(entityCount > 0 ? entityCount : 1);
+    size_t indexSize = sizeof(int) * (size_t)(capacity > 0 ? capacity : 1);
+    EntityID* ids = (EntityID*)Mem_ScratchAlloc(MEM_SUBSYSTEM_SCENE, idsSize);
+    int* saveIndex = (int*)Mem_ScratchAlloc(MEM_SUBSYSTEM_SCENE, indexSize);
+    if (!ids || !saveIndex) {
+        Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, saveIndex, indexSize);
+        Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, ids, idsSize);
+        return 0;
+    }
+
+    int count = 0;
+    int typeCounts[SCENE_CHUNK_TYPE_COUNT] = {0};
+    for (EntityID id = ECS_FirstEntity(world); id != ECS_INVALID_ENTITY && count < entityCount;
+         id = ECS_NextEntity(world, id)) {
+        unsigned int mask = ECS_GetComponentMask(world, id);
+        for (int t = 0; t < SCENE_CHUNK_TYPE_COUNT; t++) {
+            if (mask & COMPONENT_BIT(g_chunkTypes[t])) typeCounts[t]++;
+        }
+        saveIndex[ECS_ENTITY_INDEX(id)] = count;
+        ids[count++] = id;
+    }
+
+    int chunkCount = slots ? 1 : 0;
+    for (int t = 0; t < SCENE_CHUNK_TYPE_COUNT; t++) {
+        if (typeCounts[t] > 0) chunkCount++;
+    }
+
+    SceneCursor cursor = {(unsigned char*)buffer, bufferSize, 0, false};
+    SceneCursor_PutU32(&cursor, SCENE_FORMAT_MAGIC);
+    SceneCursor_PutU16(&cursor, SCENE_FORMAT_VERSION);
+    SceneCursor_PutU16(&cursor, SCENE_FORMAT_VERSION);     // minReader
+    SceneCursor_PutU32(&cursor, SCENE_FORMAT_HEADER_SIZE);
+    size_t totalSizeOffset = cursor.offset;
+    SceneCursor_PutU32(&cursor, 0);                         // totalSize, patched below
+    SceneCursor_PutU32(&cursor, (unsigned int)count);
+    SceneCursor_PutU32(&cursor, (unsigned int)chunkCount);
+
+    size_t bitsetSize = SceneFormat_BitsetSize(count);
+    for (int t = 0; t < SCENE_CHUNK_TYPE_COUNT && !cursor.overflow; t++) {
+        if (typeCounts[t] == 0) continue;
+        ComponentType type = g_chunkTypes[t];
+        size_t recordSize = SceneFormat_RecordSize(type);
+        unsigned int bit = COMPONENT_BIT(type);
+
+        SceneCursor_PutU16(&cursor, (unsigned int)type);
+        SceneCursor_PutU16(&cursor, (unsigned int)recordSize);
+        SceneCursor_PutU32(&cursor, (unsigned int)typeCounts[t]);
+        SceneCursor_PutU32(&cursor, (unsigned int)(bitsetSize + recordSize * (size_t)typeCounts[t]));
+
+        unsigned char* bitset = SceneCursor_Take(&cursor, bitsetSize);
+        if (!bitset) break;
+        memset(bitset, 0, bitsetSize);
+        for (int i = 0; i < count; i++) {
+            if (ECS_GetComponentMask(world, ids[i]) & bit) bitset[i >> 3] |= (unsigned char)(1u << (i & 7));
+        }
+        for (int i = 0; i < count; i++) {
+            if (bitset[i >> 3] & (1u << (i & 7))) SceneFormat_WriteRecord(&cursor, world, ids[i], type, saveIndex);
+        }
+    }
+
+    // Every entity's slot, in save order
+    if (slots && !cursor.overflow) {
+        SceneCursor_PutU16(&cursor, SCENE_FORMAT_SLOT_TAG);
+        SceneCursor_PutU16(&cursor, SCENE_RECORD_SLOT);
+        SceneCursor_PutU32(&cursor, (unsigned int)count);
+        SceneCursor_PutU32(&cursor, (unsigned int)(bitsetSize + SCENE_RECORD_SLOT * (size_t)count));
+        unsigned char* bitset = SceneCursor_Take(&cursor, bitsetSize);
+        if (bitset) {
+            memset(bitset, 0, bitsetSize);
+            for (int i = 0; i < count; i++) bitset[i >> 3] |= (unsigned char)(1u << (i & 7));
+            for (int i = 0; i < count; i++) SceneCursor_PutU32(&cursor, (unsigned int)ECS_ENTITY_INDEX(ids[i]));
+        }
+    }
+
+    Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, saveIndex, indexSize);
+    Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, ids, idsSize);
+    if (cursor.overflow) {
+        return 0;
+    }
+
+    size_t totalSize = cursor.offset;
+    cursor.offset = totalSizeOffset;
+    SceneCursor_PutU32(&cursor, (unsigned int)totalSize);
+    return totalSize;
+}
+
+size_t SceneFormat_Encode(ECSWorld* world, void* buffer, size_t bufferSize) {
+    return SceneFormat_EncodeWorld(world, buffer, bufferSize, false);
+}
+
+size_t SceneFormat_EncodeSnapshot(ECSWorld* world, void* buffer, size_t bufferSize) {
+    return SceneFormat_EncodeWorld(world, buffer, bufferSize, true);
+}
+
+typedef struct {
+    unsigned int version;
+    unsigned int minReader;
+    unsigned int headerSize;
+    unsigned int totalSize;
+    unsigned int entityCount;
+    unsigned int chunkCount;
+} SceneHeader;
+
+static bool SceneFormat_ReadHeader(const void* data, size_t size, SceneHeader* header) {
+    SceneCursor cursor = {(unsigned char*)data, size, 0, false};
+    if (SceneCursor_GetU32(&cursor) != SCENE_FORMAT_MAGIC) return false;
+    header->version = SceneCursor_GetU16(&cursor);
+    header->minReader = SceneCursor_GetU16(&cursor);
+    header->headerSize = SceneCursor_GetU32(&cursor);
+    header->totalSize = SceneCursor_GetU32(&cursor);
+    header->entityCount = SceneCursor_GetU32(&cursor);
+    header->chunkCount = SceneCursor_GetU32(&cursor);
+    return !cursor.overflow;
+}
+
+bool SceneFormat_IsCompact(const void* data, size_t size) {
+    SceneHeader header;
+    return SceneFormat_ReadHeader(data, size, &header);
+}
+
+static void SceneFormat_ReadRecord(SceneCursor* cursor, ECSWorld* world, EntityID id, ComponentType type,
+                                   const EntityID* ids, unsigned int entityCount) {
+    switch (type) {
+        case COMPONENT_TRANSFORM: {
+            // Adding the component already queued its world matrix
+            TransformComponent* transform = (TransformComponent*)ECS_AddComponent(world, id, type);
+            Vector3 position = SceneCursor_GetVector3(cursor);
+            Vector3 rotation = SceneCursor_GetVector3(cursor);
+            Vector3 scale = SceneCursor_GetVector3(cursor);
+            if (transform) {
+                transform->position = position;
+                transform->rotation = rotation;
+                transform->scale = scale;
+            }
+            break;
+        }
+        case COMPONENT_RENDERABLE: {
+            RenderableComponent* renderable = (RenderableComponent*)ECS_AddComponent(world, id, type);
+            RenderableType renderType = (RenderableType)SceneCursor_GetU8(cursor);
+            Color color;
+            color.r = (unsigned char)SceneCursor_GetU8(cursor);
+            color.g = (unsigned char)SceneCursor_GetU8(cursor);
+            color.b = (unsigned char)SceneCursor_GetU8(cursor);
+            color.a = (unsigned char)SceneCursor_GetU8(cursor);
+            Vector3 size = SceneCursor_GetVector3(cursor);
+            if (renderable) {
+                renderable->type = renderType;
+                renderable->color = color;
+                renderable->size = size;
+            }
+            break;
+        }
+        case COMPONENT_CAMERA: {
+            CameraComponent* camera = (CameraComponent*)ECS_AddComponent(world, id, type);
+            Camera3D saved;
+            saved.position = SceneCursor_GetVector3(cursor);
+            saved.target = SceneCursor_GetVector3(cursor);
+            saved.up = SceneCursor_GetVector3(cursor);
+            saved.fovy = SceneCursor_GetFloat(cursor);
+            saved.projection = (int)SceneCursor_GetU8(cursor);
+            float moveSpeed = SceneCursor_GetFloat(cursor);
+            float lookSpeed = SceneCursor_GetFloat(cursor);
+            float pitch = SceneCursor_GetFloat(cursor);
+            if (camera) {
+                camera->camera = saved;
+                camera->moveSpeed = moveSpeed;
+                camera->lookSpeed = lookSpeed;
+                camera->pitch = pitch;
+            }
+            break;
+        }
+        case COMPONENT_INPUT: {
+            InputComponent* input = (InputComponent*)ECS_AddComponent(world, id, type);
+            bool active = SceneCursor_GetU8(cursor) != 0;
+            if (input) input->active = active;
+            break;
+        }
+        case COMPONENT_STATIC:
+            ECS_AddComponent(world, id, type);
+            break;
+        case COMPONENT_HIERARCHY: {
+            // Parents may come later in save order, so links are made once
+            // every transform exists; see SceneFormat_Decode
+            unsigned int parent = SceneCursor_GetU32(cursor);
+            if (parent != SCENE_NO_PARENT && parent < entityCount) {
+                Hierarchy_SetParent(world, id, ids[parent]);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Walks every chunk without touching the world: sizes must add up, known
+// records must be at least as long as this version writes them and hold
+// values it can load, and the record count must match the bitset
+static bool SceneFormat_Validate(const unsigned char* data, const SceneHeader* header) {
+    SceneCursor cursor = {(unsigned char*)data, header->totalSize, header->headerSize, false};
+    size_t bitsetSize = SceneFormat_BitsetSize((int)header->entityCount);
+
+    for (unsigned int c = 0; c < header->chunkCount; c++) {
+        unsigned int tag = SceneCursor_GetU16(&cursor);
+        unsigned int recordSize = SceneCursor_GetU16(&cursor);
+        unsigned int count = SceneCursor_GetU32(&cursor);
+        unsigned int byteSize = SceneCursor_GetU32(&cursor);
+        const unsigned char* body = SceneCursor_Take(&cursor, byteSize);
+        if (!body) return false;
+        if (!SceneFormat_IsKnownType(tag)) continue;
+
+        if (recordSize < SceneFormat_RecordSize((ComponentType)tag) || count > header->entityCount ||
+            (size_t)byteSize != bitsetSize + (size_t)recordSize * count) {
+            return false;
+        }
+        unsigned int members = 0;
+        for (size_t i = 0; i < bitsetSize; i++) members += (unsigned int)__builtin_popcount(body[i]);
+        unsigned int tailBits = header->entityCount & 7;
+        if (members != count || (tailBits && (body[bitsetSize - 1] >> tailBits))) return false;
+
+        for (unsigned int i = 0; i < count; i++) {
+            if (!SceneFormat_RecordValid(body + bitsetSize + (size_t)recordSize * i, (ComponentType)tag)) return false;
+        }
+    }
+    return !cursor.overflow;
+}
+
+// Applies the chunks of one kind: hierarchy links in the second pass, every
+// other known component in the first
+static void SceneFormat_ApplyChunks(ECSWorld* world, const unsigned char* data, const SceneHeader* header,
+                                    const EntityID* ids, bool links) {
+    SceneCursor cursor = {(unsigned char*)data, header->totalSize, header->headerSize, false};
+    size_t bitsetSize = SceneFormat_BitsetSize((int)header->entityCount);
+
+    for (unsigned int c = 0; c < header->chunkCount; c++) {
+        unsigned int tag = SceneCursor_GetU16(&cursor);
+        unsigned int recordSize = SceneCursor_GetU16(&cursor);
+        SceneCursor_GetU32(&cursor);
+        unsigned int byteSize = SceneCursor_GetU32(&cursor);
+        unsigned char* body = SceneCursor_Take(&cursor, byteSize);
+        if (!SceneFormat_IsKnownType(tag) || (tag == COMPONENT_HIERARCHY) != links) {
+            continue;
+        }
+
+        SceneCursor records = {body, byteSize, bitsetSize, false};
+        for (unsigned int i = 0; i < header->entityCount; i++) {
+            if (!(body[i >> 3] & (1u << (i & 7)))) continue;
+            size_t next = records.offset + recordSize;
+            SceneFormat_ReadRecord(&records, world, ids[i], (ComponentType)tag, ids, header->entityCount);
+            records.offset = next;      // Skip fields appended by newer versions
+        }
+    }
+}
+
+// Records of the first chunk tagged `tag` (past its bitset), NULL if there is none
+static const unsigned char* SceneFormat_FindChunk(const unsigned char* data, const SceneHeader* header,
+                                                  unsigned int tag, unsigned int* recordSize, unsigned int* count) {
+    SceneCursor cursor = {(unsigned char*)data, header->totalSize, header->headerSize, false};
+    for (unsigned int c = 0; c < header->chunkCount; c++) {
+        unsigned int chunkTag = SceneCursor_GetU16(&cursor);
+        *recordSize = SceneCursor_GetU16(&cursor);
+        *count = SceneCursor_GetU32(&cursor);
+        unsigned int byteSize = SceneCursor_GetU32(&cursor);
+        const unsigned char* body = SceneCursor_Take(&cursor, byteSize);
+        if (!body) return NULL;
+        if (chunkTag == tag) return body + SceneFormat_BitsetSize((int)header->entityCount);
+    }
+    return NULL;
+}
+
+// A snapshot's slot chunk must name a slot below slotCount for every entity
+static const unsigned char* SceneFormat_ValidateSlots(const unsigned char* data, const SceneHeader* header,
+                                                      int slotCount, unsigned int* recordSize) {
+    unsigned int count = 0;
+    const unsigned char* records = SceneFormat_FindChunk(data, header, SCENE_FORMAT_SLOT_TAG, recordSize, &count);
+    if (!records || *recordSize < SCENE_RECORD_SLOT || count != header->entityCount) return NULL;
+
+    SceneCursor cursor = {(unsigned char*)records, (size_t)*recordSize * count, 0, false};
+    for (unsigned int i = 0; i < count; i++) {
+        cursor.offset = (size_t)i * *recordSize;
+        if (SceneCursor_GetU32(&cursor) >= (unsigned int)slotCount) return NULL;
+    }
+    return records;
+}
+
+static bool SceneFormat_DecodeWorld(ECSWorld* world, const void* data, size_t size, EntityID* slotMap,
+                                    int slotCount) {
+    SceneHeader header;
+    if (!SceneFormat_ReadHeader(data, size, &header)) return false;
+
+    int capacity = ECS_GetCapacity(world);
+    if (header.minReader > SCENE_FORMAT_VERSION || header.headerSize < SCENE_FORMAT_HEADER_SIZE ||
+        header.totalSize > size || header.headerSize > header.totalSize ||
+        header.entityCount > (unsigned int)capacity) {
+        return false;
+    }
+    if (!SceneFormat_Validate((const unsigned char*)data, &header)) return false;
+
+    unsigned int slotSize = 0;
+    const unsigned char* slots = NULL;
+    if (slotMap) {
+        slots = SceneFormat_ValidateSlots((const unsigned char*)data, &header, slotCount, &slotSize);
+        if (!slots) return false;
+    }
+
+    size_t idsSize = sizeof(EntityID) * (size_t)(header.entityCount > 0 ? header.entityCount : 1);
+    EntityID* ids = (EntityID*)Mem_ScratchAlloc(MEM_SUBSYSTEM_SCENE, idsSize);
+    if (!ids) return false;
+
+    ECS_Cleanup(world);
+    ECS_InitWithCapacity(world, capacity);
+    for (unsigned int i = 0; i < header.entityCount; i++) {
+        ids[i] = ECS_CreateEntity(world);
+    }
+    SceneFormat_ApplyChunks(world, (const unsigned char*)data, &header, ids, false);
+    SceneFormat_ApplyChunks(world, (const unsigned char*)data, &header, ids, true);
+
+    if (slotMap) {
+        for (int i = 0; i < slotCount; i++) slotMap[i] = ECS_INVALID_ENTITY;
+        SceneCursor cursor = {(unsigned char*)slots, (size_t)slotSize * header.entityCount, 0, false};
+        for (unsigned int i = 0; i < header.entityCount; i++) {
+            cursor.offset = (size_t)i * slotSize;
+            slotMap[SceneCursor_GetU32(&cursor)] = ids[i];
+        }
+    }
+
+    Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, ids, idsSize);
+    return true;
+}
+
+bool SceneFormat_Decode(ECSWorld* world, const void* data, size_t size) {
+    return SceneFormat_DecodeWorld(world, data, size, NULL, 0);
+}
+
+bool SceneFormat_DecodeSnapshot(ECSWorld* world, const void* data, size_t size, EntityID* slotMap, int slotCount) {
+    return SceneFormat_DecodeWorld(world, data, size, slotMap, slotCount);
+}
+
+size_t SceneFormat_MaxDeltaSize(int changedCount) {
+    size_t record = SCENE_DELTA_ENTITY_SIZE;
+    for (int i = 0; i < SCENE_CHUNK_TYPE_COUNT; i++) record += SceneFormat_RecordSize(g_chunkTypes[i]);
+    return SCENE_FORMAT_DELTA_HEADER_SIZE + 2 * SCENE_CHUNK_TYPE_COUNT + record * (size_t)changedCount;
+}
+
+size_t SceneFormat_EncodeDelta(ECSWorld* world, void* buffer, size_t bufferSize) {
+    // Without a complete change list only a full snapshot is right
+    if (world->changesLost) return 0;
+
+    unsigned int savedMask = SceneFormat_SavedMask();
+    SceneCursor cursor = {(unsigned char*)buffer, bufferSize, 0, false};
+    SceneCursor_PutU32(&cursor, SCENE_FORMAT_DELTA_MAGIC);
+    SceneCursor_PutU16(&cursor, SCENE_FORMAT_VERSION);
+    SceneCursor_PutU16(&cursor, SCENE_FORMAT_VERSION);     // minReader
+    SceneCursor_PutU32(&cursor, SCENE_FORMAT_DELTA_HEADER_SIZE);
+    size_t totalSizeOffset = cursor.offset;
+    SceneCursor_PutU32(&cursor, 0);                         // totalSize, patched below
+    SceneCursor_PutU32(&cursor, (unsigned int)world->changedSlotCount);
+    SceneCursor_PutU16(&cursor, savedMask);
+    SceneCursor_PutU16(&cursor, 0);
+
+    // Chunk types are listed in bit order, so the size table follows them
+    for (int t = 0; t < SCENE_CHUNK_TYPE_COUNT; t++) {
+        SceneCursor_PutU16(&cursor, (unsigned int)SceneFormat_RecordSize(g_chunkTypes[t]));
+    }
+
+    for (int i = 0; i < world->changedSlotCount && !cursor.overflow; i++) {
+        ECSChange change;
+        ECS_GetChange(world, i, &change);
+        bool alive = change.entity != ECS_INVALID_ENTITY;
+        unsigned int mask = alive ? ECS_GetComponentMask(world, change.entity) & savedMask : 0;
+        unsigned int changed = change.created ? mask : change.changedMask & savedMask;
+
+        SceneCursor_PutU32(&cursor, (unsigned int)change.slot);
+        SceneCursor_PutU8(&cursor, (alive ? SCENE_DELTA_ALIVE : 0) | (alive && change.created ? SCENE_DELTA_CREATED : 0));
+        SceneCursor_PutU16(&cursor, mask);
+        SceneCursor_PutU16(&cursor, changed);
+        for (int t = 0; t < SCENE_CHUNK_TYPE_COUNT; t++) {
+            if (changed & mask & COMPONENT_BIT(g_chunkTypes[t])) {
+                SceneFormat_WriteRecord(&cursor, world, change.entity, g_chunkTypes[t], NULL);
+            }
+        }
+    }
+    if (cursor.overflow) return 0;
+
+    size_t totalSize = cursor.offset;
+    cursor.offset = totalSizeOffset;
+    SceneCursor_PutU32(&cursor, (unsigned int)totalSize);
+    return totalSize;
+}
+
+typedef struct {
+    unsigned int minReader;
+    unsigned int headerSize;
+    unsigned int totalSize;
+    unsigned int recordCount;
+    unsigned int typeMask;
+    unsigned int recordSizes[SCENE_DELTA_TYPE_BITS];    // By type bit, 0 outside typeMask
+    size_t recordsOffset;
+} SceneDeltaHeader;
+
+static bool SceneFormat_ReadDeltaHeader(const void* data, size_t size, SceneDeltaHeader* header) {
+    SceneCursor cursor = {(unsigned char*)data, size, 0, false};
+    if (SceneCursor_GetU32(&cursor) != SCENE_FORMAT_DELTA_MAGIC) return false;
+    SceneCursor_GetU16(&cursor);
+    header->minReader = SceneCursor_GetU16(&cursor);
+    header->headerSize = SceneCursor_GetU32(&cursor);
+    header->totalSize = SceneCursor_GetU32(&cursor);
+    header->recordCount = SceneCursor_GetU32(&cursor);
+    header->typeMask = SceneCursor_GetU16(&cursor);
+    if (cursor.overflow || header->headerSize < SCENE_FORMAT_DELTA_HEADER_SIZE || header->totalSize > size ||
+        header->headerSize > header->totalSize) {
+        return false;
+    }
+
+    cursor.size = header->totalSize;
+    cursor.offset = header->headerSize;
+    for (int bit = 0; bit < SCENE_DELTA_TYPE_BITS; bit++) {
+        header->recordSizes[bit] = (header->typeMask & (1u << bit)) ? SceneCursor_GetU16(&cursor) : 0;
+    }
+    header->recordsOffset = cursor.offset;
+    return !cursor.overflow;
+}
+
+bool SceneFormat_IsDelta(const void* data, size_t size) {
+    SceneDeltaHeader header;
+    return SceneFormat_ReadDeltaHeader(data, size, &header);
+}
+
+// Every record must fit, name a slot below slotCount, and carry only
+// component types listed in the size table, known ones at full length and
+// holding values this version can load
+static bool SceneFormat_ValidateDelta(const unsigned char* data, const SceneDeltaHeader* header, int slotCount) {
+    for (int bit = 0; bit < SCENE_DELTA_TYPE_BITS; bit++) {
+        if (SceneFormat_IsKnownType((unsigned int)bit) && (header->typeMask & (1u << bit)) &&
+            header->recordSizes[bit] < SceneFormat_RecordSize((ComponentType)bit)) {
+            return false;
+        }
+    }
+
+    SceneCursor cursor = {(unsigned char*)data, header->totalSize, header->recordsOffset, false};
+    for (unsigned int r = 0; r < header->recordCount; r++) {
+        unsigned int slot = SceneCursor_GetU32(&cursor);
+        SceneCursor_GetU8(&cursor);
+        unsigned int mask = SceneCursor_GetU16(&cursor);
+        unsigned int changed = SceneCursor_GetU16(&cursor) & mask;
+        if (slot >= (unsigned int)slotCount || (changed & ~header->typeMask)) return false;
+        for (int bit = 0; bit < SCENE_DELTA_TYPE_BITS; bit++) {
+            if (!(changed & (1u << bit))) continue;
+            const unsigned char* record = SceneCursor_Take(&cursor, header->recordSizes[bit]);
+            if (record && SceneFormat_IsKnownType((unsigned int)bit) &&
+                !SceneFormat_RecordValid(record, (ComponentType)bit)) {
+                return false;
+            }
+        }
+    }
+    return !cursor.overflow;
+}
+
+// Applies the records of one kind, like SceneFormat_ApplyChunks: entities and
+// components first, hierarchy links once every entity exists
+static void SceneFormat_ApplyDeltaRecords(ECSWorld* world, const unsigned char* data, const SceneDeltaHeader* header,
+                                          EntityID* slotMap, int slotCount, bool links) {
+    unsigned int savedMask = SceneFormat_SavedMask();
+    SceneCursor cursor = {(unsigned char*)data, header->totalSize, header->recordsOffset, false};
+
+    for (unsigned int r = 0; r < header->recordCount; r++) {
+        unsigned int slot = SceneCursor_GetU32(&cursor);
+        unsigned int flags = SceneCursor_GetU8(&cursor);
+        unsigned int mask = SceneCursor_GetU16(&cursor);
+        unsigned int changed = SceneCursor_GetU16(&cursor) & mask;
+        EntityID id = slotMap[slot];
+
+        if (!links) {
+            if (!(flags & SCENE_DELTA_ALIVE)) {
+                ECS_DestroyEntity(world, id);
+                slotMap[slot] = ECS_INVALID_ENTITY;
+            } else {
+                // A reused slot holds a new entity
+                if ((flags & SCENE_DELTA_CREATED) || !ECS_IsEntityValid(world, id)) {
+                    ECS_DestroyEntity(world, id);
+                    id = ECS_CreateEntity(world);
+                    slotMap[slot] = id;
+                }
+                unsigned int removed = ECS_GetComponentMask(world, id) & ~mask & savedMask;
+                for (int t = 0; t < SCENE_CHUNK_TYPE_COUNT; t++) {
+                    if (removed & COMPONENT_BIT(g_chunkTypes[t])) ECS_RemoveComponent(world, id, g_chunkTypes[t]);
+                }
+            }
+        }
+
+        for (int bit = 0; bit < SCENE_DELTA_TYPE_BITS; bit++) {
+            if (!(changed & (1u << bit))) continue;
+            size_t next = cursor.offset + header->recordSizes[bit];
+            if (bit == COMPONENT_HIERARCHY) {
+                if (links) {
+                    unsigned int parent = SceneCursor_GetU32(&cursor);
+                    EntityID parentId = parent < (unsigned int)slotCount ? slotMap[parent] : ECS_INVALID_ENTITY;
+                    Hierarchy_SetParent(world, id, parentId);
+                }
+            } else if (!links && SceneFormat_IsKnownType((unsigned int)bit)) {
+                SceneFormat_ReadRecord(&cursor, world, id, (ComponentType)bit, NULL, 0);
+                // An existing transform is not queued by being added again
+                if (bit == COMPONENT_TRANSFORM) ECS_MarkTransformDirty(world, id);
+            }
+            cursor.offset = next;
+        }
+    }
+}
+
+bool SceneFormat_ApplyDelta(ECSWorld* world, const void* data, size_t size, EntityID* slotMap, int slotCount) {
+    SceneDeltaHeader header;
+    if (!SceneFormat_ReadDeltaHeader(data, size, &header) || header.minReader > SCENE_FORMAT_VERSION ||
+        !SceneFormat_ValidateDelta((const unsigned char*)data, &header, slotCount)) {
+        return false;
+    }
+
+    SceneFormat_ApplyDeltaRecords(world, (const unsigned char*)data, &header, slotMap, slotCount, false);
+    SceneFormat_ApplyDeltaRecords(world, (const unsigned char*)data, &header, slotMap, slotCount, true);
+    return true;
+}
+
+size_t SceneFormat_MaxPackedSize(size_t rawSize) {
+    return SCENE_FORMAT_PACKED_HEADER_SIZE + Lz_MaxCompressedSize(rawSize);
+}
+
+size_t SceneFormat_Pack(const void* raw, size_t rawSize, void* buffer, size_t bufferSize) {
+    if (bufferSize < SceneFormat_MaxPackedSize(rawSize)) return 0;
+
+    unsigned char* out = (unsigned char*)buffer;
+    size_t packedSize = Lz_Compress(raw, rawSize, out + SCENE_FORMAT_PACKED_HEADER_SIZE,
+                                    bufferSize - SCENE_FORMAT_PACKED_HEADER_SIZE);
+    if (packedSize == 0 || SCENE_FORMAT_PACKED_HEADER_SIZE + packedSize >= rawSize) return 0;
+
+    SceneCursor cursor = {out, SCENE_FORMAT_PACKED_HEADER_SIZE, 0, false};
+    SceneCursor_PutU32(&cursor, SCENE_FORMAT_PACKED_MAGIC);
+    SceneCursor_PutU32(&cursor, (unsigned int)rawSize);
+    SceneCursor_PutU32(&cursor, (unsigned int)packedSize);
+    return SCENE_FORMAT_PACKED_HEADER_SIZE + packedSize;
+}
+
+size_t SceneFormat_PackedRawSize(const void* data, size_t size) {
+    SceneCursor cursor = {(unsigned char*)data, size, 0, false};
+    if (SceneCursor_GetU32(&cursor) != SCENE_FORMAT_PACKED_MAGIC) return 0;
+    size_t rawSize = SceneCursor_GetU32(&cursor);
+    return cursor.overflow ? 0 : rawSize;
+}
+
+size_t SceneFormat_Unpack(const void* data, size_t size, void* raw, size_t rawCapacity) {
+    SceneCursor cursor = {(unsigned char*)data, size, 0, false};
+    if (SceneCursor_GetU32(&cursor) != SCENE_FORMAT_PACKED_MAGIC) return 0;
+    size_t rawSize = SceneCursor_GetU32(&cursor);
+    size_t packedSize = SceneCursor_GetU32(&cursor);
+    if (cursor.overflow || rawSize > rawCapacity || packedSize > size - SCENE_FORMAT_PACKED_HEADER_SIZE) return 0;
+
+    size_t unpacked = Lz_Decompress((const unsigned char*)data + SCENE_FORMAT_PACKED_HEADER_SIZE, packedSize, raw,
+                                    rawSize);
+    return unpacked == rawSize ? rawSize : 0;
+}
+
+// Transform and renderable fields without their derived/per-frame state
+// (world matrix, sphere LOD), so saves keep their layout
+typedef struct {
+    Vector3 position;
+    Vector3 rotation;
+    Vector3 scale;
+} SceneTransformSave;
+
+typedef struct {
+    RenderableType type;
+    Color color;
+    Vector3 size;
+} SceneRenderableSave;
+
+// Camera fields without the interpolation state
+typedef struct {
+    Camera3D camera;
+    float moveSpeed;
+    float lookSpeed;
+    float pitch;
+} SceneCameraSave;
+
+typedef struct {
+    unsigned int componentMask;
+    SceneTransformSave transform;
+    SceneRenderableSave renderable;
+    SceneCameraSave camera;
+    InputComponent input;
+} SceneEntitySave;
+
+// Sized at runtime; a save written at the old 256-entry size loads unchanged
+typedef struct {
+    int activeCount;
+    SceneEntitySave entities[];
+} SceneSaveData;
+
+size_t SceneFormat_LegacySize(int entityCount) {
+    return sizeof(SceneSaveData) + sizeof(SceneEntitySave) * (size_t)entityCount;
+}
+
+size_t SceneFormat_EncodeLegacy(ECSWorld* world, void* buffer, size_t bufferSize) {
+    size_t saveSize = SceneFormat_LegacySize(world->entityCount);
+    if (saveSize > bufferSize) return 0;
+
+    SceneSaveData* saveData = (SceneSaveData*)buffer;
+    memset(saveData, 0, saveSize);
+
+    for (EntityID id = ECS_FirstEntity(world); id != ECS_INVALID_ENTITY; id = ECS_NextEntity(world, id)) {
+        SceneEntitySave* entry = &saveData->entities[saveData->activeCount++];
+        entry->componentMask = ECS_GetComponentMask(world, id);
+
+        if (entry->componentMask & (1 << COMPONENT_TRANSFORM)) {
+            TransformComponent* transform = (TransformComponent*)ECS_GetComponent(world, id, COMPONENT_TRANSFORM);
+            if (transform) {
+                entry->transform.position = transform->position;
+                entry->transform.rotation = transform->rotation;
+                entry->transform.scale = transform->scale;
+            }
+        }
+
+        if (entry->componentMask & (1 << COMPONENT_RENDERABLE)) {
+            RenderableComponent* renderable = (RenderableComponent*)ECS_GetComponent(world, id, COMPONENT_RENDERABLE);
+            if (renderable) {
+                entry->renderable.type = renderable->type;
+                entry->renderable.color = renderable->color;
+                entry->renderable.size = renderable->size;
+            }
+        }
+
+        if (entry->componentMask & (1 << COMPONENT_CAMERA)) {
+            CameraComponent* camera = (CameraComponent*)ECS_GetComponent(world, id, COMPONENT_CAMERA);
+            if (camera) {
+                entry->camera.camera = camera->camera;
+                entry->camera.moveSpeed = camera->moveSpeed;
+                entry->camera.lookSpeed = camera->lookSpeed;
+                entry->camera.pitch = camera->pitch;
+            }
+        }
+
+        if (entry->componentMask & (1 << COMPONENT_INPUT)) {
+            InputComponent* input = (InputComponent*)ECS_GetComponent(world, id, COMPONENT_INPUT);
+            if (input) entry->input = *input;
+        }
+    }
+
+    return saveSize;
+}
+
+bool SceneFormat_DecodeLegacy(ECSWorld* world, const void* data, size_t size) {
+    const SceneSaveData* saveData = (const SceneSaveData*)data;
+    int capacity = ECS_GetCapacity(world);
+    if (size < sizeof(SceneSaveData) || saveData->activeCount < 0 || saveData->activeCount > capacity ||
+        SceneFormat_LegacySize(saveData->activeCount) > size) {
+        return false;
+    }
+    for (int i = 0; i < saveData->activeCount; i++) {
+        const SceneEntitySave* entry = &saveData->entities[i];
+        if ((entry->componentMask & (1 << COMPONENT_RENDERABLE)) &&
+            !SceneFormat_IsRenderableType((unsigned int)entry->renderable.type)) {
+            return false;
+        }
+    }
+
+    ECS_Cleanup(world);
+    ECS_InitWithCapacity(world, capacity);
+
+    for (int i = 0; i < saveData->activeCount; i++) {
+        const SceneEntitySave* entry = &saveData->entities[i];
+        EntityID id = ECS_CreateEntity(world);
+        if (id < 0) {
+            return false;
+        }
+
+        if (entry->componentMask & (1 << COMPONENT_TRANSFORM)) {
+            TransformComponent* transform = (TransformComponent*)ECS_AddComponent(world, id, COMPONENT_TRANSFORM);
+            // Adding the component already queued its world matrix
+            if (transform) {
+                transform->position = entry->transform.position;
+                transform->rotation = entry->transform.rotation;
+                transform->scale = entry->transform.scale;
+            }
+        }
+
+        if (entry->componentMask & (1 << COMPONENT_RENDERABLE)) {
+            RenderableComponent* renderable = (RenderableComponent*)ECS_AddComponent(world, id, COMPONENT_RENDERABLE);
+            if (renderable) {
+                renderable->type = entry->renderable.type;
+                renderable->color = entry->renderable.color;
+                renderable->size = entry->renderable.size;
+            }
+        }
+
+        if (entry->componentMask & (1 << COMPONENT_CAMERA)) {
+            CameraComponent* camera = (CameraComponent*)ECS_AddComponent(world, id, COMPONENT_CAMERA);
+            if (camera) {
+                camera->camera = entry->camera.camera;
+                camera->moveSpeed = entry->camera.moveSpeed;
+                camera->lookSpeed = entry->camera.lookSpeed;
+                camera->pitch = entry->camera.pitch;
+            }
+        }
+
+        if (entry->componentMask & (1 << COMPONENT_INPUT)) {
+            InputComponent* input = (InputComponent*)ECS_AddComponent(world, id, COMPONENT_INPUT);
+            if (input) *input = entry->input;
+        }
+
+        if (entry->componentMask & (1 << COMPONENT_STATIC)) {
+            ECS_AddComponent(world, id, COMPONENT_STATIC);
+        }
+    }
+
+    return true;
+}
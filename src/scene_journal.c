@@ -0,0 +1,164 @@
+#include "scene_journal.h"
+#include "scene_format.h"
+#include "mem.h"
+#include <string.h>
+
+static unsigned int SceneJournal_Checksum(const unsigned char* data, size_t size) {
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void SceneJournal_PutU32(unsigned char* p, unsigned int value) {
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8);
+    p[2] = (unsigned char)(value >> 16);
+    p[3] = (unsigned char)(value >> 24);
+}
+
+static unsigned int SceneJournal_GetU32(const unsigned char* p) {
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+void SceneJournal_Init(SceneJournal* journal, bool compress) {
+    memset(journal, 0, sizeof(*journal));
+    journal->compress = compress;
+}
+
+void SceneJournal_Reset(SceneJournal* journal) {
+    journal->snapshotSize = 0;
+    journal->deltaSize = 0;
+    journal->deltaCount = 0;
+}
+
+bool SceneJournal_HasChanges(const SceneJournal* journal, const ECSWorld* world) {
+    return journal->snapshotSize == 0 || world->changesLost || world->changedSlotCount > 0;
+}
+
+static void SceneJournal_FreeRecord(SceneJournalRecord* record) {
+    Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, record->data, record->capacity);
+    memset(record, 0, sizeof(*record));
+}
+
+// Encodes a snapshot or delta and frames it into a new record
+static bool SceneJournal_Build(SceneJournal* journal, ECSWorld* world, bool snapshot, SceneJournalRecord* record) {
+    size_t rawCapacity = snapshot ? SceneFormat_MaxEncodedSize(world->entityCount)
+                                  : SceneFormat_MaxDeltaSize(world->changedSlotCount);
+    unsigned char* raw = (unsigned char*)Mem_ScratchAlloc(MEM_SUBSYSTEM_SCENE, rawCapacity);
+    if (!raw) return false;
+    size_t rawSize = snapshot ? SceneFormat_EncodeSnapshot(world, raw, rawCapacity)
+                              : SceneFormat_EncodeDelta(world, raw, rawCapacity);
+
+    // Room for the packed form, which is never smaller than the raw bytes it replaces
+    record->capacity = SCENE_JOURNAL_HEADER_SIZE + SceneFormat_MaxPackedSize(rawSize);
+    record->data = rawSize > 0 ? (unsigned char*)Mem_ScratchAlloc(MEM_SUBSYSTEM_SCENE, record->capacity) : NULL;
+    if (!record->data) {
+        record->capacity = 0;
+        Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, raw, rawCapacity);
+        return false;
+    }
+
+    unsigned char* payload = record->data + SCENE_JOURNAL_HEADER_SIZE;
+    size_t payloadSize = journal->compress ? SceneFormat_Pack(raw, rawSize, payload,
+                                                              record->capacity - SCENE_JOURNAL_HEADER_SIZE)
+                                           : 0;
+    if (payloadSize == 0) {
+        memcpy(payload, raw, rawSize);
+        payloadSize = rawSize;
+    }
+    Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, raw, rawCapacity);
+
+    SceneJournal_PutU32(record->data, SCENE_JOURNAL_MAGIC);
+    SceneJournal_PutU32(record->data + 4, (unsigned int)payloadSize);
+    SceneJournal_PutU32(record->data + 8, SceneJournal_Checksum(payload, payloadSize));
+    record->size = SCENE_JOURNAL_HEADER_SIZE + payloadSize;
+    record->snapshot = snapshot;
+    return true;
+}
+
+bool SceneJournal_BeginRecord(SceneJournal* journal, ECSWorld* world, SceneJournalRecord* record) {
+    memset(record, 0, sizeof(*record));
+
+    if (journal->snapshotSize > 0 && !world->changesLost && journal->deltaCount < SCENE_JOURNAL_MAX_DELTAS) {
+        if (SceneJournal_Build(journal, world, false, record) &&
+            journal->deltaSize + record->size <= journal->snapshotSize) {
+            return true;
+        }
+        // Compaction: the snapshot now costs less to replay than the deltas
+        SceneJournal_FreeRecord(record);
+    }
+    return SceneJournal_Build(journal, world, true, record);
+}
+
+void SceneJournal_EndRecord(SceneJournal* journal, ECSWorld* world, SceneJournalRecord* record, bool stored) {
+    if (!stored) {
+        SceneJournal_Reset(journal);
+    } else if (record->snapshot) {
+        journal->snapshotSize = record->size;
+        journal->deltaSize = 0;
+        journal->deltaCount = 0;
+        ECS_ClearChanges(world);
+    } else {
+        journal->deltaSize += record->size;
+        journal->deltaCount++;
+        ECS_ClearChanges(world);
+    }
+    SceneJournal_FreeRecord(record);
+}
+
+size_t SceneJournal_MaxSize(int capacity) {
+    return 2 * (SCENE_JOURNAL_HEADER_SIZE + SceneFormat_MaxPackedSize(SceneFormat_MaxEncodedSize(capacity)));
+}
+
+int SceneJournal_Replay(ECSWorld* world, const void* data, size_t size, EntityID* slotMap) {
+    int capacity = ECS_GetCapacity(world);
+    size_t mapSize = sizeof(EntityID) * (size_t)capacity;
+    EntityID* map = slotMap ? slotMap : (EntityID*)Mem_ScratchAlloc(MEM_SUBSYSTEM_SCENE, mapSize);
+    if (!map) return 0;
+
+    // No record expands past the largest snapshot or delta this world can take
+    size_t rawLimit = SceneFormat_MaxEncodedSize(capacity);
+    if (SceneFormat_MaxDeltaSize(capacity) > rawLimit) rawLimit = SceneFormat_MaxDeltaSize(capacity);
+
+    const unsigned char* bytes = (const unsigned char*)data;
+    size_t offset = 0;
+    int applied = 0;
+    while (size - offset >= SCENE_JOURNAL_HEADER_SIZE) {
+        const unsigned char* header = bytes + offset;
+        size_t payloadSize = SceneJournal_GetU32(header + 4);
+        const unsigned char* payload = header + SCENE_JOURNAL_HEADER_SIZE;
+        if (SceneJournal_GetU32(header) != SCENE_JOURNAL_MAGIC ||
+            payloadSize > size - offset - SCENE_JOURNAL_HEADER_SIZE ||
+            SceneJournal_GetU32(header + 8) != SceneJournal_Checksum(payload, payloadSize)) {
+            break;
+        }
+
+        const void* body = payload;
+        size_t bodySize = payloadSize;
+        size_t rawSize = SceneFormat_PackedRawSize(payload, payloadSize);
+        void* raw = NULL;
+        if (rawSize > 0) {
+            raw = rawSize <= rawLimit ? Mem_ScratchAlloc(MEM_SUBSYSTEM_SCENE, rawSize) : NULL;
+            if (!raw || SceneFormat_Unpack(payload, payloadSize, raw, rawSize) != rawSize) {
+                if (raw) Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, raw, rawSize);
+                break;
+            }
+            body = raw;
+            bodySize = rawSize;
+        }
+
+        bool ok = applied == 0 ? SceneFormat_DecodeSnapshot(world, body, bodySize, map, capacity)
+                               : SceneFormat_ApplyDelta(world, body, bodySize, map, capacity);
+        if (raw) Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, raw, rawSize);
+        if (!ok) break;
+
+        applied++;
+        offset += SCENE_JOURNAL_HEADER_SIZE + payloadSize;
+    }
+
+    if (!slotMap) Mem_ScratchFree(MEM_SUBSYSTEM_SCENE, map, mapSize);
+    return applied;
+}
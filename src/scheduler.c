@@ -0,0 +1,329 @@
+#include "scheduler.h"
+#include "mem.h"
+#include <string.h>
+
+#if SCHEDULER_THREADS
+#include <pthread.h>
+#include <unistd.h>
+
+// Ready systems owned by one worker. Every system becomes ready once per
+// run, so a run never pushes more than SCHEDULER_MAX_SYSTEMS entries and
+// the deque is emptied between runs instead of wrapping. The owner pops
+// the newest entry, thieves take the oldest.
+typedef struct {
+    pthread_mutex_t lock;
+    int items[SCHEDULER_MAX_SYSTEMS];
+    int head;
+    int tail;
+} SchedulerDeque;
+
+typedef struct {
+    SchedulerPool* pool;
+    int index;
+} SchedulerWorker;
+
+struct SchedulerPool {
+    pthread_t threads[SCHEDULER_MAX_WORKERS];
+    SchedulerWorker workers[SCHEDULER_MAX_WORKERS];
+    SchedulerDeque deques[SCHEDULER_MAX_WORKERS];
+    int threadCount;                        // Started threads; worker 0 is the caller of Scheduler_Run
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake;                    // A run started, or shutdown
+    pthread_cond_t ready;                   // A system became ready, or the run finished
+    pthread_cond_t idle;                    // The last thread left the run
+    unsigned int generation;                // Bumped once per run
+    bool quit;
+    int busyThreads;                        // Threads still inside the current run
+
+    // Current run; the counters are updated atomically
+    const Scheduler* scheduler;
+    ECSWorld* world;
+    float deltaTime;
+    int remaining[SCHEDULER_MAX_SYSTEMS];   // Unfinished dependencies per system
+    int readyCount;
+    int completed;
+};
+
+static void Scheduler_Push(SchedulerPool* pool, int worker, int system) {
+    SchedulerDeque* deque = &pool->deques[worker];
+    pthread_mutex_lock(&deque->lock);
+    deque->items[deque->tail++] = system;
+    pthread_mutex_unlock(&deque->lock);
+
+    // Sleepers check readyCount under the pool lock, so this cannot be missed
+    __atomic_add_fetch(&pool->readyCount, 1, __ATOMIC_ACQ_REL);
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_broadcast(&pool->ready);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Own deque first, then the other workers' in turn; -1 if all are empty
+static int Scheduler_Take(SchedulerPool* pool, int worker) {
+    int workerCount = pool->threadCount + 1;
+    int system = -1;
+
+    SchedulerDeque* own = &pool->deques[worker];
+    pthread_mutex_lock(&own->lock);
+    if (own->tail > own->head) {
+        system = own->items[--own->tail];
+    }
+    pthread_mutex_unlock(&own->lock);
+
+    for (int k = 1; system < 0 && k < workerCount; k++) {
+        SchedulerDeque* victim = &pool->deques[(worker + k) % workerCount];
+        pthread_mutex_lock(&victim->lock);
+        if (victim->tail > victim->head) {
+            system = victim->items[victim->head++];
+        }
+        pthread_mutex_unlock(&victim->lock);
+    }
+
+    if (system >= 0) {
+        __atomic_sub_fetch(&pool->readyCount, 1, __ATOMIC_ACQ_REL);
+    }
+    return system;
+}
+
+// Runs ready systems until every system of the run has finished
+static void Scheduler_Work(SchedulerPool* pool, int worker) {
+    const Scheduler* scheduler = pool->scheduler;
+    int systemCount = scheduler->systemCount;
+
+    while (__atomic_load_n(&pool->completed, __ATOMIC_ACQUIRE) < systemCount) {
+        int system = Scheduler_Take(pool, worker);
+        if (system < 0) {
+            // Everything ready is already running; wait for it to release more.
+            // readyCount dips below zero while a push is being counted.
+            pthread_mutex_lock(&pool->lock);
+            while (__atomic_load_n(&pool->readyCount, __ATOMIC_ACQUIRE) <= 0 &&
+                   __atomic_load_n(&pool->completed, __ATOMIC_ACQUIRE) < systemCount) {
+                pthread_cond_wait(&pool->ready, &pool->lock);
+            }
+            pthread_mutex_unlock(&pool->lock);
+            continue;
+        }
+
+        const SystemDesc* desc = &scheduler->systems[system];
+        desc->update(pool->world, pool->deltaTime, desc->user);
+
+        // Dependents released here go to this worker's deque, where the
+        // data they share with this system is still warm
+        unsigned int dependents = scheduler->dependents[system];
+        while (dependents) {
+            int next = __builtin_ctz(dependents);
+            dependents &= dependents - 1;
+            if (__atomic_sub_fetch(&pool->remaining[next], 1, __ATOMIC_ACQ_REL) == 0) {
+                Scheduler_Push(pool, worker, next);
+            }
+        }
+
+        if (__atomic_add_fetch(&pool->completed, 1, __ATOMIC_ACQ_REL) == systemCount) {
+            pthread_mutex_lock(&pool->lock);
+            pthread_cond_broadcast(&pool->ready);
+            pthread_mutex_unlock(&pool->lock);
+        }
+    }
+}
+
+static void* Scheduler_WorkerMain(void* arg) {
+    SchedulerWorker* worker = (SchedulerWorker*)arg;
+    SchedulerPool* pool = worker->pool;
+    unsigned int seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->quit && pool->generation == seen) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        if (pool->quit) {
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        Scheduler_Work(pool, worker->index);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busyThreads == 0) {
+            pthread_cond_signal(&pool->idle);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+static void Scheduler_ReleasePool(SchedulerPool* pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->threadCount; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    for (int i = 0; i < SCHEDULER_MAX_WORKERS; i++) {
+        pthread_mutex_destroy(&pool->deques[i].lock);
+    }
+    pthread_cond_destroy(&pool->idle);
+    pthread_cond_destroy(&pool->ready);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    Mem_Free(MEM_SUBSYSTEM_ECS, pool, sizeof(SchedulerPool));
+}
+
+static SchedulerPool* Scheduler_CreatePool(int workerCount) {
+    SchedulerPool* pool = (SchedulerPool*)Mem_Alloc(MEM_SUBSYSTEM_ECS, sizeof(SchedulerPool));
+    if (!pool) {
+        return NULL;
+    }
+    memset(pool, 0, sizeof(SchedulerPool));
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->ready, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+    for (int i = 0; i < SCHEDULER_MAX_WORKERS; i++) {
+        pthread_mutex_init(&pool->deques[i].lock, NULL);
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+    }
+
+    // Thread i serves worker i + 1. Stop at the first thread that fails to
+    // start and make do with the ones that did.
+    for (int i = 0; i < workerCount - 1; i++) {
+        if (pthread_create(&pool->threads[i], NULL, Scheduler_WorkerMain, &pool->workers[i + 1]) != 0) {
+            break;
+        }
+        pool->threadCount++;
+    }
+
+    if (pool->threadCount == 0) {
+        Scheduler_ReleasePool(pool);
+        return NULL;
+    }
+    return pool;
+}
+#endif
+
+void Scheduler_Init(Scheduler* scheduler, int workerCount) {
+    memset(scheduler, 0, sizeof(Scheduler));
+    scheduler->workerCount = 1;
+
+#if SCHEDULER_THREADS
+    if (workerCount <= 0) {
+        workerCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (workerCount > SCHEDULER_MAX_WORKERS) {
+        workerCount = SCHEDULER_MAX_WORKERS;
+    }
+    if (workerCount > 1) {
+        scheduler->pool = Scheduler_CreatePool(workerCount);
+        if (scheduler->pool) {
+            scheduler->workerCount = scheduler->pool->threadCount + 1;
+        }
+    }
+#else
+    (void)workerCount;
+#endif
+}
+
+void Scheduler_Shutdown(Scheduler* scheduler) {
+#if SCHEDULER_THREADS
+    if (scheduler->pool) {
+        Scheduler_ReleasePool(scheduler->pool);
+    }
+#endif
+    memset(scheduler, 0, sizeof(Scheduler));
+}
+
+int Scheduler_AddSystem(Scheduler* scheduler, const SystemDesc* desc) {
+    if (scheduler->systemCount >= SCHEDULER_MAX_SYSTEMS) {
+        return -1;
+    }
+
+    int index = scheduler->systemCount++;
+    scheduler->systems[index] = *desc;
+    scheduler->dependents[index] = 0;
+    scheduler->dependencyCounts[index] = 0;
+
+    // Wait for every earlier system this one conflicts with
+    for (int i = 0; i < index; i++) {
+        const SystemDesc* other = &scheduler->systems[i];
+        if ((desc->writes & (other->reads | other->writes)) || (desc->reads & other->writes)) {
+            scheduler->dependents[i] |= 1u << index;
+            scheduler->dependencyCounts[index]++;
+        }
+    }
+    return index;
+}
+
+void Scheduler_RunSerial(Scheduler* scheduler, ECSWorld* world, float deltaTime) {
+    for (int i = 0; i < scheduler->systemCount; i++) {
+        const SystemDesc* desc = &scheduler->systems[i];
+        desc->update(world, deltaTime, desc->user);
+    }
+}
+
+// Runs every system, in parallel where the pool allows
+static void Scheduler_Dispatch(Scheduler* scheduler, ECSWorld* world, float deltaTime) {
+#if SCHEDULER_THREADS
+    SchedulerPool* pool = scheduler->pool;
+    if (pool && scheduler->systemCount > 1) {
+        int workerCount = pool->threadCount + 1;
+
+        // Every thread is parked, so the run state can be set up unlocked;
+        // taking the pool lock below publishes it
+        pool->scheduler = scheduler;
+        pool->world = world;
+        pool->deltaTime = deltaTime;
+        pool->completed = 0;
+        pool->readyCount = 0;
+        for (int i = 0; i < workerCount; i++) {
+            pool->deques[i].head = 0;
+            pool->deques[i].tail = 0;
+        }
+
+        // Systems without dependencies are dealt out round-robin
+        int next = 0;
+        for (int i = 0; i < scheduler->systemCount; i++) {
+            pool->remaining[i] = scheduler->dependencyCounts[i];
+            if (pool->remaining[i] == 0) {
+                SchedulerDeque* deque = &pool->deques[next];
+                deque->items[deque->tail++] = i;
+                pool->readyCount++;
+                next = (next + 1) % workerCount;
+            }
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        pool->busyThreads = pool->threadCount;
+        pool->generation++;
+        pthread_cond_broadcast(&pool->wake);
+        pthread_mutex_unlock(&pool->lock);
+
+        Scheduler_Work(pool, 0);
+
+        // The next run resets the deques, so no thread may still be stealing
+        pthread_mutex_lock(&pool->lock);
+        while (pool->busyThreads > 0) {
+            pthread_cond_wait(&pool->idle, &pool->lock);
+        }
+        pthread_mutex_unlock(&pool->lock);
+        return;
+    }
+#endif
+    Scheduler_RunSerial(scheduler, world, deltaTime);
+}
+
+void Scheduler_Run(Scheduler* scheduler, ECSWorld* world, float deltaTime) {
+    for (int i = 0; i < scheduler->systemCount; i++) {
+        if (scheduler->systems[i].prepare) {
+            scheduler->systems[i].prepare(world);
+        }
+    }
+
+    if (world) world->runningSystems = true;
+    Scheduler_Dispatch(scheduler, world, deltaTime);
+    if (world) world->runningSystems = false;
+}
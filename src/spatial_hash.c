@@ -0,0 +1,263 @@
+#include "spatial_hash.h"
+#include "mem.h"
+#include <math.h>
+#include <string.h>
+
+static int SpatialHash_CellCoord(const SpatialHash* hash, float value) {
+    return (int)floorf(value * hash->invCellSize);
+}
+
+static int SpatialHash_Bucket(const SpatialHash* hash, int x, int y, int z) {
+    unsigned int h = ((unsigned int)x * 73856093u) ^ ((unsigned int)y * 19349663u) ^ ((unsigned int)z * 83492791u);
+    return (int)(h & (unsigned int)hash->bucketMask);
+}
+
+bool SpatialHash_Init(SpatialHash* hash, int capacity, float cellSize) {
+    memset(hash, 0, sizeof(SpatialHash));
+    if (capacity < 1 || cellSize <= 0.0f) {
+        return false;
+    }
+
+    // About one bucket per entity keeps chains short without per-cell storage
+    int bucketCount = 64;
+    while (bucketCount < capacity) bucketCount <<= 1;
+
+    hash->cellSize = cellSize;
+    hash->invCellSize = 1.0f / cellSize;
+    hash->capacity = capacity;
+    hash->bucketMask = bucketCount - 1;
+    hash->buckets = (int*)Mem_Alloc(MEM_SUBSYSTEM_SPATIAL, sizeof(int) * (size_t)bucketCount);
+    hash->entries = (SpatialHashEntry*)Mem_Alloc(MEM_SUBSYSTEM_SPATIAL, sizeof(SpatialHashEntry) * (size_t)capacity);
+    hash->dense = (int*)Mem_Alloc(MEM_SUBSYSTEM_SPATIAL, sizeof(int) * (size_t)capacity);
+    if (!hash->buckets || !hash->entries || !hash->dense) {
+        SpatialHash_Release(hash);
+        return false;
+    }
+
+    for (int i = 0; i < capacity; i++) {
+        hash->entries[i].denseSlot = -1;
+    }
+    SpatialHash_Clear(hash);
+    return true;
+}
+
+void SpatialHash_Release(SpatialHash* hash) {
+    Mem_Free(MEM_SUBSYSTEM_SPATIAL, hash->buckets, sizeof(int) * (size_t)(hash->bucketMask + 1));
+    Mem_Free(MEM_SUBSYSTEM_SPATIAL, hash->entries, sizeof(SpatialHashEntry) * (size_t)hash->capacity);
+    Mem_Free(MEM_SUBSYSTEM_SPATIAL, hash->dense, sizeof(int) * (size_t)hash->capacity);
+    memset(hash, 0, sizeof(SpatialHash));
+}
+
+void SpatialHash_Clear(SpatialHash* hash) {
+    for (int i = 0; i <= hash->bucketMask; i++) {
+        hash->buckets[i] = -1;
+    }
+    for (int i = 0; i < hash->count; i++) {
+        hash->entries[hash->dense[i]].denseSlot = -1;
+    }
+    hash->count = 0;
+    hash->synced = false;
+}
+
+static void SpatialHash_Unlink(SpatialHash* hash, int index) {
+    SpatialHashEntry* entry = &hash->entries[index];
+    if (entry->prev >= 0) {
+        hash->entries[entry->prev].next = entry->next;
+    } else {
+        hash->buckets[entry->bucket] = entry->next;
+    }
+    if (entry->next >= 0) {
+        hash->entries[entry->next].prev = entry->prev;
+    }
+}
+
+static void SpatialHash_Link(SpatialHash* hash, int index) {
+    SpatialHashEntry* entry = &hash->entries[index];
+    entry->bucket = SpatialHash_Bucket(hash, entry->cell[0], entry->cell[1], entry->cell[2]);
+    entry->prev = -1;
+    entry->next = hash->buckets[entry->bucket];
+    if (entry->next >= 0) {
+        hash->entries[entry->next].prev = index;
+    }
+    hash->buckets[entry->bucket] = index;
+}
+
+void SpatialHash_Update(SpatialHash* hash, EntityID id, Vector3 position) {
+    if (id < 0) return;
+    int index = ECS_ENTITY_INDEX(id);
+    if (index >= hash->capacity) return;
+
+    SpatialHashEntry* entry = &hash->entries[index];
+    int x = SpatialHash_CellCoord(hash, position.x);
+    int y = SpatialHash_CellCoord(hash, position.y);
+    int z = SpatialHash_CellCoord(hash, position.z);
+
+    entry->id = id;
+    entry->position = position;
+
+    if (entry->denseSlot < 0) {
+        entry->denseSlot = hash->count;
+        hash->dense[hash->count++] = index;
+    } else if (entry->cell[0] == x && entry->cell[1] == y && entry->cell[2] == z) {
+        // Still in the same cell: nothing to relink
+        return;
+    } else {
+        SpatialHash_Unlink(hash, index);
+    }
+
+    entry->cell[0] = x;
+    entry->cell[1] = y;
+    entry->cell[2] = z;
+    SpatialHash_Link(hash, index);
+}
+
+static void SpatialHash_RemoveIndex(SpatialHash* hash, int index) {
+    SpatialHashEntry* entry = &hash->entries[index];
+    SpatialHash_Unlink(hash, index);
+
+    int last = hash->dense[--hash->count];
+    hash->dense[entry->denseSlot] = last;
+    hash->entries[last].denseSlot = entry->denseSlot;
+    entry->denseSlot = -1;
+}
+
+void SpatialHash_Remove(SpatialHash* hash, EntityID id) {
+    if (id < 0) return;
+    int index = ECS_ENTITY_INDEX(id);
+    if (index >= hash->capacity || hash->entries[index].denseSlot < 0 || hash->entries[index].id != id) {
+        return;
+    }
+    SpatialHash_RemoveIndex(hash, index);
+}
+
+// Re-reads the transforms queued since System_UpdateTransforms last ran
+static void SpatialHash_SyncDirty(SpatialHash* hash, ECSWorld* world) {
+    for (int i = 0; i < world->dirtyTransformCount; i++) {
+        EntityID id = world->dirtyTransforms[i];
+        const TransformComponent* transform = (const TransformComponent*)ECS_GetComponent(world, id,
+                                                                                          COMPONENT_TRANSFORM);
+        if (transform) SpatialHash_Update(hash, id, transform->position);
+    }
+
+    // Parented transforms are queued on their hierarchy node instead
+    if (!world->hierarchyDirty) return;
+    for (int i = 0; i < world->hierarchyCount; i++) {
+        const HierarchyNode* node = &world->hierarchyNodes[i];
+        if (!node->dirty) continue;
+        const TransformComponent* transform = (const TransformComponent*)ECS_GetComponent(world, node->entity,
+                                                                                          COMPONENT_TRANSFORM);
+        if (transform) SpatialHash_Update(hash, node->entity, transform->position);
+    }
+}
+
+void SpatialHash_Sync(SpatialHash* hash, ECSWorld* world) {
+    ECSQuery* query = ECS_GetQuery(world, COMPONENT_BIT(COMPONENT_TRANSFORM));
+    if (!query) return;
+
+    // Same entities as last time: only the dirty transforms can have moved
+    if (hash->synced && hash->version == query->version && !world->dirtyTransformOverflow) {
+        SpatialHash_SyncDirty(hash, world);
+        return;
+    }
+
+    unsigned int stamp = ++hash->syncStamp;
+
+    ECSQueryIter iter = ECS_QueryIter(world, query);
+    while (ECS_QueryNext(&iter)) {
+        const TransformComponent* transform = (const TransformComponent*)iter.components[COMPONENT_TRANSFORM];
+        SpatialHash_Update(hash, iter.entity, transform->position);
+
+        int index = ECS_ENTITY_INDEX(iter.entity);
+        if (index < hash->capacity) {
+            hash->entries[index].syncStamp = stamp;
+        }
+    }
+
+    // Walk backwards so the entry swapped into a freed slot was already checked
+    for (int i = hash->count - 1; i >= 0; i--) {
+        int index = hash->dense[i];
+        if (hash->entries[index].syncStamp != stamp) {
+            SpatialHash_RemoveIndex(hash, index);
+        }
+    }
+
+    hash->version = query->version;
+    hash->synced = true;
+}
+
+typedef struct {
+    Vector3 min;
+    Vector3 max;
+    Vector3 center;
+    float radiusSq;         // < 0 for box queries
+} SpatialHashQuery;
+
+static bool SpatialHash_Matches(const SpatialHashQuery* query, Vector3 p) {
+    if (query->radiusSq >= 0.0f) {
+        float dx = p.x - query->center.x;
+        float dy = p.y - query->center.y;
+        float dz = p.z - query->center.z;
+        return dx * dx + dy * dy + dz * dz <= query->radiusSq;
+    }
+    return p.x >= query->min.x && p.x <= query->max.x &&
+           p.y >= query->min.y && p.y <= query->max.y &&
+           p.z >= query->min.z && p.z <= query->max.z;
+}
+
+static int SpatialHash_Query(const SpatialHash* hash, const SpatialHashQuery* query, EntityID* results, int maxResults) {
+    int found = 0;
+    int x0 = SpatialHash_CellCoord(hash, query->min.x), x1 = SpatialHash_CellCoord(hash, query->max.x);
+    int y0 = SpatialHash_CellCoord(hash, query->min.y), y1 = SpatialHash_CellCoord(hash, query->max.y);
+    int z0 = SpatialHash_CellCoord(hash, query->min.z), z1 = SpatialHash_CellCoord(hash, query->max.z);
+    double cells = (double)(x1 - x0 + 1) * (double)(y1 - y0 + 1) * (double)(z1 - z0 + 1);
+
+    // A query spanning more cells than there are entries is cheaper as a scan
+    if (cells > (double)hash->count) {
+        for (int i = 0; i < hash->count; i++) {
+            const SpatialHashEntry* entry = &hash->entries[hash->dense[i]];
+            if (SpatialHash_Matches(query, entry->position)) {
+                if (found < maxResults) results[found] = entry->id;
+                found++;
+            }
+        }
+        return found;
+    }
+
+    for (int x = x0; x <= x1; x++) {
+        for (int y = y0; y <= y1; y++) {
+            for (int z = z0; z <= z1; z++) {
+                int index = hash->buckets[SpatialHash_Bucket(hash, x, y, z)];
+                while (index >= 0) {
+                    const SpatialHashEntry* entry = &hash->entries[index];
+                    // Buckets are shared by colliding cells; only take this cell's entries
+                    if (entry->cell[0] == x && entry->cell[1] == y && entry->cell[2] == z &&
+                        SpatialHash_Matches(query, entry->position)) {
+                        if (found < maxResults) results[found] = entry->id;
+                        found++;
+                    }
+                    index = entry->next;
+                }
+            }
+        }
+    }
+
+    return found;
+}
+
+int SpatialHash_QueryRadius(const SpatialHash* hash, Vector3 center, float radius, EntityID* results, int maxResults) {
+    SpatialHashQuery query;
+    query.min = (Vector3){center.x - radius, center.y - radius, center.z - radius};
+    query.max = (Vector3){center.x + radius, center.y + radius, center.z + radius};
+    query.center = center;
+    query.radiusSq = radius * radius;
+    return SpatialHash_Query(hash, &query, results, maxResults);
+}
+
+int SpatialHash_QueryAABB(const SpatialHash* hash, Vector3 min, Vector3 max, EntityID* results, int maxResults) {
+    SpatialHashQuery query;
+    query.min = min;
+    query.max = max;
+    query.center = (Vector3){0.0f, 0.0f, 0.0f};
+    query.radiusSq = -1.0f;
+    return SpatialHash_Query(hash, &query, results, maxResults);
+}
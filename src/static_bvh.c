@@ -0,0 +1,363 @@
+#include "static_bvh.h"
+#include "mem.h"
+#include <math.h>
+#include <string.h>
+
+// Below this depth nodes split at the centroid midpoint of their widest
+// axis; deeper nodes split by count, which bounds the tree depth and so
+// the traversal stacks
+#define STATIC_BVH_SPLIT_DEPTH 32
+#define STATIC_BVH_MAX_DEPTH 64
+
+#define STATIC_BVH_ALL_PLANES ((1u << FRUSTUM_PLANE_COUNT) - 1)
+
+// Plain compares: fminf/fmaxf are out-of-line libm calls without -ffast-math
+#define STATIC_BVH_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define STATIC_BVH_MAX(a, b) ((a) > (b) ? (a) : (b))
+
+static unsigned int StaticBVH_StaticMask(void) {
+    return COMPONENT_BIT(COMPONENT_TRANSFORM) | COMPONENT_BIT(COMPONENT_RENDERABLE) | COMPONENT_BIT(COMPONENT_STATIC);
+}
+
+void StaticBVH_Init(StaticBVH* bvh) {
+    memset(bvh, 0, sizeof(StaticBVH));
+}
+
+void StaticBVH_Release(StaticBVH* bvh) {
+    Mem_Free(MEM_SUBSYSTEM_SPATIAL, bvh->nodes, sizeof(StaticBVHNode) * (size_t)bvh->nodeCapacity);
+    Mem_Free(MEM_SUBSYSTEM_SPATIAL, bvh->items, sizeof(StaticBVHItem) * (size_t)bvh->itemCapacity);
+    memset(bvh, 0, sizeof(StaticBVH));
+}
+
+void StaticBVH_Invalidate(StaticBVH* bvh) {
+    bvh->valid = false;
+}
+
+static bool StaticBVH_Reserve(StaticBVH* bvh, int itemCount) {
+    if (itemCount > bvh->itemCapacity) {
+        StaticBVHItem* items = (StaticBVHItem*)Mem_Realloc(MEM_SUBSYSTEM_SPATIAL, bvh->items,
+                                                           sizeof(StaticBVHItem) * (size_t)bvh->itemCapacity,
+                                                           sizeof(StaticBVHItem) * (size_t)itemCount);
+        if (!items) return false;
+        bvh->items = items;
+        bvh->itemCapacity = itemCount;
+    }
+
+    // A binary tree with at least one item per leaf has fewer than 2n nodes
+    int nodeCount = itemCount * 2;
+    if (nodeCount > bvh->nodeCapacity) {
+        StaticBVHNode* nodes = (StaticBVHNode*)Mem_Realloc(MEM_SUBSYSTEM_SPATIAL, bvh->nodes,
+                                                           sizeof(StaticBVHNode) * (size_t)bvh->nodeCapacity,
+                                                           sizeof(StaticBVHNode) * (size_t)nodeCount);
+        if (!nodes) return false;
+        bvh->nodes = nodes;
+        bvh->nodeCapacity = nodeCount;
+    }
+    return true;
+}
+
+static float StaticBVH_Axis(Vector3 v, int axis) {
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+// Twice the centroid, which orders items the same way without the multiply
+static float StaticBVH_Centroid(const StaticBVHItem* item, int axis) {
+    return StaticBVH_Axis(item->min, axis) + StaticBVH_Axis(item->max, axis);
+}
+
+static void StaticBVH_FitNode(StaticBVH* bvh, StaticBVHNode* node) {
+    const StaticBVHItem* item = &bvh->items[node->first];
+    node->min = item->min;
+    node->max = item->max;
+    for (int i = 1; i < node->count; i++) {
+        item = &bvh->items[node->first + i];
+        node->min.x = STATIC_BVH_MIN(node->min.x, item->min.x);
+        node->min.y = STATIC_BVH_MIN(node->min.y, item->min.y);
+        node->min.z = STATIC_BVH_MIN(node->min.z, item->min.z);
+        node->max.x = STATIC_BVH_MAX(node->max.x, item->max.x);
+        node->max.y = STATIC_BVH_MAX(node->max.y, item->max.y);
+        node->max.z = STATIC_BVH_MAX(node->max.z, item->max.z);
+    }
+}
+
+// Item index where the node's range is cut in two
+static int StaticBVH_Partition(StaticBVH* bvh, const StaticBVHNode* node, int depth) {
+    int first = node->first;
+    int end = node->first + node->count;
+    int half = first + node->count / 2;
+    if (depth >= STATIC_BVH_SPLIT_DEPTH) {
+        return half;
+    }
+
+    // Centroid bounds pick the axis; extents of the item boxes do not matter
+    Vector3 lo = {INFINITY, INFINITY, INFINITY};
+    Vector3 hi = {-INFINITY, -INFINITY, -INFINITY};
+    for (int i = first; i < end; i++) {
+        const StaticBVHItem* item = &bvh->items[i];
+        Vector3 c = {item->min.x + item->max.x, item->min.y + item->max.y, item->min.z + item->max.z};
+        lo.x = STATIC_BVH_MIN(lo.x, c.x); lo.y = STATIC_BVH_MIN(lo.y, c.y); lo.z = STATIC_BVH_MIN(lo.z, c.z);
+        hi.x = STATIC_BVH_MAX(hi.x, c.x); hi.y = STATIC_BVH_MAX(hi.y, c.y); hi.z = STATIC_BVH_MAX(hi.z, c.z);
+    }
+
+    Vector3 extent = {hi.x - lo.x, hi.y - lo.y, hi.z - lo.z};
+    int axis = 0;
+    if (extent.y > extent.x) axis = 1;
+    if (extent.z > StaticBVH_Axis(extent, axis)) axis = 2;
+    if (StaticBVH_Axis(extent, axis) <= 0.0f) {
+        return half;
+    }
+
+    float split = (StaticBVH_Axis(lo, axis) + StaticBVH_Axis(hi, axis)) * 0.5f;
+    int i = first;
+    int j = end - 1;
+    while (i <= j) {
+        if (StaticBVH_Centroid(&bvh->items[i], axis) < split) {
+            i++;
+        } else {
+            StaticBVHItem tmp = bvh->items[i];
+            bvh->items[i] = bvh->items[j];
+            bvh->items[j--] = tmp;
+        }
+    }
+
+    // Everything landed on one side: fall back to an even split
+    return (i == first || i == end) ? half : i;
+}
+
+static void StaticBVH_Build(StaticBVH* bvh) {
+    int stack[STATIC_BVH_MAX_DEPTH];
+    int depths[STATIC_BVH_MAX_DEPTH];
+    int top = 0;
+
+    bvh->nodeCount = 0;
+    if (bvh->itemCount == 0) {
+        return;
+    }
+
+    StaticBVHNode* root = &bvh->nodes[bvh->nodeCount++];
+    root->left = -1;
+    root->first = 0;
+    root->count = bvh->itemCount;
+    stack[top] = 0;
+    depths[top++] = 0;
+
+    // Depth-first, so the stack holds at most one pending sibling per level
+    while (top > 0) {
+        top--;
+        int index = stack[top];
+        int depth = depths[top];
+        StaticBVHNode* node = &bvh->nodes[index];
+        StaticBVH_FitNode(bvh, node);
+
+        if (node->count <= STATIC_BVH_LEAF_SIZE || depth + 1 >= STATIC_BVH_MAX_DEPTH) {
+            continue;
+        }
+
+        int mid = StaticBVH_Partition(bvh, node, depth);
+        int left = bvh->nodeCount;
+        bvh->nodeCount += 2;
+        node->left = left;
+
+        StaticBVHNode* children = &bvh->nodes[left];
+        children[0].left = -1;
+        children[0].first = node->first;
+        children[0].count = mid - node->first;
+        children[1].left = -1;
+        children[1].first = mid;
+        children[1].count = node->first + node->count - mid;
+
+        stack[top] = left + 1;
+        depths[top++] = depth + 1;
+        stack[top] = left;
+        depths[top++] = depth + 1;
+    }
+}
+
+bool StaticBVH_Sync(StaticBVH* bvh, ECSWorld* world) {
+    ECSQuery* query = ECS_GetQuery(world, StaticBVH_StaticMask());
+    if (!query || (bvh->valid && bvh->version == query->version)) {
+        return false;
+    }
+
+    int count = 0;
+    ECSQueryIter iter = ECS_QueryIter(world, query);
+    while (ECS_QueryNext(&iter)) count++;
+
+    // Bounds come from the world matrices; bring any pending edits in first
+    System_UpdateTransforms(world);
+
+    bvh->valid = false;
+    bvh->itemCount = 0;
+    bvh->nodeCount = 0;
+    if (!StaticBVH_Reserve(bvh, count)) {
+        // Without a tree System_Render falls back to testing static entities one by one
+        return false;
+    }
+
+    iter = ECS_QueryIter(world, query);
+    while (ECS_QueryNext(&iter)) {
+        Vector3 center;
+        Vector3 halfExtents;
+        System_RenderBounds((const TransformComponent*)iter.components[COMPONENT_TRANSFORM],
+                            (const RenderableComponent*)iter.components[COMPONENT_RENDERABLE],
+                            &center, &halfExtents);
+
+        StaticBVHItem* item = &bvh->items[bvh->itemCount++];
+        item->id = iter.entity;
+        item->min = (Vector3){center.x - halfExtents.x, center.y - halfExtents.y, center.z - halfExtents.z};
+        item->max = (Vector3){center.x + halfExtents.x, center.y + halfExtents.y, center.z + halfExtents.z};
+    }
+
+    StaticBVH_Build(bvh);
+    bvh->version = query->version;
+    bvh->valid = true;
+    return true;
+}
+
+// Clears the bits of planes the box is fully inside; false if it is fully
+// outside any plane still in the mask
+static bool StaticBVH_ClipBox(const Frustum* frustum, Vector3 min, Vector3 max, unsigned int* planeMask) {
+    Vector3 center = {(min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f};
+    Vector3 half = {(max.x - min.x) * 0.5f, (max.y - min.y) * 0.5f, (max.z - min.z) * 0.5f};
+
+    for (int i = 0; i < FRUSTUM_PLANE_COUNT; i++) {
+        if (!(*planeMask & (1u << i))) continue;
+
+        const Vector4* plane = &frustum->planes[i];
+        float reach = fabsf(plane->x) * half.x + fabsf(plane->y) * half.y + fabsf(plane->z) * half.z;
+        float distance = plane->x * center.x + plane->y * center.y + plane->z * center.z + plane->w;
+        if (distance + reach < 0.0f) {
+            return false;
+        }
+        if (distance - reach >= 0.0f) {
+            *planeMask &= ~(1u << i);
+        }
+    }
+    return true;
+}
+
+int StaticBVH_QueryFrustum(const StaticBVH* bvh, const Frustum* frustum, EntityID* results, int maxResults) {
+    int found = 0;
+    if (bvh->nodeCount == 0) {
+        return 0;
+    }
+
+    int stack[STATIC_BVH_MAX_DEPTH];
+    unsigned int masks[STATIC_BVH_MAX_DEPTH];
+    int top = 0;
+    stack[top] = 0;
+    masks[top++] = frustum ? STATIC_BVH_ALL_PLANES : 0;
+
+    while (top > 0) {
+        top--;
+        const StaticBVHNode* node = &bvh->nodes[stack[top]];
+        unsigned int planeMask = masks[top];
+
+        if (planeMask && !StaticBVH_ClipBox(frustum, node->min, node->max, &planeMask)) {
+            continue;
+        }
+
+        if (planeMask == 0 || node->left < 0) {
+            // Fully inside takes the whole range; partial leaves test each item
+            for (int i = node->first; i < node->first + node->count; i++) {
+                const StaticBVHItem* item = &bvh->items[i];
+                unsigned int itemMask = planeMask;
+                if (itemMask && !StaticBVH_ClipBox(frustum, item->min, item->max, &itemMask)) {
+                    continue;
+                }
+                if (found < maxResults) results[found] = item->id;
+                found++;
+            }
+            continue;
+        }
+
+        stack[top] = node->left + 1;
+        masks[top++] = planeMask;
+        stack[top] = node->left;
+        masks[top++] = planeMask;
+    }
+
+    return found;
+}
+
+// Slab test: entry distance of the ray into the box, if it hits within maxT
+static bool StaticBVH_RayBox(Vector3 origin, Vector3 invDir, Vector3 min, Vector3 max, float maxT, float* entry) {
+    float t1 = (min.x - origin.x) * invDir.x;
+    float t2 = (max.x - origin.x) * invDir.x;
+    float tmin = STATIC_BVH_MIN(t1, t2);
+    float tmax = STATIC_BVH_MAX(t1, t2);
+
+    t1 = (min.y - origin.y) * invDir.y;
+    t2 = (max.y - origin.y) * invDir.y;
+    tmin = STATIC_BVH_MAX(tmin, STATIC_BVH_MIN(t1, t2));
+    tmax = STATIC_BVH_MIN(tmax, STATIC_BVH_MAX(t1, t2));
+
+    t1 = (min.z - origin.z) * invDir.z;
+    t2 = (max.z - origin.z) * invDir.z;
+    tmin = STATIC_BVH_MAX(tmin, STATIC_BVH_MIN(t1, t2));
+    tmax = STATIC_BVH_MIN(tmax, STATIC_BVH_MAX(t1, t2));
+
+    tmin = STATIC_BVH_MAX(tmin, 0.0f);
+    if (tmax < tmin || tmin > maxT) {
+        return false;
+    }
+    *entry = tmin;
+    return true;
+}
+
+bool StaticBVH_Raycast(const StaticBVH* bvh, Ray ray, float maxDistance, EntityID* hitEntity, float* hitDistance) {
+    if (bvh->nodeCount == 0) {
+        return false;
+    }
+
+    Vector3 origin = ray.position;
+    Vector3 invDir = {1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z};
+    float best = maxDistance;
+    EntityID bestId = ECS_INVALID_ENTITY;
+
+    int stack[STATIC_BVH_MAX_DEPTH];
+    int top = 0;
+    float entry;
+    if (!StaticBVH_RayBox(origin, invDir, bvh->nodes[0].min, bvh->nodes[0].max, best, &entry)) {
+        return false;
+    }
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const StaticBVHNode* node = &bvh->nodes[stack[--top]];
+
+        if (node->left < 0) {
+            for (int i = node->first; i < node->first + node->count; i++) {
+                const StaticBVHItem* item = &bvh->items[i];
+                if (StaticBVH_RayBox(origin, invDir, item->min, item->max, best, &entry) &&
+                    (bestId == ECS_INVALID_ENTITY || entry < best)) {
+                    best = entry;
+                    bestId = item->id;
+                }
+            }
+            continue;
+        }
+
+        // Visit the nearer child first so later boxes can be rejected against best
+        float nearEntry;
+        float farEntry;
+        int nearChild = node->left;
+        int farChild = node->left + 1;
+        bool nearHit = StaticBVH_RayBox(origin, invDir, bvh->nodes[nearChild].min, bvh->nodes[nearChild].max, best, &nearEntry);
+        bool farHit = StaticBVH_RayBox(origin, invDir, bvh->nodes[farChild].min, bvh->nodes[farChild].max, best, &farEntry);
+        if (nearHit && farHit && farEntry < nearEntry) {
+            int swap = nearChild;
+            nearChild = farChild;
+            farChild = swap;
+        }
+        if (farHit) stack[top++] = farChild;
+        if (nearHit) stack[top++] = nearChild;
+    }
+
+    if (bestId == ECS_INVALID_ENTITY) {
+        return false;
+    }
+    if (hitEntity) *hitEntity = bestId;
+    if (hitDistance) *hitDistance = best;
+    return true;
+}
@@ -0,0 +1,140 @@
+#include "stress_scene.h"
+#include <math.h>
+
+typedef struct {
+    unsigned int state;
+} StressRng;
+
+static unsigned int StressRng_Next(StressRng* rng) {
+    rng->state = rng->state * 1664525u + 1013904223u;
+    return rng->state >> 8;
+}
+
+// Uniform in [0, 1)
+static float StressRng_Float(StressRng* rng) {
+    return (float)StressRng_Next(rng) / (float)(1u << 24);
+}
+
+static RenderableType StressScene_PickType(StressRng* rng, const StressSceneConfig* config, float totalWeight) {
+    float pick = StressRng_Float(rng) * totalWeight;
+    for (int i = 0; i < STRESS_SCENE_TYPE_COUNT; i++) {
+        pick -= config->typeWeights[i];
+        if (pick < 0.0f) {
+            return (RenderableType)i;
+        }
+    }
+    return RENDERABLE_CUBE;
+}
+
+static Color StressScene_PickColor(StressRng* rng, const StressSceneConfig* config) {
+    if (config->palette && config->paletteCount > 0) {
+        return config->palette[StressRng_Next(rng) % (unsigned int)config->paletteCount];
+    }
+    unsigned int bits = StressRng_Next(rng);
+    return (Color){(unsigned char)(bits & 0xFF), (unsigned char)((bits >> 8) & 0xFF),
+                   (unsigned char)((bits >> 16) & 0xFF), 255};
+}
+
+void StressScene_DefaultConfig(StressSceneConfig* config) {
+    // raylib's RED, ORANGE, GOLD, LIME, SKYBLUE, BLUE, PURPLE and BEIGE
+    static const Color palette[] = {
+        {230, 41, 55, 255}, {255, 161, 0, 255}, {255, 203, 0, 255}, {0, 158, 47, 255},
+        {102, 191, 255, 255}, {0, 121, 241, 255}, {200, 122, 255, 255}, {211, 176, 131, 255}
+    };
+
+    config->entityCount = 1000;
+    config->seed = 1u;
+    config->typeWeights[RENDERABLE_CUBE] = 6.0f;
+    config->typeWeights[RENDERABLE_SPHERE] = 3.0f;
+    config->typeWeights[RENDERABLE_PLANE] = 1.0f;
+    config->typeWeights[RENDERABLE_GRID] = 0.0f;
+    config->staticRatio = 0.25f;
+    config->minSize = 0.5f;
+    config->maxSize = 2.0f;
+    config->spacing = 3.0f;
+    config->palette = palette;
+    config->paletteCount = (int)(sizeof(palette) / sizeof(palette[0]));
+    config->spinSpeed = 1.0f;
+}
+
+EntityID StressScene_Create(ECSWorld* world, const StressSceneConfig* config) {
+    StressRng rng = {config->seed};
+    float totalWeight = 0.0f;
+    for (int i = 0; i < STRESS_SCENE_TYPE_COUNT; i++) {
+        totalWeight += config->typeWeights[i];
+    }
+
+    // Square grid centred on the origin, one entity per cell
+    int side = (int)ceilf(sqrtf((float)config->entityCount));
+    float half = 0.5f * (float)(side - 1) * config->spacing;
+
+    // Above one corner, looking across the field
+    EntityID cameraEntity = ECS_CreateEntity(world);
+    CameraComponent* camera = (CameraComponent*)ECS_AddComponent(world, cameraEntity, COMPONENT_CAMERA);
+    ECS_AddComponent(world, cameraEntity, COMPONENT_INPUT);
+    if (camera) {
+        float height = fmaxf(10.0f, half * 0.5f);
+        camera->camera.position = (Vector3){half + 10.0f, height, half + 10.0f};
+        camera->camera.target = (Vector3){0.0f, 0.0f, 0.0f};
+    }
+
+    for (int i = 0; i < config->entityCount; i++) {
+        EntityID id = ECS_CreateEntity(world);
+        if (id == ECS_INVALID_ENTITY) {
+            break;
+        }
+        TransformComponent* transform = (TransformComponent*)ECS_AddComponent(world, id, COMPONENT_TRANSFORM);
+        RenderableComponent* renderable = (RenderableComponent*)ECS_AddComponent(world, id, COMPONENT_RENDERABLE);
+        if (!transform || !renderable) {
+            ECS_DestroyEntity(world, id);
+            break;
+        }
+
+        RenderableType type = totalWeight > 0.0f ? StressScene_PickType(&rng, config, totalWeight) : RENDERABLE_CUBE;
+        float size = config->minSize + (config->maxSize - config->minSize) * StressRng_Float(&rng);
+        float jitterX = (StressRng_Float(&rng) - 0.5f) * 0.5f * config->spacing;
+        float jitterZ = (StressRng_Float(&rng) - 0.5f) * 0.5f * config->spacing;
+
+        renderable->type = type;
+        renderable->color = StressScene_PickColor(&rng, config);
+        if (type == RENDERABLE_PLANE || type == RENDERABLE_GRID) {
+            // Flat tiles on the ground, a cell wide
+            renderable->size = (Vector3){config->spacing, 1.0f, config->spacing};
+            transform->position.y = 0.0f;
+        } else {
+            renderable->size = (Vector3){size, size, size};
+            transform->position.y = 0.5f * size;
+        }
+        transform->position.x = (float)(i % side) * config->spacing - half + jitterX;
+        transform->position.z = (float)(i / side) * config->spacing - half + jitterZ;
+        transform->rotation.y = StressRng_Float(&rng) * 2.0f * PI;
+
+        if (StressRng_Float(&rng) < config->staticRatio) {
+            ECS_AddComponent(world, id, COMPONENT_STATIC);
+        }
+    }
+
+    return cameraEntity;
+}
+
+// Renderables that are not static
+static ECSQuery* StressScene_AnimateQuery(ECSWorld* world) {
+    unsigned int required = COMPONENT_BIT(COMPONENT_TRANSFORM) | COMPONENT_BIT(COMPONENT_RENDERABLE);
+    return ECS_GetQueryExcluding(world, required, COMPONENT_BIT(COMPONENT_STATIC));
+}
+
+void StressScene_PrepareAnimate(ECSWorld* world) {
+    StressScene_AnimateQuery(world);
+}
+
+void StressScene_Animate(ECSWorld* world, float deltaTime, void* user) {
+    const StressSceneConfig* config = (const StressSceneConfig*)user;
+    float turn = config->spinSpeed * deltaTime;
+
+    ECSQueryIter iter = ECS_QueryIter(world, StressScene_AnimateQuery(world));
+    while (ECS_QueryNext(&iter)) {
+        TransformComponent* transform = (TransformComponent*)iter.components[COMPONENT_TRANSFORM];
+        transform->rotation.y = fmodf(transform->rotation.y + turn, 2.0f * PI);
+        ECS_MarkTransformDirty(world, iter.entity);
+    }
+}
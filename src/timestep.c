@@ -0,0 +1,35 @@
+#include "timestep.h"
+
+void FixedTimestep_Init(FixedTimestep* timestep, float tickRate, int maxSteps) {
+    if (tickRate <= 0.0f) tickRate = TIMESTEP_DEFAULT_RATE;
+    if (maxSteps < 1) maxSteps = 1;
+    timestep->step = 1.0f / tickRate;
+    timestep->maxSteps = maxSteps;
+    timestep->accumulator = 0.0f;
+    timestep->droppedSteps = 0;
+}
+
+int FixedTimestep_Advance(FixedTimestep* timestep, float frameTime) {
+    if (frameTime > 0.0f) {
+        timestep->accumulator += frameTime;
+    }
+
+    // Whole ticks are paid out; only the partial one carries over, so ticks
+    // beyond maxSteps are dropped rather than owed to later frames
+    int steps = (int)(timestep->accumulator / timestep->step);
+    timestep->accumulator -= (float)steps * timestep->step;
+    if (timestep->accumulator < 0.0f) {
+        timestep->accumulator = 0.0f;
+    }
+    if (steps > timestep->maxSteps) {
+        timestep->droppedSteps += (unsigned int)(steps - timestep->maxSteps);
+        steps = timestep->maxSteps;
+    }
+    return steps;
+}
+
+float FixedTimestep_GetAlpha(const FixedTimestep* timestep) {
+    // Rounding can leave the accumulator a hair over one step
+    float alpha = timestep->accumulator / timestep->step;
+    return alpha < 1.0f ? alpha : 0.999f;
+}